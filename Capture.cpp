@@ -0,0 +1,70 @@
+//  Capture of the exact bytes sent to and received from the module, with timestamps.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+#if SIGFOX_CAPTURE
+static Print *capturePort = 0;  //  Port for printing the capture, or 0 if not capturing.
+static unsigned long lastTime = 0;  //  millis() of the previous line.
+static unsigned long lineTime = 0;  //  millis() of the first byte held.
+static uint8_t lineType = 0;  //  CaptureType of the bytes held.
+static uint8_t line[CAPTURE_LINE_BYTES];  //  Bytes held until the line is full or the type changes.
+static uint8_t lineLength = 0;
+
+static void printLine(uint8_t type, unsigned long time) {
+  //  Print "@@", the type, the delta time and the bytes held.
+  static const char hexDigits[] = "0123456789ABCDEF";
+  capturePort->print(F("@@"));
+  capturePort->write(type);
+  capturePort->print(time - lastTime, HEX);
+  lastTime = time;
+  if (lineLength > 0) capturePort->write(' ');
+  for (uint8_t i = 0; i < lineLength; i++) {
+    capturePort->write(hexDigits[line[i] >> 4]);
+    capturePort->write(hexDigits[line[i] & 0x0f]);
+  }
+  capturePort->println();
+  lineLength = 0;
+}
+
+void captureStart(Print &port) {
+  capturePort = &port;
+  lastTime = millis();
+  lineLength = 0;
+  //  The first line has the absolute time, so the replay knows how long after startup it began.
+  capturePort->print(F("@@"));
+  capturePort->write(CAPTURE_START);
+  capturePort->println(lastTime, HEX);
+}
+
+void captureStop() {
+  if (!capturePort) return;
+  captureFlush();
+  capturePort = 0;
+}
+
+void captureExchange() {
+  if (!capturePort) return;
+  captureFlush();
+  printLine(CAPTURE_EXCHANGE, millis());
+}
+
+void captureByte(uint8_t type, uint8_t c) {
+  //  Hold the byte, printing the bytes held first if the line is full or of another type.
+  if (!capturePort) return;
+  if (lineLength > 0 && (lineType != type || lineLength >= CAPTURE_LINE_BYTES)) printLine(lineType, lineTime);
+  if (lineLength == 0) { lineType = type; lineTime = millis(); }
+  line[lineLength++] = c;
+}
+
+void captureFlush() {
+  if (!capturePort || lineLength == 0) return;
+  printLine(lineType, lineTime);
+}
+#endif  //  SIGFOX_CAPTURE
@@ -0,0 +1,48 @@
+//  Capture of the exact bytes sent to and received from the module, with timestamps, for
+//  replaying field traffic on the host.  Convert and replay the capture with the tools in
+//  extras/replay.
+#ifndef UNABIZ_ARDUINO_CAPTURE_H
+#define UNABIZ_ARDUINO_CAPTURE_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  Capture costs a few hundred bytes of Flash and 20 bytes of RAM.  Define as 1 with a compiler
+//  flag like -DSIGFOX_CAPTURE=1 to include it.
+#ifndef SIGFOX_CAPTURE
+#define SIGFOX_CAPTURE 0
+#endif  //  SIGFOX_CAPTURE
+
+//  Kinds of capture lines.
+enum CaptureType {
+  CAPTURE_START = '!',  //  Start of the capture.  The time is millis(), not a delta.
+  CAPTURE_EXCHANGE = '|',  //  Start of a command sent by the transceiver, no bytes.
+  CAPTURE_SENT = '>',  //  Bytes sent to the module.
+  CAPTURE_RECEIVED = '<',  //  Bytes received from the module.
+};
+
+const uint8_t CAPTURE_LINE_BYTES = 8;  //  Most bytes in one capture line.
+
+//  Lines look like "@@>1F4 41540D": the type, the ms since the previous line in hex, then the
+//  bytes in hex.  They can be mixed with other output on the port, e.g. copied from the Serial
+//  Monitor.  Capture slows down the transceiver by the time taken to print, so use a fast port.
+#if SIGFOX_CAPTURE
+void captureStart(Print &port);  //  Start capturing to the port.
+void captureStop();  //  Print what's left and stop capturing.
+void captureExchange();  //  Called by the transceiver before sending a command.
+void captureByte(uint8_t type, uint8_t c);  //  Called by the transceiver for every byte sent or received.
+void captureFlush();  //  Called by the transceiver after a command.  Prints the bytes held.
+#else  //  SIGFOX_CAPTURE
+inline void captureStart(Print &port) {}
+inline void captureStop() {}
+inline void captureExchange() {}
+inline void captureByte(uint8_t type, uint8_t c) {}
+inline void captureFlush() {}
+#endif  //  SIGFOX_CAPTURE
+
+#endif // UNABIZ_ARDUINO_CAPTURE_H
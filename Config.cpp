@@ -0,0 +1,155 @@
+//  Runtime configuration stored in EEPROM and updated by SIGFOX downlink.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include <stddef.h>
+#include "SIGFOX.h"
+
+#ifdef __AVR__
+#include <EEPROM.h>
+#endif  //  __AVR__
+
+static uint8_t crc8(const uint8_t *buffer, uint8_t length) {
+  //  CRC-8 with polynomial 0x07, as used by SMBus.
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    crc ^= buffer[i];
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
+
+Config::Config(Radiocrafts &transceiver, const int16_t defaults0[CONFIG_PARAMS], uint8_t downlinkEvery,
+               const int16_t minimums0[CONFIG_PARAMS], const int16_t maximums0[CONFIG_PARAMS]) {
+  //  Config for Radiocrafts.
+  radiocrafts = &transceiver;
+  init(defaults0, downlinkEvery, minimums0, maximums0);
+}
+
+Config::Config(Wisol &transceiver, const int16_t defaults0[CONFIG_PARAMS], uint8_t downlinkEvery,
+               const int16_t minimums0[CONFIG_PARAMS], const int16_t maximums0[CONFIG_PARAMS]) {
+  //  Config for Wisol.
+  wisol = &transceiver;
+  init(defaults0, downlinkEvery, minimums0, maximums0);
+}
+
+void Config::init(const int16_t defaults0[CONFIG_PARAMS], uint8_t downlinkEvery,
+                  const int16_t minimums0[CONFIG_PARAMS], const int16_t maximums0[CONFIG_PARAMS]) {
+  defaults = defaults0;
+  minimums = minimums0;
+  maximums = maximums0;
+  defaultDownlinkEvery = downlinkEvery;
+  uplinkCount = 0;
+  useDefaults();
+}
+
+void Config::useDefaults() {
+  //  Use the defaults from the sketch.  Version 0 means never configured by downlink.
+  block.version = 0;
+  block.downlinkEvery = defaultDownlinkEvery;
+  for (uint8_t i = 0; i < CONFIG_PARAMS; i++) block.params[i] = defaults[i];
+  block.crc = crc8((const uint8_t *) &block, offsetof(ConfigBlock, crc));
+}
+
+void Config::begin() {
+  //  Load the config from EEPROM, or use the defaults if missing or corrupted, or outside
+  //  limits that the sketch has narrowed since it was saved.
+#ifdef __AVR__
+  ConfigBlock stored;
+  EEPROM.get(CONFIG_EEPROM_ADDRESS, stored);
+  if (stored.version != 0 && stored.crc == crc8((const uint8_t *) &stored, offsetof(ConfigBlock, crc)) &&
+      isValid(stored)) {
+    block = stored;
+    return;
+  }
+#endif  //  __AVR__
+  useDefaults();
+}
+
+int16_t Config::get(uint8_t index) {
+  //  Return the parameter.  Reads from RAM, not EEPROM.
+  if (index >= CONFIG_PARAMS) return 0;
+  return block.params[index];
+}
+
+uint8_t Config::getVersion() {
+  //  Return the config version, 0 for the defaults.
+  return block.version;
+}
+
+bool Config::sendMessage(const String &payload) {
+  //  Send the payload.  Request a downlink only every downlinkEvery uplinks,
+  //  since waiting for the downlink costs airtime and battery.
+  const bool wantDownlink = block.downlinkEvery > 0 &&
+    uplinkCount + 1 >= block.downlinkEvery;
+  if (!wantDownlink || !wisol) {
+    //  Radiocrafts driver doesn't support downlinks yet.
+    bool status = false;
+    if (wisol) status = wisol->sendMessage(payload);
+    else if (radiocrafts) status = radiocrafts->sendMessage(payload);
+    if (status) uplinkCount++;
+    return status;
+  }
+  String response;
+  if (!wisol->sendMessageAndGetResponse(payload, response)) return false;
+  uplinkCount = 0;
+  apply(response);
+  return true;
+}
+
+bool Config::apply(const String &downlink) {
+  //  Apply a downlink of 16 hex digits: version, downlinkEvery, then each param
+  //  as int16 little-endian.  Return true if the config changed.
+  if (downlink.length() != 16) return false;
+  uint8_t bytes[8];
+  for (uint8_t i = 0; i < 8; i++) {
+    const uint8_t hi = hexDigitValue(downlink.charAt(i * 2));
+    const uint8_t lo = hexDigitValue(downlink.charAt(i * 2 + 1));
+    if (hi == HEX_DIGIT_INVALID || lo == HEX_DIGIT_INVALID) return false;
+    bytes[i] = (hi << 4) | lo;
+  }
+  //  Version 0 is reserved for the defaults.  Same version means already applied.
+  if (bytes[0] == 0 || bytes[0] == block.version) return false;
+  ConfigBlock received;
+  received.version = bytes[0];
+  received.downlinkEvery = bytes[1];
+  for (uint8_t i = 0; i < CONFIG_PARAMS; i++)
+    received.params[i] = (int16_t) (bytes[2 + i * 2] | (bytes[3 + i * 2] << 8));
+  //  Keep the current config if it would stop the downlinks or any param is out of range.
+  if (!isValid(received)) return false;
+  block = received;
+  save();
+  return true;
+}
+
+bool Config::isValid(const ConfigBlock &config) {
+  //  Return true if downlinks stay on and each param is within the limits from the sketch.
+  //  downlinkEvery 0 would stop the downlinks that could turn them back on, and would
+  //  stay in EEPROM across reflashing.
+  if (config.downlinkEvery == 0) return false;
+  for (uint8_t i = 0; i < CONFIG_PARAMS; i++) {
+    if (minimums && config.params[i] < minimums[i]) return false;
+    if (maximums && config.params[i] > maximums[i]) return false;
+  }
+  return true;
+}
+
+void Config::reset() {
+  //  Go back to the defaults and erase the stored config.
+  useDefaults();
+  save();
+}
+
+void Config::save() {
+  //  Save the config to EEPROM with its CRC.  Only changed bytes are written.
+  block.crc = crc8((const uint8_t *) &block, offsetof(ConfigBlock, crc));
+#ifdef __AVR__
+  EEPROM.put(CONFIG_EEPROM_ADDRESS, block);
+#endif  //  __AVR__
+}
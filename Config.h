@@ -0,0 +1,60 @@
+//  Runtime configuration stored in EEPROM and updated by SIGFOX downlink, so that
+//  settings like the send interval can be changed without reflashing.
+#ifndef UNABIZ_ARDUINO_CONFIG_H
+#define UNABIZ_ARDUINO_CONFIG_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+const int CONFIG_EEPROM_ADDRESS = 16;  //  EEPROM address of the config block, after the Supervisor counters.
+const uint8_t CONFIG_PARAMS = 3;  //  Number of parameters, meaning defined by the sketch.
+
+//  Config block as stored in EEPROM.  The downlink carries the same fields except crc,
+//  as 8 bytes: version, downlinkEvery, then each param as int16 little-endian.
+struct ConfigBlock {
+  uint8_t version;  //  Config version.  Downlinks with the same version are ignored.
+  uint8_t downlinkEvery;  //  Request a downlink every this many uplinks.  0 for never, only as a default.
+  int16_t params[CONFIG_PARAMS];  //  Parameters, e.g. send interval and thresholds.
+  uint8_t crc;  //  CRC-8 of the fields above.
+};
+
+class Config
+{
+public:
+  //  Config for Radiocrafts or Wisol.  Downlinks with a param outside minimums..maximums are
+  //  rejected, so that a bad downlink can't e.g. set a send interval of 0 or 49 days, and so
+  //  are downlinks with downlinkEvery 0, which would lock out remote config.
+  //  Without limits, any int16 value is accepted.
+  Config(Radiocrafts &transceiver, const int16_t defaults[CONFIG_PARAMS], uint8_t downlinkEvery,
+         const int16_t minimums[CONFIG_PARAMS] = 0, const int16_t maximums[CONFIG_PARAMS] = 0);
+  Config(Wisol &transceiver, const int16_t defaults[CONFIG_PARAMS], uint8_t downlinkEvery,
+         const int16_t minimums[CONFIG_PARAMS] = 0, const int16_t maximums[CONFIG_PARAMS] = 0);
+  void begin();  //  Load the config from EEPROM, or use the defaults if missing or corrupted.
+  int16_t get(uint8_t index);  //  Return the parameter.  Reads from RAM, not EEPROM.
+  uint8_t getVersion();  //  Return the config version, 0 for the defaults.
+  bool sendMessage(const String &payload);  //  Send the payload, requesting a downlink every downlinkEvery uplinks.
+  bool apply(const String &downlink);  //  Apply a downlink of 16 hex digits.  Return true if the config changed.
+  bool isValid(const ConfigBlock &config);  //  Return true if downlinkEvery > 0 and each param is within the limits.
+  void reset();  //  Go back to the defaults and erase the stored config.
+
+private:
+  void init(const int16_t defaults[CONFIG_PARAMS], uint8_t downlinkEvery,
+            const int16_t minimums[CONFIG_PARAMS], const int16_t maximums[CONFIG_PARAMS]);
+  void useDefaults();
+  void save();
+  ConfigBlock block;  //  Current config.
+  const int16_t *defaults;  //  Defaults from the sketch.
+  const int16_t *minimums;  //  Lowest value of each param, or 0 for no limit.
+  const int16_t *maximums;  //  Highest value of each param, or 0 for no limit.
+  uint8_t defaultDownlinkEvery;
+  unsigned int uplinkCount;  //  Number of uplinks sent since the last downlink.
+  Radiocrafts *radiocrafts = 0;  //  Reference to Radiocrafts transceiver for sending the messages.
+  Wisol *wisol = 0;  //  Reference to Wisol transceiver for sending the messages.
+};
+
+#endif // UNABIZ_ARDUINO_CONFIG_H
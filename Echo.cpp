@@ -0,0 +1,83 @@
+//  Buffered echo output, so that debug output doesn't stall the transceiver while the
+//  hardware serial port is busy.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+EchoBuffer::EchoBuffer(Print &port0, bool dropWhenFull0) {
+  //  Buffer the output to port0.
+  port = &port0;
+  dropWhenFull = dropWhenFull0;
+  portReportsRoom = false;
+  start = 0;
+  count = 0;
+  dropped = 0;
+}
+
+size_t EchoBuffer::write(uint8_t c) {
+  //  Add the byte to the buffer.  Hand the buffer to the port at the end of each line.
+  if (count >= SIGFOX_ECHO_BUFFER_SIZE) {
+    if (!dropWhenFull) flush();
+    else {
+      drain();
+      if (count >= SIGFOX_ECHO_BUFFER_SIZE) { dropped++; return 0; }
+    }
+  }
+  buffer[(start + count) % SIGFOX_ECHO_BUFFER_SIZE] = c;
+  count++;
+  if (c == '\n') drain();
+  return 1;
+}
+
+size_t EchoBuffer::write(const uint8_t *buf, size_t size) {
+  //  Add the bytes to the buffer.  Return the number of bytes not dropped.
+  size_t n = 0;
+  for (size_t i = 0; i < size; i++) n += write(buf[i]);
+  return n;
+}
+
+void EchoBuffer::drain() {
+  //  Send as much as the port can take without blocking.  If we are not dropping,
+  //  send everything even if the port doesn't say how much it can take.
+  int room = port->availableForWrite();
+  if (room > 0) portReportsRoom = true;
+  if (!dropWhenFull || room > count) room = count;
+  else if (!portReportsRoom) {
+    //  Print returns 0 for ports that can't tell, so send up to the end of the last
+    //  whole line, or everything if the buffer is full without one.
+    room = 0;
+    for (uint8_t i = count; i > 0; i--) {
+      if (buffer[(start + i - 1) % SIGFOX_ECHO_BUFFER_SIZE] == '\n') { room = i; break; }
+    }
+    if (room == 0 && count >= SIGFOX_ECHO_BUFFER_SIZE) room = count;
+  }
+  if (room > 0) send(room);
+}
+
+void EchoBuffer::flush() {
+  //  Send everything, waiting if the port is busy.
+  send(count);
+}
+
+void EchoBuffer::send(uint8_t n) {
+  //  Send n bytes from the start of the buffer, in at most two writes.
+  while (n > 0) {
+    uint8_t chunk = SIGFOX_ECHO_BUFFER_SIZE - start;
+    if (chunk > n) chunk = n;
+    port->write(buffer + start, chunk);
+    start = (start + chunk) % SIGFOX_ECHO_BUFFER_SIZE;
+    count -= chunk;
+    n -= chunk;
+  }
+}
+
+unsigned long EchoBuffer::getDropped() {
+  //  Return the number of bytes dropped because the buffer was full.
+  return dropped;
+}
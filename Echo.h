@@ -0,0 +1,52 @@
+//  Buffered echo output, so that debug output doesn't stall the transceiver while the
+//  hardware serial port is busy.
+#ifndef UNABIZ_ARDUINO_ECHO_H
+#define UNABIZ_ARDUINO_ECHO_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  Bytes of echo output held while the port is busy, up to 255.  Change with a compiler flag
+//  like -DSIGFOX_ECHO_BUFFER_SIZE=64.
+#ifndef SIGFOX_ECHO_BUFFER_SIZE
+#define SIGFOX_ECHO_BUFFER_SIZE 128
+#endif  //  SIGFOX_ECHO_BUFFER_SIZE
+
+//  Pass to setEchoPort() of the transceiver instead of Serial:
+//    static EchoBuffer echoBuffer(Serial);
+//    transceiver.setEchoPort(&echoBuffer);
+//  Output is kept in a ring buffer and handed to the port a whole line at a time, only as
+//  much as the port can take without blocking.  A hardware serial port then sends it by
+//  interrupt.  Call drain() in loop() to send anything left over.  Ports that never report
+//  availableForWrite(), like SoftwareSerial and the Bean's Serial, are handed whole lines
+//  and block while they send them.
+class EchoBuffer: public Print {
+public:
+  //  If dropWhenFull is true, output that doesn't fit in the buffer is dropped and counted.
+  //  Else the buffer is drained into the port, waiting if the port is busy.
+  EchoBuffer(Print &port, bool dropWhenFull = true);
+  virtual size_t write(uint8_t c);
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  using Print::write;
+  void drain();  //  Send as much as the port can take without blocking.
+  void flush();  //  Send everything, waiting if the port is busy.
+  unsigned long getDropped();  //  Return the number of bytes dropped because the buffer was full.
+
+private:
+  void send(uint8_t count);  //  Send count bytes from the start of the buffer.
+
+  Print *port;  //  Port for sending the echo output.
+  bool dropWhenFull;  //  Drop output instead of waiting for the port.
+  bool portReportsRoom;  //  The port has reported room with availableForWrite().
+  uint8_t buffer[SIGFOX_ECHO_BUFFER_SIZE];  //  Ring buffer of output not sent yet.
+  uint8_t start;  //  Position of the first byte not sent yet.
+  uint8_t count;  //  Number of bytes not sent yet.
+  unsigned long dropped;  //  Number of bytes dropped.
+};
+
+#endif // UNABIZ_ARDUINO_ECHO_H
@@ -0,0 +1,121 @@
+//  Heap and stack instrumentation for finding lockups caused by String fragmentation.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+#if defined(__AVR__)
+//  Maintained by avr-libc malloc().
+extern char __heap_start;
+extern char *__brkval;
+extern size_t __malloc_margin;
+struct __freelist {
+  size_t sz;
+  struct __freelist *nx;
+};
+extern struct __freelist *__flp;
+
+#if SIGFOX_MEMORY_DEBUG
+//  Fill the unused RAM with a pattern before main() runs, after the stack pointer is set up.
+//  The stack overwrites it as it grows, so the pattern left above the heap shows the
+//  deepest stack use so far.
+const uint8_t STACK_PAINT = 0xc5;
+extern uint8_t _end;
+extern uint8_t __stack;
+void paintStack() __attribute__ ((naked, used, section (".init3")));
+void paintStack() {
+  for (uint8_t *p = &_end; p <= &__stack; p++) *p = STACK_PAINT;
+}
+
+static uint16_t stackFree() {
+  //  Count the untouched pattern bytes from the top of the heap.
+  const uint8_t *p = (const uint8_t *) (__brkval ? __brkval : &__heap_start);
+  uint16_t count = 0;
+  while (p <= &__stack && *p == STACK_PAINT) { p++; count++; }
+  return count;
+}
+#else  //  SIGFOX_MEMORY_DEBUG
+static uint16_t stackFree() { return 0; }
+#endif  //  SIGFOX_MEMORY_DEBUG
+
+void getMemoryStats(MemoryStats &stats) {
+  //  Free memory is the gap between the heap and the stack, plus the free list.
+  //  malloc() keeps __malloc_margin bytes clear below the stack.
+  char top;
+  const char *heapEnd = __brkval ? __brkval : &__heap_start;
+  const uint16_t gap = &top > heapEnd ? &top - heapEnd : 0;
+  stats.heapFree = gap;
+  stats.largestBlock = gap > __malloc_margin ? gap - __malloc_margin : 0;
+  stats.freeBlocks = 0;
+  for (struct __freelist *fp = __flp; fp; fp = fp->nx) {
+    stats.heapFree += fp->sz + sizeof(size_t);
+    if (fp->sz > stats.largestBlock) stats.largestBlock = fp->sz;
+    stats.freeBlocks++;
+  }
+  stats.stackFree = stackFree();
+}
+
+#elif defined(SIGFOX_HOST_HEAP)
+//  Host build with the emulated AVR heap in extras/host.  The stack is not measured.
+#include "HostHeap.h"
+
+void getMemoryStats(MemoryStats &stats) {
+  HostHeapStats heap;
+  hostHeapStats(heap);
+  stats.heapFree = heap.free;
+  stats.largestBlock = heap.largest;
+  stats.freeBlocks = heap.freeBlocks;
+  stats.stackFree = 0;
+}
+
+#else  //  __AVR__
+void getMemoryStats(MemoryStats &stats) {
+  //  Not measured on this board.
+  memset(&stats, 0, sizeof(stats));
+}
+#endif  //  __AVR__
+
+static Print *memoryPort = 0;  //  Port for printing checkpoints, or 0.
+static MemoryStats lowest[MEMORY_CHECKPOINTS];
+static bool recorded[MEMORY_CHECKPOINTS];
+
+void memoryBegin(Print *port) {
+  //  Print a line at every checkpoint to this port.  0 to stop printing.
+  memoryPort = port;
+}
+
+void memoryCheckpoint(uint8_t point) {
+  //  Record the lowest stats seen at this checkpoint.  Don't use String here,
+  //  since that would change what we are measuring.
+  if (point >= MEMORY_CHECKPOINTS) return;
+  MemoryStats stats;
+  getMemoryStats(stats);
+  MemoryStats &low = lowest[point];
+  if (!recorded[point]) { low = stats; recorded[point] = true; }
+  if (stats.heapFree < low.heapFree) low.heapFree = stats.heapFree;
+  if (stats.largestBlock < low.largestBlock) low.largestBlock = stats.largestBlock;
+  if (stats.freeBlocks > low.freeBlocks) low.freeBlocks = stats.freeBlocks;
+  if (stats.stackFree < low.stackFree) low.stackFree = stats.stackFree;
+  if (!memoryPort) return;
+  memoryPort->print(F(" - memory "));
+  switch (point) {
+    case MEMORY_SEND_BUFFER: memoryPort->print(F("sendBuffer")); break;
+    case MEMORY_MESSAGE_SEND: memoryPort->print(F("send")); break;
+    case MEMORY_DECODE_MESSAGE: memoryPort->print(F("decodeMessage")); break;
+  }
+  memoryPort->print(F(": heap free=")); memoryPort->print(stats.heapFree);
+  memoryPort->print(F(" largest=")); memoryPort->print(stats.largestBlock);
+  memoryPort->print(F(" blocks=")); memoryPort->print(stats.freeBlocks);
+  memoryPort->print(F(" stack free=")); memoryPort->println(stats.stackFree);
+}
+
+void getMemoryLowest(uint8_t point, MemoryStats &stats) {
+  //  Return the lowest stats seen at the checkpoint, i.e. the most free blocks.
+  if (point >= MEMORY_CHECKPOINTS || !recorded[point]) { memset(&stats, 0, sizeof(stats)); return; }
+  stats = lowest[point];
+}
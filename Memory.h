@@ -0,0 +1,46 @@
+//  Heap and stack instrumentation for finding lockups caused by String fragmentation.
+#ifndef UNABIZ_ARDUINO_MEMORY_H
+#define UNABIZ_ARDUINO_MEMORY_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  Define as 1 with a compiler flag like -DSIGFOX_MEMORY_DEBUG=1 to record the heap and
+//  stack at checkpoints in send(), sendBuffer() and decodeMessage().  The stack is painted
+//  at startup so that the deepest stack use can be found later.
+#ifndef SIGFOX_MEMORY_DEBUG
+#define SIGFOX_MEMORY_DEBUG 0
+#endif  //  SIGFOX_MEMORY_DEBUG
+
+//  Places in the library where the memory is checked.
+enum MemoryCheckpoint {
+  MEMORY_SEND_BUFFER = 0,  //  End of Wisol or Radiocrafts sendBuffer(), with the response received.
+  MEMORY_MESSAGE_SEND = 1,  //  Message send(), before passing the message to the transceiver.
+  MEMORY_DECODE_MESSAGE = 2,  //  End of Message decodeMessage(), with the result built.
+  MEMORY_CHECKPOINTS = 3,  //  Number of checkpoints.
+};
+
+struct MemoryStats {
+  uint16_t heapFree;  //  Bytes free in the heap, including the free list.
+  uint16_t largestBlock;  //  Largest String that can be allocated.  Falls as the heap fragments.
+  uint16_t freeBlocks;  //  Number of blocks in the free list.  Grows as the heap fragments.
+  uint16_t stackFree;  //  Bytes between the heap and the deepest stack use so far.  0 if not measured.
+};
+
+#if SIGFOX_MEMORY_DEBUG
+#define memoryCheck(point) memoryCheckpoint(point)
+#else  //  SIGFOX_MEMORY_DEBUG
+#define memoryCheck(point) {}
+#endif  //  SIGFOX_MEMORY_DEBUG
+
+void getMemoryStats(MemoryStats &stats);  //  Return the current heap and stack stats.
+void memoryBegin(Print *port);  //  Print a line at every checkpoint to this port.  0 to stop printing.
+void memoryCheckpoint(uint8_t point);  //  Record the lowest stats seen at this checkpoint.
+void getMemoryLowest(uint8_t point, MemoryStats &stats);  //  Return the lowest stats seen at the checkpoint.
+
+#endif // UNABIZ_ARDUINO_MEMORY_H
@@ -38,12 +38,27 @@ static char decodeLetter(uint8_t code) {
   return 0;
 }
 
+//  Echo through the transceiver.  Levels disabled by SIGFOX_LOG_LEVEL compile to nothing,
+//  so the message Strings are never built.
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#define log1(x) { echo(x); }
+#else  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#define log1(x) {}
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+#define error1(x) { echo(x); }
+#else  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+#define error1(x) {}
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
 static String doubleToString(double d) {
   //  Convert double to string, since Bean+ doesn't support double in Strings.
   //  Assume 1 decimal place.
   String result = String((int) (d)) + '.' + String(((int) (d * 10.0)) % 10);
   return result;
 }
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
 
 void Message::echo(String msg) {
   if (wisol) wisol->echo(msg);
@@ -60,27 +75,27 @@ Message::Message(Wisol &transceiver) {
   wisol = &transceiver;
 }
 
-//  TODO: Move these messages to Flash memory.
-static String addFieldHeader = "Message.addField: ";
-static String tooLong = "****ERROR: Message too long, already ";
+//  Messages are kept in flash memory.
+#define ADD_FIELD_HEADER F("Message.addField: ")
+#define TOO_LONG F("****ERROR: Message too long, already ")
 
 bool Message::addField(const String name, int value) {
   //  Add an integer field scaled by 10.  2 bytes.
-  echo(addFieldHeader + name + '=' + value);
+  log1(String(ADD_FIELD_HEADER) + name + '=' + value);
   int val = value * 10;
   return addIntField(name, val);
 }
 
 bool Message::addField(const String name, float value) {
   //  Add a float field with 1 decimal place.  2 bytes.
-  echo(addFieldHeader + name + '=' + doubleToString(value));
+  log1(String(ADD_FIELD_HEADER) + name + '=' + doubleToString(value));
   int val = (int) (value * 10.0);
   return addIntField(name, val);
 }
 
 bool Message::addField(const String name, double value) {
   //  Add a double field with 1 decimal place.  2 bytes.
-  echo(addFieldHeader + name + '=' + doubleToString(value));
+  log1(String(ADD_FIELD_HEADER) + name + '=' + doubleToString(value));
   int val = (int) (value * 10.0);
   return addIntField(name, val);
 }
@@ -88,7 +103,7 @@ bool Message::addField(const String name, double value) {
 bool Message::addIntField(const String name, int value) {
   //  Add an int field that is already scaled.  2 bytes for name, 2 bytes for value.
   if (encodedMessage.length() + (4 * 2) > MAX_BYTES_PER_MESSAGE * 2) {
-    echo(tooLong + (encodedMessage.length() / 2) + " bytes");
+    error1(String(TOO_LONG) + (encodedMessage.length() / 2) + F(" bytes"));
     return false;
   }
   addName(name);
@@ -99,9 +114,9 @@ bool Message::addIntField(const String name, int value) {
 
 bool Message::addField(const String name, const String value) {
   //  Add a string field with max 3 chars.  2 bytes for name, 2 bytes for value.
-  echo(addFieldHeader + name + '=' + value);
+  log1(String(ADD_FIELD_HEADER) + name + '=' + value);
   if (encodedMessage.length() + (4 * 2) > MAX_BYTES_PER_MESSAGE * 2) {
-    echo(tooLong + (encodedMessage.length() / 2) + " bytes");
+    error1(String(TOO_LONG) + (encodedMessage.length() / 2) + F(" bytes"));
     return false;
   }
   addName(name);
@@ -136,13 +151,14 @@ bool Message::send() {
   //  Send the encoded message to SIGFOX.
   String msg = getEncodedMessage();
   if (msg.length() == 0) {
-    echo("****ERROR: Nothing to send");  //  TODO: Move to Flash.
+    error1(F("****ERROR: Nothing to send"));
     return false;
   }
   if (msg.length() > MAX_BYTES_PER_MESSAGE * 2) {
-    echo(tooLong + (encodedMessage.length() / 2) + " bytes");
+    error1(String(TOO_LONG) + (encodedMessage.length() / 2) + F(" bytes"));
     return false;
   }
+  memoryCheck(MEMORY_MESSAGE_SEND);
   if (wisol) return wisol->sendMessage(msg);
   else if (radiocrafts) return radiocrafts->sendMessage(msg);
   return false;
@@ -152,11 +168,11 @@ bool Message::sendAndGetResponse(String &response) {
   //  Send the structured message and get the downlink response.
   String msg = getEncodedMessage();
   if (msg.length() == 0) {
-    echo("****ERROR: Nothing to send");  //  TODO: Move to Flash.
+    error1(F("****ERROR: Nothing to send"));
     return false;
   }
   if (msg.length() > MAX_BYTES_PER_MESSAGE * 2) {
-    echo(tooLong + (encodedMessage.length() / 2) + " bytes");
+    error1(String(TOO_LONG) + (encodedMessage.length() / 2) + F(" bytes"));
     return false;
   }
   if (wisol) return wisol->sendMessageAndGetResponse(msg, response);
@@ -169,31 +185,26 @@ String Message::getEncodedMessage() {
   return encodedMessage;
 }
 
-static uint8_t hexDigitToDecimal(char ch) {
-  //  Convert 0..9, a..f, A..F to decimal.
-  if (ch >= '0' && ch <= '9') return (uint8_t) ch - '0';
-  if (ch >= 'a' && ch <= 'z') return (uint8_t) ch - 'a' + 10;
-  if (ch >= 'A' && ch <= 'Z') return (uint8_t) ch - 'A' + 10;
-  return 0;
+static bool decodeWord(const char *digits, unsigned long &value) {
+  //  Decode 4 hex digits of a 16-bit little-endian word.  Return false if one is invalid.
+  const uint8_t d0 = hexDigitValue(digits[0]), d1 = hexDigitValue(digits[1]),
+    d2 = hexDigitValue(digits[2]), d3 = hexDigitValue(digits[3]);
+  if (d0 == HEX_DIGIT_INVALID || d1 == HEX_DIGIT_INVALID ||
+      d2 == HEX_DIGIT_INVALID || d3 == HEX_DIGIT_INVALID) return false;
+  value = ((unsigned long) d2 << 12) + ((unsigned long) d3 << 8) + (d0 << 4) + d1;
+  return true;
 }
 
 String Message::decodeMessage(String msg) {
   //  Decode the encoded message.
   //  2 bytes name, 2 bytes float * 10, 2 bytes name, 2 bytes float * 10, ...
+  //  Digits after the last complete field, or from the first field with an invalid digit, are ignored.
   String result = "{";
-  for (int i = 0; i < msg.length(); i = i + 8) {
-    String name = msg.substring(i, i + 4);
-    String val = msg.substring(i + 4, i + 8);
-    unsigned long name2 =
-      (hexDigitToDecimal(name.charAt(2)) << 12) +
-      (hexDigitToDecimal(name.charAt(3)) << 8) +
-      (hexDigitToDecimal(name.charAt(0)) << 4) +
-      hexDigitToDecimal(name.charAt(1));
-    unsigned long val2 =
-      (hexDigitToDecimal(val.charAt(2)) << 12) +
-      (hexDigitToDecimal(val.charAt(3)) << 8) +
-      (hexDigitToDecimal(val.charAt(0)) << 4) +
-      hexDigitToDecimal(val.charAt(1));
+  const char *digits = msg.c_str();
+  const unsigned int length = msg.length();
+  for (unsigned int i = 0; i + 8 <= length; i = i + 8) {
+    unsigned long name2, val2;
+    if (!decodeWord(digits + i, name2) || !decodeWord(digits + i + 4, val2)) break;
     if (i > 0) result.concat(',');
     result.concat('"');
     //  Decode name.
@@ -211,15 +222,26 @@ String Message::decodeMessage(String msg) {
     result.concat('.'); result.concat((int)(val2 % 10));
   }
   result.concat('}');
+  memoryCheck(MEMORY_DECODE_MESSAGE);
   return result;
 }
 
 void stop(const String msg) {
-  //  Call this function if we need to stop.  This informs the emulator to stop listening.
-  for (;;) {
+  //  Call this function if we can't continue.  This informs the emulator to stop listening.
+  //  Unattended devices have nobody to press reset, so start again after a minute.  The
+  //  minute also keeps a missing module from wearing out the EEPROM boot counter.
+  for (uint8_t i = 0; i < 6; i++) {
     Serial.print(F("STOPSTOPSTOP: "));
     Serial.println(msg);
     delay(10000);
-    //  Loop forever since we can't continue
   }
+  Serial.flush();
+  watchdogReset();
+}
+
+void halt(const String msg) {
+  //  Call this function when the sketch is done.  Power down until the MCU is reset.
+  Serial.println(msg);
+  Serial.flush();
+  for (;;) powerDown(60000);
 }
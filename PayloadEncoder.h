@@ -0,0 +1,267 @@
+//  Encoder for payloads described by the "Custom Payload Config" of the Sigfox callback, e.g.
+//    count::uint:16:little-endian temperature::float:32 voltage::float:32
+//  The config is parsed by the compiler, so the sketch packs its fields with the same string
+//  that is pasted into the callback, and a field that doesn't match the config fails to
+//  compile.  Each set<>() compiles to the byte stores you would write by hand:
+//    extern constexpr char DEMO_PAYLOAD[] = "count::uint:16:little-endian temperature::float:32";
+//    PayloadEncoder<DEMO_PAYLOAD> payload;
+//    payload.set<payload.field("count")>(cnt);
+//    payload.set<payload.field("temperature")>(temperature);
+//    uplinks.push(payload.hex());
+//  The config must be declared extern constexpr, because C++11 templates only take the
+//  address of objects with external linkage.  Nothing reads the string at run time, so the
+//  linker drops it from the firmware.
+#ifndef UNABIZ_ARDUINO_PAYLOAD_ENCODER_H
+#define UNABIZ_ARDUINO_PAYLOAD_ENCODER_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include <string.h>
+
+//  Parser for the config, evaluated by the compiler.  Fields are name:byteIndex:type:size with
+//  an optional :little-endian or :big-endian for uint, int and float, like the callback.
+//  Written as C++11 constexpr functions, with one return statement each, for avr-gcc.
+struct PayloadGrammar {
+  enum Type { TYPE_BOOL, TYPE_CHAR, TYPE_UINT, TYPE_INT, TYPE_FLOAT };
+
+  //  Number of fields.
+  static constexpr uint8_t count(const char *s, unsigned i = 0) {
+    return s[skipSpaces(s, i)] ? 1 + count(s, skipField(s, skipSpaces(s, i))) : 0;
+  }
+  //  Index of the field with this name.
+  static constexpr uint8_t fieldNamed(const char *s, const char *name, uint8_t f = 0) {
+    return f >= count(s) ? errorNoSuchField() : equals(s, start(s, f), name) ? f : fieldNamed(s, name, f + 1);
+  }
+  static constexpr Type type(const char *s, uint8_t f) { return typeAt(s, part(s, start(s, f), 2)); }
+  //  Bits for uint, int and float, bytes for char, bit index for bool.
+  static constexpr unsigned size(const char *s, uint8_t f) {
+    return isNumber(s, part(s, start(s, f), 3)) ? number(s, part(s, start(s, f), 3)) : errorBadSize();
+  }
+  static constexpr uint8_t bytes(const char *s, uint8_t f) {
+    return type(s, f) == TYPE_BOOL ? 1 : type(s, f) == TYPE_CHAR ? size(s, f) : size(s, f) / 8;
+  }
+  static constexpr uint8_t bit(const char *s, uint8_t f) { return type(s, f) == TYPE_BOOL ? size(s, f) : 0; }
+  static constexpr bool littleEndian(const char *s, uint8_t f) {
+    return !hasPart(s, start(s, f), 4) ? false :
+      equals(s, part(s, start(s, f), 4), "little-endian") ? true :
+      equals(s, part(s, start(s, f), 4), "big-endian") ? false : errorBadEndianness();
+  }
+  //  First byte of the field.  If byteIndex is empty, the field starts after the previous one.
+  static constexpr unsigned byteIndex(const char *s, uint8_t f) {
+    return isPartEnd(s[part(s, start(s, f), 1)]) ? (f == 0 ? 0 : byteIndex(s, f - 1) + bytes(s, f - 1)) :
+      isNumber(s, part(s, start(s, f), 1)) ? number(s, part(s, start(s, f), 1)) : errorBadByteIndex();
+  }
+  //  Bytes needed for fields f and after.
+  static constexpr unsigned length(const char *s, uint8_t f = 0) {
+    return f >= count(s) ? 0 : larger(byteIndex(s, f) + bytes(s, f), length(s, f + 1));
+  }
+  //  True if fields f and after are valid.  Otherwise the compiler stops with the name of the
+  //  error function that was called.
+  static constexpr bool valid(const char *s, uint8_t f = 0) {
+    return count(s) == 0 ? errorNoFields() : f >= count(s) ? true : check(s, f) && valid(s, f + 1);
+  }
+
+private:
+  //  Not defined: calling one in a constant expression is a compile error that names it.
+  static unsigned errorNoFields();
+  static unsigned errorNoSuchField();
+  static unsigned errorNoName();
+  static unsigned errorMissingPart();
+  static unsigned errorTooManyParts();
+  static unsigned errorUnknownType();
+  static unsigned errorBadSize();
+  static unsigned errorBadEndianness();
+  static unsigned errorBadByteIndex();
+
+  static constexpr bool isSpace(char c) { return c == ' ' || c == '\t'; }
+  static constexpr bool isEnd(char c) { return c == 0 || isSpace(c); }
+  static constexpr bool isPartEnd(char c) { return c == ':' || isEnd(c); }
+  static constexpr unsigned larger(unsigned a, unsigned b) { return a > b ? a : b; }
+  static constexpr unsigned skipSpaces(const char *s, unsigned i) { return isSpace(s[i]) ? skipSpaces(s, i + 1) : i; }
+  static constexpr unsigned skipField(const char *s, unsigned i) { return isEnd(s[i]) ? i : skipField(s, i + 1); }
+  //  Position of field f, counting from the field at i.
+  static constexpr unsigned start(const char *s, uint8_t f, unsigned i = 0) {
+    return !s[skipSpaces(s, i)] ? errorNoSuchField() :
+      f == 0 ? skipSpaces(s, i) : start(s, f - 1, skipField(s, skipSpaces(s, i)));
+  }
+  //  Position of part p (0 name, 1 byteIndex, 2 type, 3 size, 4 endianness) of the field at i.
+  static constexpr bool hasPart(const char *s, unsigned i, uint8_t p) {
+    return p == 0 ? true : isEnd(s[i]) ? false : hasPart(s, i + 1, s[i] == ':' ? p - 1 : p);
+  }
+  static constexpr unsigned part(const char *s, unsigned i, uint8_t p) {
+    return p == 0 ? i : isEnd(s[i]) ? errorMissingPart() : part(s, i + 1, s[i] == ':' ? p - 1 : p);
+  }
+  //  True if the part at i is the text.
+  static constexpr bool equals(const char *s, unsigned i, const char *text) {
+    return *text ? s[i] == *text && equals(s, i + 1, text + 1) : isPartEnd(s[i]);
+  }
+  static constexpr bool isNumber(const char *s, unsigned i) {
+    return s[i] >= '0' && s[i] <= '9' && (isPartEnd(s[i + 1]) || isNumber(s, i + 1));
+  }
+  static constexpr unsigned number(const char *s, unsigned i, unsigned value = 0) {
+    return isPartEnd(s[i]) ? value : number(s, i + 1, value * 10 + s[i] - '0');
+  }
+  static constexpr Type typeAt(const char *s, unsigned i) {
+    return equals(s, i, "bool") ? TYPE_BOOL : equals(s, i, "char") ? TYPE_CHAR :
+      equals(s, i, "uint") ? TYPE_UINT : equals(s, i, "int") ? TYPE_INT :
+      equals(s, i, "float") ? TYPE_FLOAT : (Type) errorUnknownType();
+  }
+  static constexpr bool validSize(Type type, unsigned size) {
+    return type == TYPE_BOOL ? size <= 7 : type == TYPE_CHAR ? size >= 1 && size <= 12 :
+      type == TYPE_FLOAT ? size == 32 || size == 64 : size >= 8 && size <= 64 && size % 8 == 0;
+  }
+  static constexpr bool check(const char *s, uint8_t f) {
+    return (isPartEnd(s[start(s, f)]) ? errorNoName() : true)
+      && (validSize(type(s, f), size(s, f)) ? true : errorBadSize())
+      && (hasPart(s, start(s, f), type(s, f) == TYPE_BOOL || type(s, f) == TYPE_CHAR ? 4 : 5) ? errorTooManyParts() : true)
+      && (littleEndian(s, f) || true)
+      && (byteIndex(s, f) < 256 ? true : errorBadByteIndex());
+  }
+};
+
+//  Smallest integers that hold the bytes of a uint or int field.
+template <uint8_t bytes> struct PayloadUnsigned { typedef uint64_t Type; };
+template <> struct PayloadUnsigned<1> { typedef uint8_t Type; };
+template <> struct PayloadUnsigned<2> { typedef uint16_t Type; };
+template <> struct PayloadUnsigned<3> { typedef uint32_t Type; };
+template <> struct PayloadUnsigned<4> { typedef uint32_t Type; };
+template <uint8_t bytes> struct PayloadSigned { typedef int64_t Type; };
+template <> struct PayloadSigned<1> { typedef int8_t Type; };
+template <> struct PayloadSigned<2> { typedef int16_t Type; };
+template <> struct PayloadSigned<3> { typedef int32_t Type; };
+template <> struct PayloadSigned<4> { typedef int32_t Type; };
+
+//  Store bytes i to n - 1 of value, counting from the least significant, unrolled.
+template <uint8_t i, uint8_t n, bool little> struct PayloadBytes {
+  template <typename T> static void put(uint8_t *p, T value) {
+    p[little ? i : n - 1 - i] = (uint8_t) value;
+    PayloadBytes<i + 1, n, little>::put(p, (T) (value >> 8));
+  }
+};
+template <uint8_t n, bool little> struct PayloadBytes<n, n, little> {
+  template <typename T> static void put(uint8_t *, T) {}
+};
+
+//  Bits of a float:64 field.  double is a float on the AVR, so its bits are widened.
+template <uint8_t size> struct PayloadDouble {
+  static uint64_t bits(float value) {
+    uint32_t single;
+    memcpy(&single, &value, sizeof(single));
+    const uint64_t sign = (uint64_t) (single >> 31) << 63;
+    const uint8_t exponent = single >> 23;
+    uint32_t mantissa = single & 0x7fffff;
+    if (exponent == 0xff) return sign | (uint64_t) 0x7ff << 52 | (uint64_t) mantissa << 29;  //  Infinity or NaN.
+    if (exponent == 0 && mantissa == 0) return sign;
+    int16_t biased = exponent + 1023 - 127;
+    if (exponent == 0) {
+      //  Subnormal floats are normal doubles.
+      biased++;
+      while (!(mantissa & 0x800000)) { mantissa <<= 1; biased--; }
+      mantissa &= 0x7fffff;
+    }
+    return sign | (uint64_t) biased << 52 | (uint64_t) mantissa << 29;
+  }
+};
+template <> struct PayloadDouble<8> {
+  static uint64_t bits(double value) {
+    uint64_t result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+  }
+};
+
+//  Store a value of each type at the first byte of its field.
+template <PayloadGrammar::Type type, uint8_t bytes, bool little, uint8_t bit> struct PayloadPut;
+template <uint8_t bytes, bool little, uint8_t bit> struct PayloadPut<PayloadGrammar::TYPE_BOOL, bytes, little, bit> {
+  typedef bool Value;
+  static void put(uint8_t *p, Value value) {
+    if (value) *p |= (uint8_t) (1 << bit);
+    else *p &= (uint8_t) ~(1 << bit);
+  }
+};
+template <uint8_t bytes, bool little, uint8_t bit> struct PayloadPut<PayloadGrammar::TYPE_CHAR, bytes, little, bit> {
+  typedef const char *Value;
+  static void put(uint8_t *p, Value value) {
+    //  Padded with 0 bytes, which the callback leaves out of the text.
+    for (uint8_t i = 0; i < bytes; i++) {
+      p[i] = *value;
+      if (*value) value++;
+    }
+  }
+};
+template <uint8_t bytes, bool little, uint8_t bit> struct PayloadPut<PayloadGrammar::TYPE_UINT, bytes, little, bit> {
+  typedef typename PayloadUnsigned<bytes>::Type Value;
+  static void put(uint8_t *p, Value value) { PayloadBytes<0, bytes, little>::put(p, value); }
+};
+template <uint8_t bytes, bool little, uint8_t bit> struct PayloadPut<PayloadGrammar::TYPE_INT, bytes, little, bit> {
+  typedef typename PayloadSigned<bytes>::Type Value;
+  static void put(uint8_t *p, Value value) {
+    PayloadBytes<0, bytes, little>::put(p, (typename PayloadUnsigned<bytes>::Type) value);
+  }
+};
+template <bool little, uint8_t bit> struct PayloadPut<PayloadGrammar::TYPE_FLOAT, 4, little, bit> {
+  typedef float Value;
+  static void put(uint8_t *p, Value value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    PayloadBytes<0, 4, little>::put(p, bits);
+  }
+};
+template <bool little, uint8_t bit> struct PayloadPut<PayloadGrammar::TYPE_FLOAT, 8, little, bit> {
+  typedef double Value;
+  static void put(uint8_t *p, Value value) {
+    PayloadBytes<0, 8, little>::put(p, PayloadDouble<sizeof(double)>::bits(value));
+  }
+};
+
+template <const char *config> class PayloadEncoder
+{
+public:
+  static_assert(PayloadGrammar::valid(config), "Custom Payload Config is not valid");
+  static constexpr uint8_t fields = PayloadGrammar::count(config);  //  Number of fields.
+  static constexpr uint8_t length = PayloadGrammar::length(config);  //  Bytes in the payload.
+  static_assert(length <= MAX_BYTES_PER_MESSAGE, "Custom Payload Config is longer than 12 bytes");
+
+  //  Store and byte order of field f.
+  template <uint8_t f> struct Field {
+    typedef PayloadPut<PayloadGrammar::type(config, f), PayloadGrammar::bytes(config, f),
+      PayloadGrammar::littleEndian(config, f), PayloadGrammar::bit(config, f)> Put;
+    static constexpr uint8_t byteIndex = PayloadGrammar::byteIndex(config, f);
+  };
+
+  PayloadEncoder() { clear(); }
+  //  Index of the field with this name, for set<>().  Fails to compile if there is none.
+  static constexpr uint8_t field(const char *name) { return PayloadGrammar::fieldNamed(config, name); }
+  //  Set field f: a bool, text for char, an integer for uint and int, float or double.
+  template <uint8_t f> void set(typename Field<f>::Put::Value value) {
+    Field<f>::Put::put(bytes + Field<f>::byteIndex, value);
+  }
+  void clear() { memset(bytes, 0, length); }  //  Set all fields to 0.
+  const uint8_t *getBytes() const { return bytes; }  //  Return the payload.
+  const char *hex() {
+    //  Return the payload as hex digits, in lower case like toHex(), ready to send.
+    for (uint8_t i = 0; i < length; i++) {
+      text[2 * i] = hexDigit(bytes[i] >> 4);
+      text[2 * i + 1] = hexDigit(bytes[i] & 0xf);
+    }
+    text[2 * length] = 0;
+    return text;
+  }
+
+private:
+  static char hexDigit(uint8_t d) { return d < 10 ? '0' + d : 'a' + d - 10; }
+  uint8_t bytes[length];
+  char text[length * 2 + 1];
+};
+
+template <const char *config> constexpr uint8_t PayloadEncoder<config>::fields;
+template <const char *config> constexpr uint8_t PayloadEncoder<config>::length;
+template <const char *config> template <uint8_t f> constexpr uint8_t PayloadEncoder<config>::Field<f>::byteIndex;
+
+#endif // UNABIZ_ARDUINO_PAYLOAD_ENCODER_H
@@ -0,0 +1,170 @@
+//  Low-power helpers for putting the Arduino to sleep between SIGFOX messages.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+static bool armed = false;  //  True if watchdogArm() was called.
+static unsigned long armTime;  //  millis() when armed.
+static unsigned long armTimeout;  //  Stop feeding the watchdog after this many ms.
+
+#if defined(__AVR__) && !defined(BEAN_BEAN_BEAN_H)
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+//  Maintained by the Arduino core in wiring.c.  Doesn't advance while powered down.
+extern volatile unsigned long timer0_millis;
+
+//  After a watchdog reset the watchdog stays enabled at 15 ms, and WDE can't be cleared while
+//  WDRF is set.  Clear both before main(), since bootloaders that don't would reset us forever.
+static void watchdogClearReset() __attribute__ ((naked, used, section (".init3")));
+static void watchdogClearReset() {
+  MCUSR = 0;
+  wdt_disable();
+}
+
+#if SIGFOX_WATCHDOG_ISR
+ISR(WDT_vect) {
+  //  Watchdog woke us from power-down.  Nothing to do, the sleep loop carries on.
+}
+#endif  //  SIGFOX_WATCHDOG_ISR
+
+static void watchdogSleep(uint8_t prescaler) {
+  //  Power down until the watchdog interrupt fires after 16 ms << prescaler.  The watchdog
+  //  is borrowed for the wakeup, so put back the reset that watchdogArm() set up, if any.
+  const uint8_t adc = ADCSRA;
+  ADCSRA &= ~(1 << ADEN);  //  ADC draws current even when powered down.
+  cli();
+  MCUSR &= ~(1 << WDRF);
+  WDTCSR = (1 << WDCE) | (1 << WDE);  //  Timed sequence to change the watchdog config.
+  WDTCSR = (1 << WDIE) |  //  Interrupt only, no reset.
+    ((prescaler & 8) ? (1 << WDP3) : 0) | (prescaler & 7);
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+#ifdef sleep_bod_disable
+  sleep_bod_disable();
+#endif  //  sleep_bod_disable
+  sei();
+  sleep_cpu();
+  sleep_disable();
+  if (armed) {
+    wdt_reset();
+    wdt_enable(WDTO_8S);
+  } else wdt_disable();
+  ADCSRA = adc;
+}
+
+void watchdogArm(unsigned long timeout) {
+  //  Reset the MCU if watchdogFeed() isn't called for 8 s, or the timeout passes.
+  armed = true;
+  armTime = millis();
+  armTimeout = timeout;
+  wdt_reset();
+  wdt_enable(WDTO_8S);
+}
+
+void watchdogFeed() {
+  //  Keep the watchdog from firing, unless the operation has overrun.
+  if (!armed) return;
+  if (millis() - armTime < armTimeout) wdt_reset();
+}
+
+void watchdogDisarm() {
+  armed = false;
+  MCUSR &= ~(1 << WDRF);  //  Else WDE stays set.
+  wdt_disable();
+}
+
+void watchdogReset() {
+  //  Let the watchdog reset the MCU.
+  wdt_enable(WDTO_15MS);
+  for (;;) {}
+}
+
+unsigned long powerDown(unsigned long milliSeconds) {
+  //  Sleep in the largest watchdog steps that fit (8 s down to 16 ms), then delay() for the rest.
+  unsigned long slept = 0;
+  for (int8_t prescaler = 9; prescaler >= 0; prescaler--) {
+    const unsigned long step = 16UL << prescaler;
+    while (milliSeconds - slept >= step) {
+      watchdogSleep(prescaler);
+      slept += step;
+    }
+  }
+  //  Timer 0 was stopped while powered down.  Catch up so that isReady() still works.
+  cli();
+  timer0_millis += slept;
+  sei();
+  delay(milliSeconds - slept);
+  return milliSeconds;
+}
+
+#else  //  __AVR__ && !BEAN_BEAN_BEAN_H
+
+//  No hardware watchdog on this platform.  Keep track of the timeout only.
+void watchdogArm(unsigned long timeout) { armed = true; armTime = millis(); armTimeout = timeout; }
+void watchdogFeed() {}
+void watchdogDisarm() { armed = false; }
+void watchdogReset() { for (;;) {} }
+
+unsigned long powerDown(unsigned long milliSeconds) {
+  //  No watchdog power-down on this platform.
+#ifdef BEAN_BEAN_BEAN_H
+  Bean.sleep(milliSeconds);
+#else  // BEAN_BEAN_BEAN_H
+  delay(milliSeconds);
+#endif // BEAN_BEAN_BEAN_H
+  return milliSeconds;
+}
+
+#endif  //  __AVR__ && !BEAN_BEAN_BEAN_H
+
+bool watchdogArmed() { return armed; }
+
+unsigned long powerDownUntil(unsigned long wakeTime) {
+  //  Power down until millis() reaches wakeTime.  Return at once if it has passed.
+  const long remaining = (long) (wakeTime - millis());
+  if (remaining <= 0) return 0;
+  return powerDown((unsigned long) remaining);
+}
+
+bool estimateEnergy(const TransceiverStats &stats, unsigned long uplinkInterval,
+                    EnergyEstimate &estimate, const CurrentProfile &profile) {
+  //  Charge = current x time for each phase.  Times are in ms, 3600000 ms per hour, result in uAh.
+  const unsigned long uplinks = (unsigned long) stats.uplinks + stats.uplinkFailures;
+  if (uplinks == 0 || uplinkInterval == 0) return false;
+  const float uAhPerMAms = 1000.0 / 3600000.0;
+  //  MCU is busy for the whole command.  Module is idle except when sending a message.
+  const unsigned long radioTime = stats.uplinkWaitTime + stats.downlinkWaitTime;
+  const unsigned long busyTime = stats.settleTime + stats.txTime +
+    (stats.waitTime > radioTime ? stats.waitTime - radioTime : 0);
+  //  Radiocrafts returns before transmitting, so assume the typical transmit time.
+  unsigned long txTime = stats.uplinkWaitTime;
+  if (txTime == 0 && stats.downlinks < uplinks) txTime = (uplinks - stats.downlinks) * MODULE_TX_TIME;
+  //  A downlink request transmits as usual, then listens for the rest of the wait.
+  unsigned long downlinkTxTime = (unsigned long) stats.downlinks * MODULE_TX_TIME;
+  if (downlinkTxTime > stats.downlinkWaitTime) downlinkTxTime = stats.downlinkWaitTime;
+  const unsigned long rxTime = stats.downlinkWaitTime - downlinkTxTime;
+
+  const float uplinkMAms =
+    (profile.mcuActive + profile.moduleIdle) * busyTime +
+    profile.moduleTx * (txTime + downlinkTxTime) +
+    profile.mcuActive * (stats.uplinkWaitTime + downlinkTxTime);
+  const float downlinkMAms = (profile.mcuActive + profile.moduleRx) * rxTime;
+  estimate.perUplink = uplinkMAms * uAhPerMAms / uplinks;
+  estimate.perDownlink = stats.downlinks ? downlinkMAms * uAhPerMAms / stats.downlinks : 0;
+
+  //  Per day: the average cycle repeated, sleeping for the rest of the day.
+  const float cyclesPerDay = 86400000.0 / uplinkInterval;
+  const float awakePerDay = cyclesPerDay * (busyTime + radioTime) / uplinks;
+  const float sleepPerDay = awakePerDay < 86400000.0 ? 86400000.0 - awakePerDay : 0;
+  estimate.perDay = cyclesPerDay * (uplinkMAms + downlinkMAms) * uAhPerMAms / uplinks +
+    (profile.mcuSleep + profile.moduleSleep) * sleepPerDay * uAhPerMAms;
+  return true;
+}
@@ -0,0 +1,76 @@
+//  Low-power helpers for putting the Arduino to sleep between SIGFOX messages.
+#ifndef UNABIZ_ARDUINO_POWER_H
+#define UNABIZ_ARDUINO_POWER_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  powerDown() wakes up with the watchdog interrupt, so the library defines ISR(WDT_vect).  If the
+//  sketch or another library, like LowPower or Adafruit SleepyDog, defines it too, compile with
+//  -DSIGFOX_WATCHDOG_ISR=0 and keep theirs, which must also return without resetting.
+#ifndef SIGFOX_WATCHDOG_ISR
+#define SIGFOX_WATCHDOG_ISR 1
+#endif  //  SIGFOX_WATCHDOG_ISR
+
+//  Typical currents for estimating battery life, from the WSSFM10R and ATmega328P datasheets.
+//  Uno boards add their own regulator and USB chip losses (tens of mA), so measure the actual board.
+const float MODULE_TX_MA = 49.0;  //  Wisol module transmitting at max power.
+const float MODULE_RX_MA = 11.0;  //  Wisol module listening for the downlink.
+const float MODULE_IDLE_MA = 0.5;  //  Wisol module awake, waiting for commands.
+const float MODULE_SLEEP_MA = 0.0015;  //  Wisol module after AT$P=1.
+const float MCU_ACTIVE_MA = 15.0;  //  ATmega328P running at 16 MHz, 5 V.
+const float MCU_SLEEP_MA = 0.006;  //  ATmega328P in power-down with the watchdog running.
+const unsigned long MODULE_TX_TIME = 6000;  //  Sending one message takes about 6 seconds (3 repeats).
+
+//  Currents (mA) for estimating the charge used, so that boards and modules can be compared.
+struct CurrentProfile {
+  float moduleTx;  //  Module transmitting.
+  float moduleRx;  //  Module listening for the downlink.
+  float moduleIdle;  //  Module awake, waiting for commands.
+  float moduleSleep;  //  Module asleep.
+  float mcuActive;  //  MCU running.
+  float mcuSleep;  //  MCU powered down.
+};
+
+const CurrentProfile DEFAULT_CURRENT_PROFILE = {
+  MODULE_TX_MA, MODULE_RX_MA, MODULE_IDLE_MA, MODULE_SLEEP_MA, MCU_ACTIVE_MA, MCU_SLEEP_MA };
+
+//  Charge estimates in microamp-hours, from measured transceiver timings.
+struct EnergyEstimate {
+  float perUplink;  //  Average per message sent, including the other commands sent since clearStats().
+  float perDownlink;  //  Extra for each downlink, i.e. listening after sending.
+  float perDay;  //  Sending every uplinkInterval ms, sleeping in between.
+};
+
+//  Put the MCU into power-down for the given time, waking up with the watchdog timer.
+//  millis() is advanced by the time slept.  The watchdog is only accurate to about 10%.
+//  If watchdogArm() is in force, e.g. by the Supervisor, it is rearmed after each wakeup.
+//  Returns the number of milliseconds slept.
+unsigned long powerDown(unsigned long milliSeconds);
+
+//  Power down until millis() reaches wakeTime, e.g. the next scheduled send or sensor sample.
+unsigned long powerDownUntil(unsigned long wakeTime);
+
+//  Arm the hardware watchdog (8 s) around an operation that should finish within
+//  timeout ms.  watchdogFeed() keeps the watchdog from firing until the timeout passes,
+//  so the MCU resets if the operation hangs or overruns.  No-op on non-AVR boards.
+void watchdogArm(unsigned long timeout);
+void watchdogFeed();  //  Call this regularly from long-running loops.  Cheap when not armed.
+void watchdogDisarm();
+bool watchdogArmed();
+void watchdogReset();  //  Reset the MCU now via the watchdog.
+
+//  Estimate the charge per uplink, per downlink and per day from the phase timings measured by
+//  the transceiver, e.g. transceiver.getStats(stats), sending a message every uplinkInterval ms
+//  and sleeping in between.  Downlinks are assumed to be as frequent as in the stats.
+//  Call clearStats() after begin() to leave out the startup commands.  Returns false if no
+//  message has been sent yet.
+bool estimateEnergy(const TransceiverStats &stats, unsigned long uplinkInterval,
+                    EnergyEstimate &estimate, const CurrentProfile &profile = DEFAULT_CURRENT_PROFILE);
+
+#endif // UNABIZ_ARDUINO_POWER_H
@@ -9,11 +9,24 @@
 
 #include "SIGFOX.h"
 
-//  Use a macro for logging because Flash strings not supported with String class in Bean+
+//  Use a macro for logging because Flash strings not supported with String class in Bean+.
+//  Levels disabled by SIGFOX_LOG_LEVEL compile to nothing, so their arguments are never evaluated.
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
 #define log1(x) { echoPort->println(x); }
 #define log2(x, y) { echoPort->print(x); echoPort->println(y); }
-// #define log3(x, y, z) { echoPort->print(x); echoPort->print(y); echoPort->println(z); }
 #define log4(x, y, z, a) { echoPort->print(x); echoPort->print(y); echoPort->print(z); echoPort->println(a); }
+#else  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#define log1(x) {}
+#define log2(x, y) {}
+#define log4(x, y, z, a) {}
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+#define error1(x) { echoPort->println(x); }
+#define error2(x, y) { echoPort->print(x); echoPort->println(y); }
+#else  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+#define error1(x) {}
+#define error2(x, y) {}
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
 
 #define MODEM_BITS_PER_SECOND 19200
 #define END_OF_RESPONSE '>'  //  Character '>' marks the end of response.
@@ -48,6 +61,13 @@ Radiocrafts::Radiocrafts(Country country0, bool useEmulator0, const String devic
   //  an alternative class BeanSoftwareSerial to work around this.
   //  For Bean, SoftwareSerial is a #define alias for BeanSoftwareSerial.
   serialPort = new SoftwareSerial(rx, tx);
+  lastError = SEND_OK;
+#if SIGFOX_STATS
+  stats = new TransceiverStats;
+#else  //  SIGFOX_STATS
+  stats = 0;
+#endif  //  SIGFOX_STATS
+  clearStats();
   if (echo) echoPort = &Serial;
   else echoPort = &nullPort;
   lastEchoPort = &Serial;
@@ -59,6 +79,9 @@ bool Radiocrafts::begin() {
   lastSend = 0;
   for (int i = 0; i < 5; i++) {
     //  Retry 5 times.
+#if SIGFOX_STATS
+    if (i > 0) stats->retries++;
+#endif  //  SIGFOX_STATS
 #ifdef BEAN_BEAN_BEAN_H
     Bean.sleep(7000);  //  For Bean, delay longer to allow Bluetooth debug console to connect.
 #else  // BEAN_BEAN_BEAN_H
@@ -81,8 +104,8 @@ bool Radiocrafts::begin() {
     //  Read SIGFOX ID and PAC from module.
     log1(F(" - Getting SIGFOX ID..."));  String id, pac;
     if (!getID(id, pac)) continue;
-    echoPort->print(F(" - SIGFOX ID = "));  Serial.println(id);
-    echoPort->print(F(" - PAC = "));  Serial.println(pac);
+    log2(F(" - SIGFOX ID = "), id);
+    log2(F(" - PAC = "), pac);
 
     //  Set the frequency of SIGFOX module.
     log2(F(" - Setting frequency for country "), (int) country);
@@ -99,8 +122,10 @@ bool Radiocrafts::begin() {
     log1(F(" - Getting frequency (expecting 3)..."));  String frequency;
     if (!getFrequency(frequency)) continue;
     log2(F(" - Frequency (expecting 3) = "), frequency);
+    trace(TRACE_RADIOCRAFTS | TRACE_BEGIN, 0, 0, 0, 1);
     return true;  //  Init module succeeded.
   }
+  trace(TRACE_RADIOCRAFTS | TRACE_BEGIN, 0, 0, 0, 0);
   return false;  //  Failed to init module.
 }
 
@@ -109,15 +134,24 @@ bool Radiocrafts::sendMessage(const String &payload) {
   //  We convert to binary and send to SIGFOX.  Return true if successful.
   //  We represent the payload as hex instead of binary because 0x00 is a
   //  valid payload and this causes string truncation in C libraries.
-  //  Assumes we are in Send Mode.
+  //  Assumes we are in Send Mode.  The module doesn't answer in Send Mode, so failures on
+  //  air can't be detected: only SEND_NOT_READY is reported.
   log2(F(" - Radiocrafts.sendMessage: "), device + ',' + payload);
-  if (!isReady()) return false;  //  Prevent user from sending too many messages without sufficient delay.
+  if (!isReady()) {  //  Prevent user from sending too many messages without sufficient delay.
+    lastError = SEND_NOT_READY;
+    trace(TRACE_RADIOCRAFTS | TRACE_SEND_MESSAGE, payload.length() / 2, payload.length() / 2, 0, lastError);
+    return false;
+  }
+  const unsigned long uplinkStart = millis();
 
   //  Decode and send the data.
   //  First byte is payload length, followed by rest of payload.
   String message = toHex((char) (payload.length() / 2)) + payload, data;
   uint8_t markers = 0;
-  if (sendBuffer(message, COMMAND_TIMEOUT, 0, data, markers)) {  //  No markers expected.
+  const bool status = sendBuffer(message, COMMAND_TIMEOUT, 0, data, markers);  //  No markers expected.
+  trace(TRACE_RADIOCRAFTS | TRACE_SEND_MESSAGE, payload.length() / 2, payload.length() / 2, markers, lastError);
+  recordUplink(status, uplinkStart);
+  if (status) {
     log1(data);
     lastSend = millis();
     return true;
@@ -176,9 +210,19 @@ bool Radiocrafts::sendBuffer(const String &buffer, const int timeout,
   //  expect to see.  actualMarkerCount contains the actual number seen.
   log2(F(" - Radiocrafts.sendBuffer: "), buffer);
   response = "";
-  if (useEmulator) return true;
+  //  First byte sent identifies the command in the trace.
+  const uint8_t command = hexDigitToDecimal(buffer.charAt(0)) * 16 + hexDigitToDecimal(buffer.charAt(1));
+  if (useEmulator) {
+    lastError = SEND_OK;
+    trace(TRACE_RADIOCRAFTS | TRACE_SEND_BUFFER, command, buffer.length() / 2, 0, lastError);
+    return true;
+  }
 
   actualMarkerCount = 0;
+#if SIGFOX_STATS
+  const unsigned long settleStart = millis();
+#endif  //  SIGFOX_STATS
+  captureExchange();
   //  Start serial interface.
   serialPort->begin(MODEM_BITS_PER_SECOND);
 #ifdef BEAN_BEAN_BEAN_H
@@ -193,6 +237,9 @@ bool Radiocrafts::sendBuffer(const String &buffer, const int timeout,
   const char *rawBuffer = buffer.c_str();
   //  Send buffer and read response.  Loop until timeout or we see the end of response marker.
   unsigned long startTime = millis(); int i = 0;
+#if SIGFOX_STATS
+  const unsigned long sendStart = startTime;
+#endif  //  SIGFOX_STATS
   //  Previous code for verifying that data was sent correctly.
   //static String echoSend = "", echoReceive = "";
   for (;;) {
@@ -203,6 +250,7 @@ bool Radiocrafts::sendBuffer(const String &buffer, const int timeout,
                        hexDigitToDecimal(rawBuffer[i + 1]);
       //echoSend.concat(toHex((char) txChar) + ' ');
       serialPort->write(txChar);
+      captureByte(CAPTURE_SENT, txChar);
 #ifdef BEAN_BEAN_BEAN_H
       Bean.sleep(10);
 #else  // BEAN_BEAN_BEAN_H
@@ -212,7 +260,8 @@ bool Radiocrafts::sendBuffer(const String &buffer, const int timeout,
       startTime = millis();  //  Start the timer only when all data has been sent.
     }
 
-    //  If timeout, quit.
+    //  If timeout, quit.  Keep the watchdog from resetting us while we wait.
+    watchdogFeed();
     const unsigned long currentTime = millis();
     if (currentTime - startTime > timeout) break;
 
@@ -221,6 +270,7 @@ bool Radiocrafts::sendBuffer(const String &buffer, const int timeout,
       int rxChar = serialPort->read();
       //  echoReceive.concat(toHex((char) rxChar) + ' ');
       if (rxChar == -1) continue;
+      captureByte(CAPTURE_RECEIVED, rxChar);
       if (rxChar == END_OF_RESPONSE) {
         if (actualMarkerCount < markerPosMax)
           markerPos[actualMarkerCount] = response.length();  //  Remember the marker pos.
@@ -229,27 +279,53 @@ bool Radiocrafts::sendBuffer(const String &buffer, const int timeout,
       } else {
         response.concat(toHex((char) rxChar));
       }
+    } else if (i >= buffer.length()) {
+      //  Waiting for the module to respond: let the background tasks of the scheduler run.
+      schedulerYield();
     }
 
     //  TODO: Check for downlink response.
 
   }
   serialPort->end();
+  captureFlush();
+#if SIGFOX_STATS
+  //  startTime is now when the last byte was sent.  Response is in hex, 2 digits per byte.
+  const unsigned long endTime = millis();
+  stats->commands++;
+  if (actualMarkerCount >= expectedMarkerCount) stats->successes++;
+  else if (response.length() == 0) stats->timeouts++;
+  else stats->unknownResponses++;
+  stats->bytesOut += buffer.length() / 2;
+  stats->bytesIn += response.length() / 2;
+  stats->settleTime += sendStart - settleStart;
+  stats->txTime += startTime - sendStart;
+  stats->waitTime += endTime - startTime;
+  statsAddCommand(*stats, command, endTime - sendStart);
+#endif  //  SIGFOX_STATS
   //  Log the actual bytes sent and received.
   //log2(F(">> "), echoSend);
   //  if (echoReceive.length() > 0) { log2(F("<< "), echoReceive); }
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
   logBuffer(F(">> "), rawBuffer, 0, 0);
   logBuffer(F("<< "), response.c_str(), markerPos, actualMarkerCount);
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
+  memoryCheck(MEMORY_SEND_BUFFER);
 
   //  If we did not see the terminating '>', something is wrong.
   if (actualMarkerCount < expectedMarkerCount) {
     if (response.length() == 0) {
-      log1(F(" - Radiocrafts.sendBuffer: Error: No response"));  //  Response timeout.
+      error1(F(" - Radiocrafts.sendBuffer: Error: No response"));  //  Response timeout.
+      lastError = SEND_NO_RESPONSE;
     } else {
-      log2(F(" - Radiocrafts.sendBuffer: Error: Unknown response: "), response);
+      error2(F(" - Radiocrafts.sendBuffer: Error: Unknown response: "), response);
+      lastError = SEND_UNKNOWN_RESPONSE;
     }
+    trace(TRACE_RADIOCRAFTS | TRACE_SEND_BUFFER, command, buffer.length() / 2, actualMarkerCount, lastError);
     return false;
   }
+  lastError = SEND_OK;
+  trace(TRACE_RADIOCRAFTS | TRACE_SEND_BUFFER, command, buffer.length() / 2, actualMarkerCount, lastError);
   log2(F(" - Radiocrafts.sendBuffer: response: "), response);
   //  TODO: Parse the downlink response.
   return true;
@@ -295,11 +371,11 @@ bool Radiocrafts::isReady()
   const unsigned long elapsedTime = currentTime - lastSend;
   //  For development, allow sending every 2 seconds.
   if (elapsedTime <= 2 * 1000) {
-    log1(F("***MESSAGE NOT SENT - Must wait 2 seconds before sending the next message"));
+    error1(F("***MESSAGE NOT SENT - Must wait 2 seconds before sending the next message"));
     return false;
   }  //  Wait before sending.
   if (elapsedTime <= SEND_DELAY)
-    log1(F("Warning: Should wait 10 mins before sending the next message"));
+    error1(F("Warning: Should wait 10 mins before sending the next message"));
   return true;
 }
 
@@ -311,15 +387,19 @@ bool Radiocrafts::enterCommandMode() {
   log1(F(" - Entering command mode..."));
   //  Confirm we are in SEND_MODE
   if (mode != SEND_MODE) {
-    log1(F(" - Warning: Radiocrafts.enterCommandMode did not detect expected Send Mode, may be in incorrect mode"));
+    error1(F(" - Warning: Radiocrafts.enterCommandMode did not detect expected Send Mode, may be in incorrect mode"));
   }
   uint8_t markers = 0;
-  if (!sendBuffer("00", COMMAND_TIMEOUT, 1, modeData, markers)) return false;
+  if (!sendBuffer("00", COMMAND_TIMEOUT, 1, modeData, markers)) {
+    trace(TRACE_RADIOCRAFTS | TRACE_COMMAND_MODE, 0x00, 1, markers, 0);
+    return false;
+  }
   //  Confirm response = '>'
-  if (modeData != String("") || markers != 1) {
-    log1(F(" - Warning: Radiocrafts.enterCommandMode did not receive expected '>', may be in incorrect mode"));
+  if (modeData.length() != 0 || markers != 1) {
+    error1(F(" - Warning: Radiocrafts.enterCommandMode did not receive expected '>', may be in incorrect mode"));
   }
   mode = COMMAND_MODE;
+  trace(TRACE_RADIOCRAFTS | TRACE_COMMAND_MODE, 0x00, 1, markers, 1);
   log1(F(" - Radiocrafts.enterCommandMode: OK "));
   return true;
 }
@@ -329,16 +409,23 @@ bool Radiocrafts::exitCommandMode() {
   log1(F(" - Exiting command mode..."));
   //  Confirm we are in COMMAND_MODE.
   if (mode != COMMAND_MODE) {
-    log1(F(" - Warning: Radiocrafts.exitCommandMode did not detect expected Command Mode, may be in incorrect mode"));
+    error1(F(" - Warning: Radiocrafts.exitCommandMode did not detect expected Command Mode, may be in incorrect mode"));
   }
   for (;;) {
     //  Keep sending the exit command until we are really sure.  Sometimes we might out of sync.
     uint8_t markers = 0;
-    if (!sendBuffer(toHex('X'), COMMAND_TIMEOUT, 0, modeData, markers)) return false;
-    if (modeData == String("") && markers == 0) break;
-    log1(F(" - Warning: Radiocrafts.exitCommandMode resending exit command, may be in incorrect mode"));
+    if (!sendBuffer(toHex('X'), COMMAND_TIMEOUT, 0, modeData, markers)) {
+      trace(TRACE_RADIOCRAFTS | TRACE_SEND_MODE, 'X', 1, markers, 0);
+      return false;
+    }
+    if (modeData.length() == 0 && markers == 0) break;
+#if SIGFOX_STATS
+    stats->retries++;
+#endif  //  SIGFOX_STATS
+    error1(F(" - Warning: Radiocrafts.exitCommandMode resending exit command, may be in incorrect mode"));
   }
   mode = SEND_MODE;
+  trace(TRACE_RADIOCRAFTS | TRACE_SEND_MODE, 'X', 1, 0, 1);
   log1(F(" - Radiocrafts.exitCommandMode: OK "));
   return true;
 }
@@ -349,13 +436,17 @@ bool Radiocrafts::enterConfigMode() {
   if (!enterCommandMode()) return false;
   //  Confirm we are in COMMAND_MODE
   if (mode != COMMAND_MODE) {
-    log1(F(" - Warning: Radiocrafts.enterConfigMode did not detect expected Command Mode, may be in incorrect mode"));
+    error1(F(" - Warning: Radiocrafts.enterConfigMode did not detect expected Command Mode, may be in incorrect mode"));
   }
   //  Now switch from Command Mode to Config Mode.
   log1(F(" - Entering config mode from send mode..."));
   uint8_t markers = 0;
-  if (!sendBuffer(toHex(CMD_ENTER_CONFIG), COMMAND_TIMEOUT, 1, modeData, markers)) return false;
+  if (!sendBuffer(toHex(CMD_ENTER_CONFIG), COMMAND_TIMEOUT, 1, modeData, markers)) {
+    trace(TRACE_RADIOCRAFTS | TRACE_CONFIG_MODE, CMD_ENTER_CONFIG, 1, markers, 0);
+    return false;
+  }
   mode = CONFIG_MODE;
+  trace(TRACE_RADIOCRAFTS | TRACE_CONFIG_MODE, CMD_ENTER_CONFIG, 1, markers, 1);
   log1(F(" - Radiocrafts.enterConfigMode: OK "));
   return true;
 }
@@ -366,11 +457,15 @@ bool Radiocrafts::exitConfigMode() {
   log1(F(" - Exiting config mode to send mode..."));
   //  Confirm we are in CONFIG_MODE
   if (mode != CONFIG_MODE) {
-    log1(F(" - Warning: Radiocrafts.exitConfigMode did not detect expected Config Mode, may be in incorrect mode"));
+    error1(F(" - Warning: Radiocrafts.exitConfigMode did not detect expected Config Mode, may be in incorrect mode"));
   }
   uint8_t markers = 0;
-  if (!sendBuffer(toHex(CMD_EXIT_CONFIG), COMMAND_TIMEOUT, 1, modeData, markers)) return false;
+  if (!sendBuffer(toHex(CMD_EXIT_CONFIG), COMMAND_TIMEOUT, 1, modeData, markers)) {
+    trace(TRACE_RADIOCRAFTS | TRACE_COMMAND_MODE, (uint8_t) CMD_EXIT_CONFIG, 1, markers, 0);
+    return false;
+  }
   mode = COMMAND_MODE;
+  trace(TRACE_RADIOCRAFTS | TRACE_COMMAND_MODE, (uint8_t) CMD_EXIT_CONFIG, 1, markers, 1);
   log1(F(" - Radiocrafts.exitConfigMode: OK "));
   //  Then exit to Send Mode.
   exitCommandMode();
@@ -384,7 +479,7 @@ bool Radiocrafts::getID(String &id, String &pac) {
   //  Returns with 12 bytes: 4 bytes ID (LSB first) and 8 bytes PAC (MSB first).
   if (data.length() != 12 * 2) {
     if (useEmulator) { id = device; return true; }
-    log2(F(" - Radiocrafts.getID: Unknown response: "), data);
+    error2(F(" - Radiocrafts.getID: Unknown response: "), data);
     return false;
   }
   id = data.substring(6, 8) + data.substring(4, 6) + data.substring(2, 4) + data.substring(0, 2);
@@ -400,7 +495,7 @@ bool Radiocrafts::getTemperature(int &temperature) {
   if (!sendCommand(toHex('U'), 1, data, markers)) return false;
   if (data.length() != 2) {
     if (useEmulator) { temperature = 36; return true; }
-    log2(F(" - Radiocrafts.getTemperature: Unknown response: "), data);
+    error2(F(" - Radiocrafts.getTemperature: Unknown response: "), data);
     return false;
   }
   temperature = hexDigitToDecimal(data.charAt(0)) * 16 +
@@ -415,7 +510,7 @@ bool Radiocrafts::getVoltage(float &voltage) {
   if (!sendCommand(toHex('V'), 1, data, markers)) return false;
   if (data.length() != 2) {
     if (useEmulator) { voltage = 12.3; return true; }
-    log2(F(" - Radiocrafts.getVoltage: Unknown response: "), data);
+    error2(F(" - Radiocrafts.getVoltage: Unknown response: "), data);
     return false;
   }
   voltage = 0.030 * (hexDigitToDecimal(data.charAt(0)) * 16 +
@@ -426,14 +521,14 @@ bool Radiocrafts::getVoltage(float &voltage) {
 
 bool Radiocrafts::getHardware(String &hardware) {
   //  TODO
-  log1(F(" - Radiocrafts.getHardware: ERROR - Not implemented"));
+  error1(F(" - Radiocrafts.getHardware: ERROR - Not implemented"));
   hardware = "TODO";
   return true;
 }
 
 bool Radiocrafts::getFirmware(String &firmware) {
   //  TODO
-  log1(F(" - Radiocrafts.getFirmware: ERROR - Not implemented"));
+  error1(F(" - Radiocrafts.getFirmware: ERROR - Not implemented"));
   firmware = "TODO";
   return true;
 }
@@ -461,7 +556,7 @@ bool Radiocrafts::getPower(int &power) {
 
 bool Radiocrafts::setPower(int power) {
   //  TODO: Power value: 0...14
-  log1(F(" - Radiocrafts.receive: ERROR - Not implemented"));
+  error1(F(" - Radiocrafts.receive: ERROR - Not implemented"));
   return true;
 }
 
@@ -542,14 +637,44 @@ bool Radiocrafts::setFrequencyUS(String &result) {
 
 bool Radiocrafts::writeSettings(String &result) {
   //  TODO: Write settings to module's flash memory.
-  log1(F(" - Radiocrafts.writeSettings: ERROR - Not implemented"));
+  error1(F(" - Radiocrafts.writeSettings: ERROR - Not implemented"));
   return true;
 }
 
 bool Radiocrafts::reboot(String &result) {
-  //  TODO: Reboot the module.
-  log1(F(" - Radiocrafts.reboot: ERROR - Not implemented"));
-  return true;
+  //  TODO: Reboot the module.  Until then, report failure so that callers don't count on it,
+  //  and power cycle the module instead, e.g. with the Supervisor's powerPin.
+  error1(F(" - Radiocrafts.reboot: ERROR - Not implemented"));
+  return false;
+}
+
+SendError Radiocrafts::getLastError() {
+  //  Return the result of the last send to the module.
+  return lastError;
+}
+
+void Radiocrafts::getStats(TransceiverStats &stats0) {
+  //  Return the command and uplink stats since the last clearStats().
+#if SIGFOX_STATS
+  stats0 = *stats;
+#else  //  SIGFOX_STATS
+  memset(&stats0, 0, sizeof(stats0));
+#endif  //  SIGFOX_STATS
+}
+
+void Radiocrafts::recordUplink(bool status, unsigned long uplinkStart) {
+  //  Count the uplink and add its latency to the histogram.
+#if SIGFOX_STATS
+  if (status) stats->uplinks++; else stats->uplinkFailures++;
+  statsAddLatency(stats->uplinkLatency, millis() - uplinkStart);
+#endif  //  SIGFOX_STATS
+}
+
+void Radiocrafts::clearStats() {
+  //  Reset the stats->
+#if SIGFOX_STATS
+  memset(stats, 0, sizeof(*stats));
+#endif  //  SIGFOX_STATS
 }
 
 void Radiocrafts::echoOn() {
@@ -576,7 +701,7 @@ void Radiocrafts::echo(const String &msg) {
 
 bool Radiocrafts::receive(String &data) {
   //  TODO
-  log1(F(" - Radiocrafts.receive: ERROR - Not implemented"));
+  error1(F(" - Radiocrafts.receive: ERROR - Not implemented"));
   return true;
 }
 
@@ -667,39 +792,54 @@ String Radiocrafts::toHex(char *c, int length) {
 }
 
 uint8_t Radiocrafts::hexDigitToDecimal(char ch) {
-  //  Convert 0..9, a..f, A..F to decimal.
-  if (ch >= '0' && ch <= '9') return (uint8_t) ch - '0';
-  if (ch >= 'a' && ch <= 'z') return (uint8_t) ch - 'a' + 10;
-  if (ch >= 'A' && ch <= 'Z') return (uint8_t) ch - 'A' + 10;
-  log2(F(" - Radiocrafts.hexDigitToDecimal: Error: Invalid hex digit "), ch);
+  //  Convert 0..9, a..f, A..F to decimal.  Anything else is an error and gives 0.
+  const uint8_t value = hexDigitValue(ch);
+  if (value != HEX_DIGIT_INVALID) return value;
+  error2(F(" - Radiocrafts.hexDigitToDecimal: Error: Invalid hex digit "), ch);
   return 0;
 }
 
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
 //  Convert nibble to hex digit.
 static const char nibbleToHex[] = "0123456789abcdef";
 
+//  Size of the line formatted by logBuffer() before writing to the echo port.
+const uint8_t echoLineSize = 32;
+
+static void addEcho(Print *port, char *line, uint8_t &length, char ch) {
+  //  Add ch to the line, writing the line to the port when full.
+  if (length >= echoLineSize) { port->write(line, length); length = 0; }
+  line[length++] = ch;
+}
+
 void Radiocrafts::logBuffer(const __FlashStringHelper *prefix, const char *buffer,
                             uint8_t *markerPos, uint8_t markerCount) {
   //  Log the send/receive buffer for debugging.  markerPos is an array of positions in buffer
-  //  where the '>' marker was seen and removed.
+  //  where the '>' marker was seen and removed.  The line is formatted first and written in
+  //  as few calls as possible, so a buffered echo port isn't called for every byte.
+  char line[echoLineSize];
+  uint8_t length = 0;
   echoPort->print(prefix);
+  const int size = strlen(buffer);
   int m = 0, i = 0;
-  for (i = 0; i < strlen(buffer); i = i + 2) {
+  for (i = 0; i < size; i = i + 2) {
     if (m < markerCount && markerPos[m] == i) {
-      echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE / 16]);
-      echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE % 16]);
-      echoPort->write(' ');
+      addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE / 16]);
+      addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE % 16]);
+      addEcho(echoPort, line, length, ' ');
       m++;
     }
-    echoPort->write((uint8_t) buffer[i]);
-    echoPort->write((uint8_t) buffer[i + 1]);
-    echoPort->write(' ');
+    addEcho(echoPort, line, length, buffer[i]);
+    if (i + 1 < size) addEcho(echoPort, line, length, buffer[i + 1]);
+    addEcho(echoPort, line, length, ' ');
   }
   if (m < markerCount && markerPos[m] == i) {
-    echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE / 16]);
-    echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE % 16]);
-    echoPort->write(' ');
+    addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE / 16]);
+    addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE % 16]);
+    addEcho(echoPort, line, length, ' ');
     m++;
   }
-  echoPort->write('\n');
+  addEcho(echoPort, line, length, '\n');
+  echoPort->write(line, length);
 }
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
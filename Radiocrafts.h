@@ -44,7 +44,12 @@ public:
   void setEchoPort(Print *port);  //  Set the port for sending echo output.
   void echo(const String &msg);  //  Echo the debug message.
   bool isReady();
-  bool sendMessage(const String &payload);  //  Send the payload of hex digits to the network, max 12 bytes.
+  SendError getLastError();  //  Return the result of the last send to the module.
+  void getStats(TransceiverStats &stats);  //  Return the command and uplink stats since the last clearStats().
+  void clearStats();  //  Reset the stats.
+  //  Send the payload of hex digits to the network, max 12 bytes.  The module doesn't acknowledge
+  //  uplinks, so this returns true unless isReady() refused it, and UplinkQueue won't retry.
+  bool sendMessage(const String &payload);
   bool sendString(const String &str);  //  Sending a text string, max 12 characters allowed.
   bool receive(String &data);  //  Receive a message.
   bool enterCommandMode();  //  Enter Command Mode for sending module commands, not data.
@@ -65,7 +70,7 @@ public:
   //  Set the frequency for the SIGFOX module to US frequency (RCZ2).
   bool setFrequencyUS(String &result);
   bool writeSettings(String &result); //  Write frequency and other settings to flash memory of the module.
-  bool reboot(String &result);  //  Reboot the SIGFOX module.
+  bool reboot(String &result);  //  Not implemented yet, returns false.
   bool getTemperature(int &temperature);
   bool getID(String &id, String &pac);  //  Get the SIGFOX ID and PAC for the module.
   bool getVoltage(float &voltage);
@@ -84,6 +89,7 @@ public:
   String toHex(double d);
   String toHex(char c);
   String toHex(char *c, int length);
+  uint8_t hexDigitToDecimal(char ch);  //  Convert 0..9, a..f, A..F to decimal.
 
 private:
   bool sendCommand(const String &cmd, uint8_t expectedMarkers,
@@ -94,7 +100,7 @@ private:
   bool setFrequency(int zone, String &result);
   bool enterConfigMode();  //  Enter Config Mode for setting config.
   bool exitConfigMode();  //  Exit Config Mode and return to Send Mode so we can send data.
-  uint8_t hexDigitToDecimal(char ch);
+  void recordUplink(bool status, unsigned long uplinkStart);  //  Update the uplink stats.
   void logBuffer(const __FlashStringHelper *prefix, const char *buffer,
                  uint8_t markerPos[], uint8_t markerCount);
 
@@ -106,6 +112,10 @@ private:
   Print *echoPort;  //  Port for sending echo output.  Defaults to Serial.
   Print *lastEchoPort;  //  Last port used for sending echo output.
   unsigned long lastSend;  //  Timestamp of last send.
+  SendError lastError;  //  Result of the last send to the module.
+  //  Command and uplink stats, allocated only if the library itself is built with SIGFOX_STATS,
+  //  so that the layout doesn't depend on how the sketch sets it.
+  TransceiverStats *stats;
 };
 
 #endif // UNABIZ_ARDUINO_RADIOCRAFTS_H
@@ -6,8 +6,20 @@
 //  According to regulation, messages should be sent only every 10 minutes.
 const unsigned long SEND_DELAY = (unsigned long) 10 * 60 * 1000;
 const unsigned int MAX_BYTES_PER_MESSAGE = 12;  //  Only 12 bytes per message.
+const unsigned int BYTES_PER_DOWNLINK = 8;  //  Downlinks are always 8 bytes.
 const unsigned int COMMAND_TIMEOUT = 1000;  //  Wait up to 1 second for response from SIGFOX module.
 
+//  Log levels for the echo output of the library.  Change SIGFOX_LOG_LEVEL here, or define it
+//  with a compiler flag like -DSIGFOX_LOG_LEVEL=1.  Unlike echoOff(), which only discards the
+//  output, disabled levels generate no code and their arguments are never evaluated.
+#define SIGFOX_LOG_NONE 0  //  No echo output.
+#define SIGFOX_LOG_ERROR 1  //  Errors and warnings only.
+#define SIGFOX_LOG_INFO 2  //  Also commands, responses and results.
+#define SIGFOX_LOG_DEBUG 3  //  Also hex dump of every byte sent and received.
+#ifndef SIGFOX_LOG_LEVEL
+#define SIGFOX_LOG_LEVEL SIGFOX_LOG_DEBUG
+#endif  //  SIGFOX_LOG_LEVEL
+
 //  Define the countries that are supported.
 enum Country {
   COUNTRY_AU = 'A'+('U' << 8),  //  Australia: RCZ4
@@ -22,6 +34,18 @@ enum Country {
   COUNTRY_TW = 'T'+('W' << 8),  //  Taiwan: RCZ4
 };
 
+//  Result of the last send to the SIGFOX module.  Used to decide how to retry.
+enum SendError {
+  SEND_OK = 0,  //  Sent successfully.
+  SEND_NOT_READY = 1,  //  Not sent because the duty cycle doesn't allow it yet.
+  SEND_NO_RESPONSE = 2,  //  Module didn't respond before timeout, may be hung.
+  SEND_UNKNOWN_RESPONSE = 3,  //  Module responded with garbage, probably a UART glitch.
+  SEND_MODULE_ERROR = 4,  //  Module answered ERROR instead of OK, e.g. its own duty cycle refused the uplink.
+};
+
+//  Latency histograms and counters kept by the transceivers.
+#include "Stats.h"
+
 #ifdef BEAN_BEAN_BEAN_H
   //  Bean+ firmware 0.6.1 can't receive serial data properly. We provide
   //  an alternative class BeanSoftwareSerial to work around this.
@@ -38,16 +62,62 @@ enum Country {
 //  Send structured messages to SIGFOX cloud.
 #include "Message.h"
 
+//  Queue messages for sending to SIGFOX.
+#include "Uplink.h"
+
+//  Pack payloads as described by the Custom Payload Config of the callback.
+#include "PayloadEncoder.h"
+
+//  Run sensor sampling and sending as cooperative tasks instead of blocking.
+#include "Scheduler.h"
+
+//  Decide when sensor readings should be sent, e.g. on threshold crossings.
+#include "Trigger.h"
+
+//  Put the Arduino to sleep between messages.
+#include "Power.h"
+
+//  Recover from a hung module in unattended deployments.
+#include "Supervisor.h"
+
+//  Change settings by downlink without reflashing.
+#include "Config.h"
+
+//  Binary trace of transceiver operations for diagnostics in the field.
+#include "Trace.h"
+
+//  Heap and stack instrumentation for debug builds.
+#include "Memory.h"
+
+//  Buffered echo output that drops debug output instead of stalling the transceiver.
+#include "Echo.h"
+
+//  Byte-level capture of the traffic with the module, for replay on the host.
+#include "Capture.h"
+
 //  Define aliases for each UnaShield and the transceiver it uses.
 #define UnaShieldV1 Radiocrafts
 #define UnaShieldV2S Wisol
 
 //  Drop all data passed to this port.  Used to suppress echo output.
 class NullPort: public Print {
-  virtual size_t write(uint8_t) {}
+  virtual size_t write(uint8_t) { return 1; }
 };
 
-//  Call this function if we need to stop.  This informs the emulator to stop listening.
+//  Value 0..15 of the hex digit 0..9, a..f or A..F.  Any other char gives HEX_DIGIT_INVALID,
+//  so that payloads, responses and downlinks with bad digits can be rejected.
+const uint8_t HEX_DIGIT_INVALID = 0xff;
+inline uint8_t hexDigitValue(char ch) {
+  if (ch >= '0' && ch <= '9') return (uint8_t) ch - '0';
+  if (ch >= 'a' && ch <= 'f') return (uint8_t) ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F') return (uint8_t) ch - 'A' + 10;
+  return HEX_DIGIT_INVALID;
+}
+
+//  Call this function if we can't continue, e.g. the module didn't start.  Prints the message
+//  for a minute, then resets the MCU through the watchdog to start again.
 void stop(const String msg);
+//  Call this function when the sketch is done.  Prints the message and powers down for good.
+void halt(const String msg);
 
 #endif  //  UNABIZ_ARDUINO_SIGFOX_H
@@ -0,0 +1,192 @@
+//  Cooperative scheduler for sampling sensors and sending messages without blocking.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+static Scheduler *backgroundScheduler = 0;  //  Scheduler passed to begin(), run by schedulerYield().
+
+Scheduler::Scheduler() {
+  //  Start with no tasks.
+  for (uint8_t i = 0; i < SIGFOX_SCHEDULER_TASKS; i++) {
+    tasks[i].function = 0;
+    tasks[i].flags = 0;
+  }
+  for (uint8_t i = 0; i < SCHEDULER_SLOTS; i++) slots[i] = NO_TASK;
+  cursor = millis() & ~((1UL << SCHEDULER_SLOT_SHIFT) - 1);
+  running = NO_TASK;
+  yielding = false;
+  maxLateness = 0;
+}
+
+int8_t Scheduler::add(TaskFunction function, void *context) {
+  //  Take the first free entry.
+  for (uint8_t i = 0; i < SIGFOX_SCHEDULER_TASKS; i++) {
+    if (tasks[i].function) continue;
+    tasks[i].function = function;
+    tasks[i].context = context;
+    tasks[i].period = 0;
+    tasks[i].flags = 0;
+    return i;
+  }
+  return NO_TASK;
+}
+
+void Scheduler::every(int8_t task, unsigned long period, unsigned long delay) {
+  //  Run the task every period ms, first after delay ms.
+  if (task < 0 || task >= SIGFOX_SCHEDULER_TASKS || !tasks[task].function) return;
+  unlink(task);
+  tasks[task].period = period;
+  tasks[task].deadline = millis() + delay;
+  link(task);
+}
+
+void Scheduler::after(int8_t task, unsigned long delay) {
+  //  Run the task once, delay ms from now.  A task can call this for itself to wait
+  //  without blocking, e.g. for a sensor to finish measuring.
+  every(task, 0, delay);
+}
+
+void Scheduler::cancel(int8_t task) {
+  if (task < 0 || task >= SIGFOX_SCHEDULER_TASKS) return;
+  unlink(task);
+}
+
+void Scheduler::remove(int8_t task) {
+  if (task < 0 || task >= SIGFOX_SCHEDULER_TASKS) return;
+  unlink(task);
+  tasks[task].function = 0;
+}
+
+void Scheduler::setBackground(int8_t task, bool background) {
+  if (task < 0 || task >= SIGFOX_SCHEDULER_TASKS) return;
+  if (background) tasks[task].flags |= SCHEDULER_BACKGROUND;
+  else tasks[task].flags &= ~SCHEDULER_BACKGROUND;
+}
+
+void Scheduler::begin() {
+  //  Run the background tasks from schedulerYield().
+  backgroundScheduler = this;
+}
+
+bool Scheduler::run() {
+  //  Run each task that is due once.
+  return runDue(false);
+}
+
+int8_t Scheduler::current() { return running; }
+
+bool Scheduler::isScheduled(int8_t task) {
+  return task >= 0 && task < SIGFOX_SCHEDULER_TASKS && (tasks[task].flags & SCHEDULER_SCHEDULED);
+}
+
+unsigned long Scheduler::nextRunTime() {
+  //  millis() when the earliest task will run, i.e. just after its deadline.  Tasks that
+  //  are already due give now.
+  const unsigned long now = millis();
+  unsigned long earliest = now + SCHEDULER_IDLE_TIME;
+  for (uint8_t i = 0; i < SIGFOX_SCHEDULER_TASKS; i++) {
+    if (!(tasks[i].flags & SCHEDULER_SCHEDULED)) continue;
+    if ((long) (tasks[i].deadline - now) < 0) return now;
+    if ((long) (tasks[i].deadline + 1 - earliest) < 0) earliest = tasks[i].deadline + 1;
+  }
+  return earliest;
+}
+
+unsigned long Scheduler::getMaxLateness() { return maxLateness; }
+
+void Scheduler::clearStats() { maxLateness = 0; }
+
+bool Scheduler::runDue(bool backgroundOnly) {
+  //  Visit the slots of the time since the last pass, up to a full turn of the wheel, and
+  //  run the tasks in them whose deadline is before the pass's time, earliest first.  A task
+  //  rescheduled during the pass, by its period or by after() or every() from a task, gets a
+  //  deadline at or after the pass's time, so each runs at most once per pass.  Times are
+  //  compared as differences, so millis() may wrap around.
+  const unsigned long now = millis();
+  const unsigned long slotStart = now & ~((1UL << SCHEDULER_SLOT_SHIFT) - 1);
+  const unsigned long start = (long) (slotStart - cursor) < 0 ? slotStart : cursor;
+  const unsigned long ticks = (slotStart - start) >> SCHEDULER_SLOT_SHIFT;
+  const uint8_t visits = ticks < SCHEDULER_SLOTS ? ticks + 1 : SCHEDULER_SLOTS;
+  bool ran = false;
+  for (uint8_t v = 0; v < visits; v++) {
+    const uint8_t slot = ((start >> SCHEDULER_SLOT_SHIFT) + v) & (SCHEDULER_SLOTS - 1);
+    for (;;) {
+      const int8_t task = findDue(slot, now, backgroundOnly);
+      if (task == NO_TASK) break;
+      runTask(task, now);
+      ran = true;
+    }
+  }
+  //  Background passes skip the other tasks, so they leave the slots to be visited again.
+  if (!backgroundOnly && (long) (slotStart - cursor) > 0) cursor = slotStart;
+  return ran;
+}
+
+int8_t Scheduler::findDue(uint8_t slot, unsigned long now, bool backgroundOnly) {
+  //  Due task of the slot with the earliest deadline, or NO_TASK.  Deadlines at now may
+  //  have been set during this pass, so they wait for the next one.
+  int8_t earliest = NO_TASK;
+  for (int8_t i = slots[slot]; i != NO_TASK; i = tasks[i].next) {
+    const SchedulerTask &task = tasks[i];
+    if ((long) (task.deadline - now) >= 0 || (task.flags & SCHEDULER_RUNNING)) continue;
+    if (backgroundOnly && !(task.flags & SCHEDULER_BACKGROUND)) continue;
+    if (earliest == NO_TASK || (long) (task.deadline - tasks[earliest].deadline) < 0) earliest = i;
+  }
+  return earliest;
+}
+
+void Scheduler::runTask(int8_t task, unsigned long now) {
+  //  Reschedule before running, so that the task may call after() or cancel() for itself.
+  SchedulerTask &entry = tasks[task];
+  const unsigned long lateness = millis() - entry.deadline;
+  if (lateness > maxLateness) maxLateness = lateness;
+  unlink(task);
+  if (entry.period > 0) {
+    //  Keep to the period, but skip the runs that were missed.
+    entry.deadline += entry.period;
+    if ((long) (entry.deadline - now) <= 0) entry.deadline = now + entry.period;
+    link(task);
+  }
+  const int8_t previous = running;
+  running = task;
+  entry.flags |= SCHEDULER_RUNNING;
+  entry.function(entry.context);
+  entry.flags &= ~SCHEDULER_RUNNING;
+  running = previous;
+}
+
+void Scheduler::link(int8_t task) {
+  //  Add the task to the slot of its deadline.  If it is already due, add it to the slot
+  //  that the next pass visits first.
+  SchedulerTask &entry = tasks[task];
+  const unsigned long time = (long) (entry.deadline - cursor) < 0 ? cursor : entry.deadline;
+  entry.slot = (time >> SCHEDULER_SLOT_SHIFT) & (SCHEDULER_SLOTS - 1);
+  entry.next = slots[entry.slot];
+  slots[entry.slot] = task;
+  entry.flags |= SCHEDULER_SCHEDULED;
+}
+
+void Scheduler::unlink(int8_t task) {
+  //  Remove the task from its slot, if it is in one.
+  SchedulerTask &entry = tasks[task];
+  if (!(entry.flags & SCHEDULER_SCHEDULED)) return;
+  int8_t *link = &slots[entry.slot];
+  while (*link != task) link = &tasks[*link].next;
+  *link = entry.next;
+  entry.flags &= ~SCHEDULER_SCHEDULED;
+}
+
+void schedulerYield() {
+  //  Run the due background tasks, unless we are already doing so.
+  Scheduler *scheduler = backgroundScheduler;
+  if (!scheduler || scheduler->yielding) return;
+  scheduler->yielding = true;
+  scheduler->runDue(true);
+  scheduler->yielding = false;
+}
@@ -0,0 +1,95 @@
+//  Cooperative scheduler for sampling sensors and sending messages without blocking.
+//  Tasks are functions that do a short step and return, and are run again at their next
+//  deadline.  Deadlines are kept in a timer wheel, so each pass of run() only looks at the
+//  tasks in the slots that the clock has passed since the last pass:
+//    static Scheduler scheduler;
+//    void sampleLight(void *) { ... }
+//    void setup() { scheduler.every(scheduler.add(sampleLight), 500); }
+//    void loop() { scheduler.run(); }
+//  A task that has to wait, e.g. for a sensor to measure, returns and asks to be run again
+//  with scheduler.after(scheduler.current(), ms) instead of calling delay().
+#ifndef UNABIZ_ARDUINO_SCHEDULER_H
+#define UNABIZ_ARDUINO_SCHEDULER_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  Max number of tasks, 15 bytes of RAM each on the AVR.  Change with a compiler flag like
+//  -DSIGFOX_SCHEDULER_TASKS=4.
+#ifndef SIGFOX_SCHEDULER_TASKS
+#define SIGFOX_SCHEDULER_TASKS 8
+#endif  //  SIGFOX_SCHEDULER_TASKS
+
+const uint8_t SCHEDULER_SLOTS = 16;  //  Slots in the timer wheel, a power of 2.
+const uint8_t SCHEDULER_SLOT_SHIFT = 4;  //  Each slot holds the deadlines of 2^4 = 16 ms, so the wheel turns every 256 ms.
+const unsigned long SCHEDULER_IDLE_TIME = 60000;  //  nextRunTime() is this far ahead (ms) if no task is scheduled.
+const int8_t NO_TASK = -1;
+
+//  Flags of a task.
+const uint8_t SCHEDULER_SCHEDULED = 1;  //  Linked into a slot of the wheel, waiting for its deadline.
+const uint8_t SCHEDULER_RUNNING = 2;  //  Running now, so not run again by a nested pass.
+const uint8_t SCHEDULER_BACKGROUND = 4;  //  May run from schedulerYield().
+
+typedef void (*TaskFunction)(void *context);
+
+//  One task.  Tasks whose deadlines fall in the same slot are linked through next.
+struct SchedulerTask {
+  TaskFunction function;  //  0 if the entry is free.
+  void *context;  //  Passed to the function, e.g. the sensor object.
+  unsigned long deadline;  //  millis() when the task should run next.
+  unsigned long period;  //  Run again this long (ms) after each deadline, or 0 to run once.
+  int8_t next;  //  Next task in the same slot, or NO_TASK.
+  uint8_t slot;  //  Slot of the wheel that the task is linked into.
+  uint8_t flags;  //  SCHEDULER_SCHEDULED, SCHEDULER_RUNNING, SCHEDULER_BACKGROUND.
+};
+
+class Scheduler
+{
+public:
+  Scheduler();
+  //  Add a task and return its number, or NO_TASK if the table is full.  The task doesn't
+  //  run until every() or after() is called.
+  int8_t add(TaskFunction function, void *context = 0);
+  void every(int8_t task, unsigned long period, unsigned long delay = 0);  //  Run the task every period ms, first after delay ms.
+  void after(int8_t task, unsigned long delay);  //  Run the task once, delay ms from now.  Replaces the period.
+  void cancel(int8_t task);  //  Don't run the task until every() or after() is called again.
+  void remove(int8_t task);  //  Cancel the task and free its entry.
+  //  Allow the task to run while a transceiver waits for the module, from schedulerYield().
+  //  It must be short and must not use the transceiver or call listen() on a SoftwareSerial.
+  void setBackground(int8_t task, bool background);
+  void begin();  //  Run the background tasks of this scheduler from schedulerYield().
+  bool run();  //  Run each task that is due once.  Call from loop().  Returns true if any task ran.
+  int8_t current();  //  Task that is running, or NO_TASK.
+  bool isScheduled(int8_t task);  //  True if the task will run again.
+  unsigned long nextRunTime();  //  millis() of the earliest deadline, e.g. for powerDownUntil().
+  unsigned long getMaxLateness();  //  Longest time (ms) a task has run after its deadline.
+  void clearStats();
+
+private:
+  friend void schedulerYield();
+  bool runDue(bool backgroundOnly);
+  int8_t findDue(uint8_t slot, unsigned long now, bool backgroundOnly);
+  void runTask(int8_t task, unsigned long now);
+  void link(int8_t task);
+  void unlink(int8_t task);
+  SchedulerTask tasks[SIGFOX_SCHEDULER_TASKS];
+  int8_t slots[SCHEDULER_SLOTS];  //  First task of each slot, or NO_TASK.
+  unsigned long cursor;  //  millis() at the start of the slot visited last.
+  int8_t running;  //  Task that is running, or NO_TASK.
+  bool yielding;  //  True while running background tasks from schedulerYield().
+  unsigned long maxLateness;
+};
+
+//  Run the due background tasks of the scheduler passed to begin().  Called by the transceivers
+//  while they wait for the module, so that sensors are sampled during the seconds a message
+//  takes to send.  Sketches may call it from their own waits, or define
+//    void yield() { schedulerYield(); }
+//  so that delay() runs the background tasks too.  Cheap when no scheduler is begun.
+void schedulerYield();
+
+#endif // UNABIZ_ARDUINO_SCHEDULER_H
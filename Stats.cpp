@@ -0,0 +1,84 @@
+//  Latency histograms and counters for transceiver commands and uplinks, for tuning battery life.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+uint8_t statsBucket(unsigned long latency) {
+  //  Return the histogram bucket for the latency (ms).
+  uint8_t bucket = 0;
+  unsigned long limit = STATS_FIRST_BUCKET;
+  while (bucket < STATS_BUCKETS - 1 && latency >= limit) {
+    bucket++;
+    limit = limit << 1;
+  }
+  return bucket;
+}
+
+void statsAddLatency(LatencyHistogram &histogram, unsigned long latency) {
+  //  Add a sample.  Counts stop at the maximum instead of wrapping around.
+  uint16_t &count = histogram.counts[statsBucket(latency)];
+  if (count < 0xffff) count++;
+  histogram.total += latency;
+  const uint16_t capped = latency > 0xffff ? 0xffff : latency;
+  if (capped > histogram.max) histogram.max = capped;
+}
+
+void statsAddCommand(TransceiverStats &stats, uint8_t command, unsigned long latency) {
+  //  Add the latency to the histogram for the command, if there is room for it.
+  for (uint8_t i = 0; i < stats.commandCount; i++) {
+    if (stats.perCommand[i].command != command) continue;
+    statsAddLatency(stats.perCommand[i].latency, latency);
+    return;
+  }
+  if (stats.commandCount >= STATS_COMMANDS) return;
+  CommandStats &entry = stats.perCommand[stats.commandCount++];
+  entry.command = command;
+  statsAddLatency(entry.latency, latency);
+}
+
+static void printHistogram(Print &port, const LatencyHistogram &histogram) {
+  //  Print the bucket counts, then the mean and max.
+  uint32_t samples = 0;
+  for (uint8_t i = 0; i < STATS_BUCKETS; i++) {
+    port.print(histogram.counts[i]);
+    port.print(i + 1 < STATS_BUCKETS ? '/' : ' ');
+    samples += histogram.counts[i];
+  }
+  port.print(F("mean="));
+  port.print(samples ? histogram.total / samples : 0);
+  port.print(F(" max="));
+  port.println(histogram.max);
+}
+
+void printStats(Print &port, const TransceiverStats &stats) {
+  //  Print the stats as text.  Histograms are printed as counts for
+  //  < 128 ms / < 256 ms / ... / >= 8 s.
+  port.print(F("commands=")); port.print(stats.commands);
+  port.print(F(" ok=")); port.print(stats.successes);
+  port.print(F(" timeouts=")); port.print(stats.timeouts);
+  port.print(F(" unknown=")); port.print(stats.unknownResponses);
+  port.print(F(" retries=")); port.println(stats.retries);
+  port.print(F("bytesOut=")); port.print(stats.bytesOut);
+  port.print(F(" bytesIn=")); port.println(stats.bytesIn);
+  port.print(F("settle=")); port.print(stats.settleTime);
+  port.print(F(" tx=")); port.print(stats.txTime);
+  port.print(F(" wait=")); port.println(stats.waitTime);
+  port.print(F("uplinks=")); port.print(stats.uplinks);
+  port.print(F(" failed=")); port.print(stats.uplinkFailures);
+  port.print(F(" downlinks=")); port.print(stats.downlinks);
+  port.print(F(" latency="));
+  printHistogram(port, stats.uplinkLatency);
+  for (uint8_t i = 0; i < stats.commandCount; i++) {
+    port.print(F("command 0x"));
+    if (stats.perCommand[i].command < 0x10) port.print('0');
+    port.print(stats.perCommand[i].command, HEX);
+    port.print(F(" latency="));
+    printHistogram(port, stats.perCommand[i].latency);
+  }
+}
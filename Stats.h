@@ -0,0 +1,72 @@
+//  Latency histograms and counters for transceiver commands and uplinks, for tuning battery life.
+#ifndef UNABIZ_ARDUINO_STATS_H
+#define UNABIZ_ARDUINO_STATS_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  Stats take about 200 bytes of RAM per transceiver, a tenth of the Uno's, so they are off
+//  unless enabled with a compiler flag like -DSIGFOX_STATS=1.  The flag must apply to the
+//  library too: the transceiver allocates them in its constructor only if the library is
+//  built with it, and a #define in the sketch alone leaves them disabled.
+#ifndef SIGFOX_STATS
+#define SIGFOX_STATS 0
+#endif  //  SIGFOX_STATS
+
+//  Histogram buckets double in width: bucket 0 is under 128 ms, bucket 1 under 256 ms, ...
+//  and the last bucket is 8 seconds or more.
+const uint8_t STATS_BUCKETS = 8;
+const unsigned long STATS_FIRST_BUCKET = 128;  //  Upper limit (ms) of bucket 0.
+//  Number of distinct commands with their own histogram.  Further commands are
+//  only counted in the totals.
+const uint8_t STATS_COMMANDS = 6;
+
+//  Log-bucketed latency histogram.
+struct LatencyHistogram {
+  uint16_t counts[STATS_BUCKETS];  //  Number of samples in each bucket.
+  uint32_t total;  //  Sum of all samples (ms), for the mean.
+  uint16_t max;  //  Longest sample (ms), capped at 65535.
+};
+
+//  Latency of one command, from first byte sent to final marker received.
+struct CommandStats {
+  uint8_t command;  //  TraceCommand for Wisol, or the Radiocrafts command byte.
+  LatencyHistogram latency;
+};
+
+struct TransceiverStats {
+  uint16_t commands;  //  Number of commands sent to the module, including uplinks.
+  uint16_t successes;  //  Commands that got the expected response.
+  uint16_t timeouts;  //  Commands with no response.
+  uint16_t unknownResponses;  //  Commands with an incomplete or garbled response.
+  uint16_t retries;  //  Commands repeated because the module didn't respond as expected.
+  uint32_t bytesOut;  //  Bytes sent to the module.
+  uint32_t bytesIn;  //  Bytes received from the module, excluding markers.
+  //  Total time (ms) spent in each phase of sending a command.
+  uint32_t settleTime;  //  Waiting for the serial port to settle before sending.
+  uint32_t txTime;  //  Sending the bytes, paced because SoftwareSerial has no FIFO.
+  uint32_t waitTime;  //  Waiting for the module to respond, including the radio transmission.
+  uint16_t uplinks;  //  Messages sent successfully.
+  uint16_t uplinkFailures;  //  Messages that failed after the module was ready.
+  uint16_t downlinks;  //  Messages sent with a downlink request.
+  //  Part of waitTime spent waiting for the module to send a message, i.e. transmitting.
+  //  Not measured for Radiocrafts, which transmits after returning.
+  uint32_t uplinkWaitTime;
+  uint32_t downlinkWaitTime;  //  Part of waitTime spent sending a message and receiving the downlink.
+  LatencyHistogram uplinkLatency;  //  Full uplink including setup commands.
+  uint8_t commandCount;  //  Number of perCommand entries used.
+  CommandStats perCommand[STATS_COMMANDS];
+};
+
+uint8_t statsBucket(unsigned long latency);  //  Return the histogram bucket for the latency (ms).
+void statsAddLatency(LatencyHistogram &histogram, unsigned long latency);  //  Add a sample.
+//  Add the latency to the histogram for the command, if there is room for it.
+void statsAddCommand(TransceiverStats &stats, uint8_t command, unsigned long latency);
+void printStats(Print &port, const TransceiverStats &stats);  //  Print the stats as text.
+
+#endif // UNABIZ_ARDUINO_STATS_H
@@ -0,0 +1,213 @@
+//  Supervise the SIGFOX module and recover from hangs in unattended deployments.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+#ifdef __AVR__
+#include <EEPROM.h>
+//  Not cleared on reset, so we can tell after restarting whether the watchdog fired during an operation.
+#define NOINIT __attribute__ ((section (".noinit")))
+#else  //  __AVR__
+#define NOINIT
+#endif  //  __AVR__
+
+const uint16_t SUPERVISOR_MAGIC = 0x5346;  //  "SF": marks valid counters and pending causes.
+
+static uint16_t pendingMagic NOINIT;  //  SUPERVISOR_MAGIC if pendingCause is valid.
+static uint8_t pendingCause NOINIT;  //  Cause to record if the MCU restarts now.
+
+Supervisor::Supervisor(Radiocrafts &transceiver, int8_t powerPin0) {
+  //  Supervise Radiocrafts.
+  radiocrafts = &transceiver;
+  init(powerPin0);
+}
+
+Supervisor::Supervisor(Wisol &transceiver, int8_t powerPin0) {
+  //  Supervise Wisol.
+  wisol = &transceiver;
+  init(powerPin0);
+}
+
+void Supervisor::init(int8_t powerPin0) {
+  powerPin = powerPin0;
+  timeouts = 0;
+  level = 0;
+  startCause = CAUSE_NONE;
+  memset(&stats, 0, sizeof(stats));
+}
+
+void Supervisor::begin() {
+  //  Record why the MCU started.  Call at the start of setup(), because the
+  //  watchdog stays enabled after a watchdog reset.
+  watchdogDisarm();
+  if (powerPin >= 0) {
+    pinMode(powerPin, OUTPUT);
+    digitalWrite(powerPin, HIGH);  //  Power on the module.
+  }
+  loadStats();
+  stats.boots++;
+  startCause = CAUSE_NONE;
+  if (pendingMagic == SUPERVISOR_MAGIC) startCause = (RecoveryCause) pendingCause;
+  pendingMagic = 0;
+  //  MCU resets are counted before resetting.  Watchdog resets can only be counted now.
+  if (startCause == CAUSE_WATCHDOG) record(CAUSE_WATCHDOG);
+  else saveStats();
+}
+
+void Supervisor::beginModule() {
+  //  Start the transceiver under the watchdog.  If it fails, take the next recovery step
+  //  and try again, until escalate() resets the MCU.
+  for (;;) {
+    arm();
+    bool status = false;
+    if (wisol) status = wisol->begin();
+    else if (radiocrafts) status = radiocrafts->begin();
+    watchdogDisarm();
+    pendingMagic = 0;
+    if (status) { timeouts = 0; level = 0; return; }
+    escalate(false);
+  }
+}
+
+void Supervisor::arm() {
+  //  Arm the watchdog before a transceiver operation.  Allow for a few commands
+  //  that each wait for the full timeout.
+  const unsigned long timeout = wisol ? WISOL_COMMAND_TIMEOUT : COMMAND_TIMEOUT;
+  pendingCause = CAUSE_WATCHDOG;
+  pendingMagic = SUPERVISOR_MAGIC;
+  watchdogArm(3 * timeout + SUPERVISOR_MARGIN);
+}
+
+void Supervisor::disarm() {
+  //  Disarm the watchdog and check how the operation went.
+  watchdogDisarm();
+  pendingMagic = 0;
+  switch (getLastError()) {
+    case SEND_OK:
+      timeouts = 0; level = 0; break;
+    case SEND_NO_RESPONSE:
+      //  Module may be hung.  Escalate if it keeps happening.
+      if (++timeouts >= SUPERVISOR_TIMEOUTS) escalate();
+      break;
+    case SEND_UNKNOWN_RESPONSE:
+      //  Module is alive but the UART glitched.
+      timeouts = 0; break;
+    case SEND_MODULE_ERROR:
+      //  Module is alive but refused the command.
+      timeouts = 0; break;
+    default:
+      break;
+  }
+}
+
+bool Supervisor::sendMessage(const String &payload) {
+  //  Send the payload under the watchdog.
+  arm();
+  bool status = false;
+  if (wisol) status = wisol->sendMessage(payload);
+  else if (radiocrafts) status = radiocrafts->sendMessage(payload);
+  disarm();
+  return status;
+}
+
+bool Supervisor::sendNext(UplinkQueue &queue) {
+  //  Send the next queued payload under the watchdog.  The queue sees the watchdog armed
+  //  and leaves rebooting the module to escalate().
+  if (!queue.isDue()) return false;
+  arm();
+  const bool status = queue.sendNext();
+  disarm();
+  return status;
+}
+
+void Supervisor::escalate(bool restartModule) {
+  //  Try the next recovery step: reset the module, then power cycle it, then reset the MCU.
+  //  Radiocrafts can't be reset by command yet, so it starts with the power cycle.
+  //  restartModule is false if the caller starts the module itself.
+  String result;
+  timeouts = 0;
+  if (level == 0 && wisol) {
+    level = 1;
+    record(CAUSE_MODULE_RESET);
+    wisol->reboot(result);
+    return;
+  }
+  if (level <= 1 && powerPin >= 0) {
+    level = 2;
+    record(CAUSE_POWER_CYCLE);
+    digitalWrite(powerPin, LOW);
+    delay(MODULE_POWER_OFF_TIME);
+    digitalWrite(powerPin, HIGH);
+    if (!restartModule) return;
+    if (wisol) wisol->begin();
+    else if (radiocrafts) radiocrafts->begin();
+    return;
+  }
+  //  Nothing else worked.  Restart everything.
+  record(CAUSE_MCU_RESET);
+  pendingCause = CAUSE_MCU_RESET;
+  pendingMagic = SUPERVISOR_MAGIC;
+  watchdogReset();
+}
+
+void Supervisor::record(RecoveryCause cause) {
+  //  Count the recovery and save the counters.
+  switch (cause) {
+    case CAUSE_MODULE_RESET: stats.moduleResets++; break;
+    case CAUSE_POWER_CYCLE: stats.powerCycles++; break;
+    case CAUSE_MCU_RESET: stats.mcuResets++; break;
+    case CAUSE_WATCHDOG: stats.watchdogResets++; break;
+    default: break;
+  }
+  stats.lastCause = cause;
+  saveStats();
+}
+
+RecoveryCause Supervisor::getStartCause() {
+  //  Return why the MCU started.
+  return startCause;
+}
+
+void Supervisor::getStats(SupervisorStats &stats0) {
+  //  Return the recovery counters.
+  stats0 = stats;
+}
+
+void Supervisor::clearStats() {
+  //  Reset the recovery counters.
+  memset(&stats, 0, sizeof(stats));
+  saveStats();
+}
+
+void Supervisor::loadStats() {
+  //  Load the counters from EEPROM.  Start from zero if never saved.
+#ifdef __AVR__
+  uint16_t magic = 0;
+  EEPROM.get(SUPERVISOR_EEPROM_ADDRESS, magic);
+  if (magic == SUPERVISOR_MAGIC) {
+    EEPROM.get(SUPERVISOR_EEPROM_ADDRESS + sizeof(magic), stats);
+    return;
+  }
+#endif  //  __AVR__
+  memset(&stats, 0, sizeof(stats));
+}
+
+void Supervisor::saveStats() {
+  //  Save the counters to EEPROM.  Only changed bytes are written.
+#ifdef __AVR__
+  EEPROM.put(SUPERVISOR_EEPROM_ADDRESS, SUPERVISOR_MAGIC);
+  EEPROM.put(SUPERVISOR_EEPROM_ADDRESS + sizeof(SUPERVISOR_MAGIC), stats);
+#endif  //  __AVR__
+}
+
+SendError Supervisor::getLastError() {
+  if (wisol) return wisol->getLastError();
+  else if (radiocrafts) return radiocrafts->getLastError();
+  return SEND_OK;
+}
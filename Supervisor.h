@@ -0,0 +1,70 @@
+//  Supervise the SIGFOX module and recover from hangs in unattended deployments.
+#ifndef UNABIZ_ARDUINO_SUPERVISOR_H
+#define UNABIZ_ARDUINO_SUPERVISOR_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+const int SUPERVISOR_EEPROM_ADDRESS = 0;  //  EEPROM address of the recovery counters.
+const uint8_t SUPERVISOR_TIMEOUTS = 2;  //  Escalate after this many consecutive timeouts.
+const unsigned long SUPERVISOR_MARGIN = 10000;  //  Extra time (ms) allowed for each operation before the watchdog resets.
+const unsigned long MODULE_POWER_OFF_TIME = 1000;  //  Keep the module powered off this long (ms) when power cycling.
+
+//  Why the MCU or module was last restarted.
+enum RecoveryCause {
+  CAUSE_NONE = 0,
+  CAUSE_MODULE_RESET = 1,  //  Module was reset with AT$P=0.
+  CAUSE_POWER_CYCLE = 2,  //  Module power was switched off and on.
+  CAUSE_MCU_RESET = 3,  //  MCU was reset after the module stayed unresponsive.
+  CAUSE_WATCHDOG = 4,  //  Watchdog reset the MCU because an operation hung.
+};
+
+//  Recovery counters, kept in EEPROM so that failure rates can be measured across restarts.
+struct SupervisorStats {
+  uint16_t boots;  //  Number of times begin() was called, i.e. MCU starts.
+  uint16_t moduleResets;
+  uint16_t powerCycles;
+  uint16_t mcuResets;
+  uint16_t watchdogResets;
+  uint8_t lastCause;  //  RecoveryCause of the last recovery.
+};
+
+class Supervisor
+{
+public:
+  Supervisor(Radiocrafts &transceiver, int8_t powerPin = -1);  //  Supervise Radiocrafts.  powerPin switches the module power, -1 if none.
+  Supervisor(Wisol &transceiver, int8_t powerPin = -1);  //  Supervise Wisol.  powerPin switches the module power, -1 if none.
+  void begin();  //  Record why the MCU started.  Call at the start of setup().
+  //  Start the transceiver under the watchdog, recovering step by step until it starts.  The
+  //  last step resets the MCU, so this returns only once the module has started.
+  void beginModule();
+  bool sendMessage(const String &payload);  //  Send the payload under the watchdog.
+  bool sendNext(UplinkQueue &queue);  //  Send the next queued payload under the watchdog.
+  void arm();  //  Arm the watchdog before a transceiver operation.
+  void disarm();  //  Disarm the watchdog and escalate if the operation timed out.
+  RecoveryCause getStartCause();  //  Return why the MCU started: CAUSE_MCU_RESET, CAUSE_WATCHDOG or CAUSE_NONE.
+  void getStats(SupervisorStats &stats);  //  Return the recovery counters.
+  void clearStats();  //  Reset the recovery counters.
+
+private:
+  void init(int8_t powerPin);
+  void escalate(bool restartModule = true);
+  void record(RecoveryCause cause);
+  void loadStats();
+  void saveStats();
+  SendError getLastError();
+  int8_t powerPin;  //  Pin that switches the module power, or -1.
+  uint8_t timeouts;  //  Consecutive timeouts since the last recovery.
+  uint8_t level;  //  Next recovery step to try.
+  RecoveryCause startCause;
+  SupervisorStats stats;
+  Radiocrafts *radiocrafts = 0;  //  Reference to Radiocrafts transceiver being supervised.
+  Wisol *wisol = 0;  //  Reference to Wisol transceiver being supervised.
+};
+
+#endif // UNABIZ_ARDUINO_SUPERVISOR_H
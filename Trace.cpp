@@ -0,0 +1,89 @@
+//  Compact binary trace of transceiver operations, small and fast enough to leave on in the field.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+#if SIGFOX_TRACE_SIZE > 0
+static TraceRecord records[SIGFOX_TRACE_SIZE];  //  Ring buffer of records.
+static uint8_t head = 0;  //  Where the next record will be written.
+static uint8_t count = 0;  //  Number of records kept.
+
+void trace(uint8_t event, uint8_t command, uint8_t bytes, uint8_t markers, uint8_t result) {
+  //  Record an event, overwriting the oldest record if full.  No Strings, so this is cheap.
+  TraceRecord &record = records[head];
+  record.time = millis();
+  record.event = event;
+  record.command = command;
+  record.bytes = bytes;
+  record.markers = markers;
+  record.result = result;
+  if (++head >= SIGFOX_TRACE_SIZE) head = 0;
+  if (count < SIGFOX_TRACE_SIZE) count++;
+}
+#endif  //  SIGFOX_TRACE_SIZE > 0
+
+uint8_t traceCount() {
+  //  Return the number of records kept.
+#if SIGFOX_TRACE_SIZE > 0
+  return count;
+#else  //  SIGFOX_TRACE_SIZE > 0
+  return 0;
+#endif  //  SIGFOX_TRACE_SIZE > 0
+}
+
+bool traceGet(uint8_t index, TraceRecord &record) {
+  //  Return the record at index, 0 for the oldest.
+#if SIGFOX_TRACE_SIZE > 0
+  if (index >= count) return false;
+  uint16_t pos = (uint16_t) head + SIGFOX_TRACE_SIZE - count + index;
+  record = records[pos % SIGFOX_TRACE_SIZE];
+  return true;
+#else  //  SIGFOX_TRACE_SIZE > 0
+  return false;
+#endif  //  SIGFOX_TRACE_SIZE > 0
+}
+
+void traceClear() {
+  //  Discard all records.
+#if SIGFOX_TRACE_SIZE > 0
+  head = 0;
+  count = 0;
+#endif  //  SIGFOX_TRACE_SIZE > 0
+}
+
+static void printHex(Print &port, uint32_t value, uint8_t bytes) {
+  //  Print the value as little-endian hex, 2 digits per byte, so the dump doesn't depend on the MCU.
+  static const char hexDigits[] = "0123456789ABCDEF";
+  for (uint8_t i = 0; i < bytes; i++) {
+    const uint8_t b = (value >> (i * 8)) & 0xff;
+    port.write(hexDigits[b >> 4]);
+    port.write(hexDigits[b & 0x0f]);
+  }
+}
+
+void traceDump(Print &port) {
+  //  Print the records as hex, one per line.  The header has the format version, the
+  //  number of records and the current time, so the decoder can show how long ago each event was.
+  //  Hex lines survive the Serial Monitor and can be copied into a file for the decoder.
+  port.print(F("SIGFOX_TRACE "));
+  printHex(port, TRACE_VERSION, 1); port.write(' ');
+  printHex(port, traceCount(), 1); port.write(' ');
+  printHex(port, millis(), 4); port.println();
+  TraceRecord record;
+  for (uint8_t i = 0; traceGet(i, record); i++) {
+    printHex(port, record.time, 4);
+    printHex(port, record.event, 1);
+    printHex(port, record.command, 1);
+    printHex(port, record.bytes, 1);
+    printHex(port, record.markers, 1);
+    printHex(port, record.result, 1);
+    port.println();
+  }
+  port.println(F("SIGFOX_TRACE_END"));
+}
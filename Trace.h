@@ -0,0 +1,74 @@
+//  Compact binary trace of transceiver operations, small and fast enough to leave on in the field.
+//  Dump it over Serial with traceDump() and decode with extras/trace/decode_trace.cpp.
+#ifndef UNABIZ_ARDUINO_TRACE_H
+#define UNABIZ_ARDUINO_TRACE_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+//  Number of records kept, 9 bytes each.  Older records are overwritten.  0 removes tracing
+//  completely, which is the default to save RAM.  Enable with a compiler flag like
+//  -DSIGFOX_TRACE_SIZE=16.
+#ifndef SIGFOX_TRACE_SIZE
+#define SIGFOX_TRACE_SIZE 0
+#endif  //  SIGFOX_TRACE_SIZE
+
+const uint8_t TRACE_VERSION = 1;  //  Dump format version, checked by the decoder.
+
+//  What happened.  TRACE_RADIOCRAFTS is or-ed into events from the Radiocrafts module.
+enum TraceEvent {
+  TRACE_SEND_BUFFER = 1,  //  Command sent to the module.  result is the SendError.
+  TRACE_SEND_MESSAGE = 2,  //  Message sent to the network.  result is the SendError.
+  TRACE_SLEEP = 3,  //  Module put to sleep.  result is 1 if OK.
+  TRACE_WAKE = 4,  //  Module woken up.  result is 1 if OK.
+  TRACE_SEND_MODE = 5,  //  Radiocrafts switched to Send Mode.  result is 1 if OK.
+  TRACE_COMMAND_MODE = 6,  //  Radiocrafts switched to Command Mode.  result is 1 if OK.
+  TRACE_CONFIG_MODE = 7,  //  Radiocrafts switched to Config Mode.  result is 1 if OK.
+  TRACE_BEGIN = 8,  //  Module initialised.  result is 1 if OK.
+  TRACE_RADIOCRAFTS = 0x80,
+};
+
+//  Command ids for Wisol AT commands.  For Radiocrafts the id is the first byte sent.
+enum TraceCommand {
+  TRACE_CMD_OTHER = 0,
+  TRACE_CMD_SEND_MESSAGE = 1,  //  AT$SF=
+  TRACE_CMD_OUTPUT_POWER = 2,  //  ATS302=
+  TRACE_CMD_PRESEND = 3,  //  AT$GI?
+  TRACE_CMD_PRESEND2 = 4,  //  AT$RC
+  TRACE_CMD_GET_ID = 5,  //  AT$I=10
+  TRACE_CMD_GET_PAC = 6,  //  AT$I=11
+  TRACE_CMD_GET_TEMPERATURE = 7,  //  AT$T?
+  TRACE_CMD_GET_VOLTAGE = 8,  //  AT$V?
+  TRACE_CMD_RESET = 9,  //  AT$P=0
+  TRACE_CMD_SLEEP = 10,  //  AT$P=1
+  TRACE_CMD_EMULATOR = 11,  //  ATS410=
+  TRACE_CMD_WAKEUP = 12,  //  AT
+};
+
+//  One trace record.  Fields are single bytes after the timestamp, so there is no padding on AVR.
+struct TraceRecord {
+  uint32_t time;  //  millis() when the event ended.
+  uint8_t event;  //  TraceEvent.
+  uint8_t command;  //  TraceCommand, or the Radiocrafts command byte.
+  uint8_t bytes;  //  Number of bytes sent.
+  uint8_t markers;  //  Number of end-of-response markers received.
+  uint8_t result;  //  SendError, or 1 for OK and 0 for failed.
+};
+
+#if SIGFOX_TRACE_SIZE > 0
+void trace(uint8_t event, uint8_t command, uint8_t bytes, uint8_t markers, uint8_t result);  //  Record an event.
+#else  //  SIGFOX_TRACE_SIZE > 0
+inline void trace(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) {}
+#endif  //  SIGFOX_TRACE_SIZE > 0
+uint8_t traceCount();  //  Return the number of records kept.
+bool traceGet(uint8_t index, TraceRecord &record);  //  Return the record at index, 0 for the oldest.
+void traceClear();  //  Discard all records.
+//  Print the records as hex, one per line, between SIGFOX_TRACE and SIGFOX_TRACE_END lines.
+void traceDump(Print &port);
+
+#endif // UNABIZ_ARDUINO_TRACE_H
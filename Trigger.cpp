@@ -0,0 +1,128 @@
+//  Declarative event triggers for deciding when a sensor reading is worth sending.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+Trigger::Trigger() {
+  //  Start with no rules.
+  ruleCount = 0;
+}
+
+void Trigger::clear() {
+  //  Remove all rules.
+  ruleCount = 0;
+}
+
+TriggerRule *Trigger::addRule(uint8_t channel, uint8_t type, float limit,
+                              unsigned long minInterval) {
+  //  Allocate the next rule from the fixed table.  Return 0 if the table is full.
+  if (ruleCount >= MAX_TRIGGER_RULES) return 0;
+  TriggerRule *rule = &rules[ruleCount++];
+  rule->channel = channel;
+  rule->type = type;
+  rule->limit = limit;
+  rule->hysteresis = 0;
+  rule->debounce = 0;
+  rule->minInterval = minInterval;
+  rule->above = false;
+  rule->pending = false;
+  rule->primed = false;
+  return rule;
+}
+
+bool Trigger::addCrossing(uint8_t channel, float threshold, float hysteresis,
+                          unsigned long debounce, unsigned long minInterval) {
+  //  Trigger when the value goes above threshold, and again when it falls below threshold - hysteresis.
+  TriggerRule *rule = addRule(channel, TRIGGER_CROSSING, threshold, minInterval);
+  if (!rule) return false;
+  rule->hysteresis = hysteresis;
+  rule->debounce = debounce;
+  return true;
+}
+
+bool Trigger::addDelta(uint8_t channel, float delta, unsigned long minInterval) {
+  //  Trigger when the value moves by delta or more since the channel last triggered.
+  return addRule(channel, TRIGGER_DELTA, delta, minInterval) != 0;
+}
+
+bool Trigger::addRate(uint8_t channel, float rate, unsigned long minInterval) {
+  //  Trigger when the value changes faster than rate units per second.
+  return addRule(channel, TRIGGER_RATE, rate, minInterval) != 0;
+}
+
+uint8_t Trigger::sample(uint8_t channel, float value) {
+  return sample(channel, value, millis());
+}
+
+uint8_t Trigger::sample(uint8_t channel, float value, unsigned long now) {
+  //  Evaluate every rule for the channel in a single pass.  Returns a bitmask of
+  //  TriggerType for the rules that fired.  The first sample only sets the baseline.
+  uint8_t fired = 0;
+  for (uint8_t i = 0; i < ruleCount; i++) {
+    TriggerRule *rule = &rules[i];
+    if (rule->channel != channel) continue;
+    if (!rule->primed) {
+      rule->above = (value >= rule->limit);
+      rule->lastValue = value;
+      rule->lastTime = now;
+      rule->sentValue = value;
+      //  Backdate the last trigger so that minInterval doesn't block the first one.
+      rule->sentTime = now - rule->minInterval;
+      rule->primed = true;
+      continue;
+    }
+    //  Don't trigger the channel again too soon.  Crossings stay pending until allowed.
+    const bool allowed = (now - rule->sentTime >= rule->minInterval);
+    switch (rule->type) {
+      case TRIGGER_CROSSING: {
+        //  Once above, the value must drop below threshold - hysteresis to cross back.
+        const bool above = rule->above ?
+          (value >= rule->limit - rule->hysteresis) :
+          (value >= rule->limit);
+        if (above == rule->above) { rule->pending = false; break; }
+        if (!rule->pending) { rule->pending = true; rule->pendingSince = now; }
+        if (now - rule->pendingSince < rule->debounce || !allowed) break;
+        rule->above = above;
+        rule->pending = false;
+        fired |= TRIGGER_CROSSING;
+        break;
+      }
+      case TRIGGER_DELTA:
+        if (allowed && fabs(value - rule->sentValue) >= rule->limit) fired |= TRIGGER_DELTA;
+        break;
+      case TRIGGER_RATE: {
+        const unsigned long elapsed = now - rule->lastTime;
+        if (allowed && elapsed > 0 &&
+            fabs(value - rule->lastValue) * 1000.0 >= rule->limit * elapsed)
+          fired |= TRIGGER_RATE;
+        rule->lastValue = value;
+        rule->lastTime = now;
+        break;
+      }
+    }
+  }
+  if (fired == 0) return 0;
+  //  Remember the value that was triggered, for all rules on the channel.
+  for (uint8_t i = 0; i < ruleCount; i++) {
+    TriggerRule *rule = &rules[i];
+    if (rule->channel != channel) continue;
+    rule->sentValue = value;
+    rule->sentTime = now;
+  }
+  return fired;
+}
+
+bool Trigger::isAbove(uint8_t channel) {
+  //  Return the crossing state of the channel, or false if it has no crossing rule.
+  for (uint8_t i = 0; i < ruleCount; i++) {
+    if (rules[i].channel == channel && rules[i].type == TRIGGER_CROSSING)
+      return rules[i].above;
+  }
+  return false;
+}
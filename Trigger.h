@@ -0,0 +1,65 @@
+//  Declarative event triggers for deciding when a sensor reading is worth sending.
+#ifndef UNABIZ_ARDUINO_TRIGGER_H
+#define UNABIZ_ARDUINO_TRIGGER_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+const uint8_t MAX_TRIGGER_RULES = 8;  //  Max number of rules, shared by all channels.
+
+//  Kinds of trigger rules.  Returned as a bitmask by Trigger::sample().
+enum TriggerType {
+  TRIGGER_CROSSING = 1,  //  Value crossed a threshold, with hysteresis.
+  TRIGGER_DELTA = 2,  //  Value moved by at least delta since the last trigger.
+  TRIGGER_RATE = 4,  //  Value changed faster than rate units per second.
+};
+
+//  One rule, with the state needed to evaluate it against the next sample.
+struct TriggerRule {
+  uint8_t channel;  //  Sensor channel that this rule watches.
+  uint8_t type;  //  TRIGGER_CROSSING, TRIGGER_DELTA or TRIGGER_RATE.
+  float limit;  //  Threshold, delta or rate per second depending on type.
+  float hysteresis;  //  For crossings: value must fall below limit - hysteresis to cross back.
+  unsigned long debounce;  //  For crossings: new state must hold this long (ms) before it triggers.
+  unsigned long minInterval;  //  Never trigger the channel again within this time (ms).
+  bool above;  //  For crossings: true if the value is currently above the threshold.
+  bool pending;  //  For crossings: state change seen, waiting for debounce.
+  unsigned long pendingSince;  //  For crossings: when the pending state change was first seen.
+  float lastValue;  //  For rates: previous sample.
+  unsigned long lastTime;  //  For rates: time of previous sample.
+  float sentValue;  //  Value of the channel when it last triggered.
+  unsigned long sentTime;  //  Time when the channel last triggered.
+  bool primed;  //  False until the first sample has been seen.
+};
+
+class Trigger
+{
+public:
+  Trigger();
+  //  Trigger when the value goes above threshold, and again when it falls below threshold - hysteresis.
+  bool addCrossing(uint8_t channel, float threshold, float hysteresis,
+                   unsigned long debounce = 0, unsigned long minInterval = 0);
+  //  Trigger when the value moves by delta or more since the channel last triggered.
+  bool addDelta(uint8_t channel, float delta, unsigned long minInterval = 0);
+  //  Trigger when the value changes faster than rate units per second.
+  bool addRate(uint8_t channel, float rate, unsigned long minInterval = 0);
+  //  Evaluate the rules for the channel against a new sample.  Returns a bitmask
+  //  of TriggerType for the rules that fired, or 0 if nothing should be sent.
+  uint8_t sample(uint8_t channel, float value);
+  uint8_t sample(uint8_t channel, float value, unsigned long now);
+  bool isAbove(uint8_t channel);  //  Return the crossing state of the channel.
+  void clear();  //  Remove all rules.
+
+private:
+  TriggerRule *addRule(uint8_t channel, uint8_t type, float limit,
+                       unsigned long minInterval);
+  TriggerRule rules[MAX_TRIGGER_RULES];
+  uint8_t ruleCount;
+};
+
+#endif // UNABIZ_ARDUINO_TRIGGER_H
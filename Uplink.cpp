@@ -0,0 +1,154 @@
+//  Queue of uplink messages waiting to be sent to SIGFOX.
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+#include "SIGFOX.h"
+
+UplinkQueue::UplinkQueue(Radiocrafts &transceiver) {
+  //  Construct a queue for Radiocrafts.
+  radiocrafts = &transceiver;
+  init();
+}
+
+UplinkQueue::UplinkQueue(Wisol &transceiver) {
+  //  Construct a queue for Wisol.
+  wisol = &transceiver;
+  init();
+}
+
+void UplinkQueue::init() {
+  head = 0; size = 0; dropCount = 0; failCount = 0;
+  nextAttempt = 0; backingOff = false; timeouts = 0;
+  policy = DEFAULT_RETRY_POLICY;
+}
+
+void UplinkQueue::setRetryPolicy(const RetryPolicy &policy0) {
+  //  Set the policy for retrying failed uplinks.
+  policy = policy0;
+}
+
+bool UplinkQueue::push(const String &payload) {
+  return push(payload.c_str());
+}
+
+bool UplinkQueue::push(const char *payload) {
+  //  Queue a payload of hex digits.  If the queue is full, the oldest payload is
+  //  dropped since newer readings are more useful.  Return false if anything was dropped.
+  const size_t length = payload ? strlen(payload) : 0;
+  if (length == 0 || length > MAX_BYTES_PER_MESSAGE * 2) return false;
+  bool ok = true;
+  if (size >= UPLINK_QUEUE_SIZE) { pop(); dropCount++; ok = false; }
+  const uint8_t tail = (head + size) % UPLINK_QUEUE_SIZE;
+  strcpy(payloads[tail], payload);
+  attempts[tail] = 0;
+  size++;
+  return ok;
+}
+
+bool UplinkQueue::peek(String &payload) {
+  //  Return the oldest queued payload without removing it.
+  if (size == 0) return false;
+  payload = payloads[head];
+  return true;
+}
+
+void UplinkQueue::pop() {
+  //  Remove the oldest queued payload.
+  if (size == 0) return;
+  head = (head + 1) % UPLINK_QUEUE_SIZE;
+  size--;
+}
+
+bool UplinkQueue::isDue() {
+  //  Return true if a payload is queued and its retry delay has passed.  nextAttempt is only
+  //  compared while backing off, since the difference turns negative after 2^31 ms (24.8 days).
+  if (backingOff && (long) (millis() - nextAttempt) >= 0) backingOff = false;
+  return size > 0 && !backingOff;
+}
+
+unsigned long UplinkQueue::nextAttemptTime() {
+  //  millis() when the next payload may be sent.  Useful for powerDownUntil().
+  isDue();  //  Stop backing off if the delay has passed.
+  return backingOff ? nextAttempt : millis();
+}
+
+bool UplinkQueue::sendNext() {
+  //  Send the oldest queued payload if due.  Doesn't block waiting for the retry delay.
+  if (!isDue()) return false;
+  if (sendPayload(payloads[head])) {
+    timeouts = 0;
+    pop();
+    return true;
+  }
+  const SendError error = getLastError();
+  //  Duty cycle doesn't allow sending yet.  Not a failure, try again later.
+  if (error == SEND_NOT_READY) return false;
+  //  A timeout means the module may be hung, so reboot it instead of waiting
+  //  for more timeouts.  Garbage responses are usually UART glitches, just retry.
+  //  Under an armed Supervisor, leave the reboot to its escalation so the module isn't
+  //  rebooted twice for the same timeouts.
+  if (error == SEND_NO_RESPONSE) {
+    timeouts++;
+    if (policy.rebootAfter > 0 && timeouts >= policy.rebootAfter && !watchdogArmed()) {
+      reboot();
+      timeouts = 0;
+    }
+  }
+  //  Requeue the payload at the back, or drop it after too many attempts.  Both slots are
+  //  free after pop(), and the same slot if the queue was full, so copy in place.
+  const uint8_t failed = head;
+  const uint8_t failedAttempts = attempts[failed] + 1;
+  pop();
+  if (failedAttempts >= policy.maxAttempts) {
+    failCount++;
+  } else {
+    const uint8_t tail = (head + size) % UPLINK_QUEUE_SIZE;
+    if (tail != failed) strcpy(payloads[tail], payloads[failed]);
+    attempts[tail] = failedAttempts;
+    size++;
+  }
+  //  Wait before the next attempt: exponential backoff plus jitter.
+  unsigned long delayTime = policy.backoff;
+  for (uint8_t i = 1; i < failedAttempts && delayTime < policy.maxBackoff; i++)
+    delayTime = delayTime * 2;
+  if (delayTime > policy.maxBackoff) delayTime = policy.maxBackoff;
+  if (policy.useDutyCycle && delayTime < SEND_DELAY) delayTime = SEND_DELAY;
+  if (policy.jitter > 0) delayTime += random(policy.jitter + 1);
+  nextAttempt = millis() + delayTime;
+  backingOff = true;
+  return false;
+}
+
+bool UplinkQueue::sendPayload(const String &payload) {
+  if (wisol) return wisol->sendMessage(payload);
+  else if (radiocrafts) return radiocrafts->sendMessage(payload);
+  return false;
+}
+
+SendError UplinkQueue::getLastError() {
+  if (wisol) return wisol->getLastError();
+  else if (radiocrafts) return radiocrafts->getLastError();
+  return SEND_OK;
+}
+
+bool UplinkQueue::reboot() {
+  String result;
+  if (wisol) return wisol->reboot(result);
+  else if (radiocrafts) return radiocrafts->reboot(result);
+  return false;
+}
+
+uint8_t UplinkQueue::count() { return size; }
+
+bool UplinkQueue::isEmpty() { return size == 0; }
+
+bool UplinkQueue::isFull() { return size >= UPLINK_QUEUE_SIZE; }
+
+unsigned int UplinkQueue::dropped() { return dropCount; }
+
+unsigned int UplinkQueue::failed() { return failCount; }
@@ -0,0 +1,71 @@
+//  Queue of uplink messages waiting to be sent to SIGFOX.
+#ifndef UNABIZ_ARDUINO_UPLINK_H
+#define UNABIZ_ARDUINO_UPLINK_H
+
+#ifdef ARDUINO
+  #if (ARDUINO >= 100)
+    #include <Arduino.h>
+  #else  //  ARDUINO >= 100
+    #include <WProgram.h>
+  #endif  //  ARDUINO  >= 100
+#endif  //  ARDUINO
+
+const uint8_t UPLINK_QUEUE_SIZE = 4;  //  Max number of messages waiting to be sent.
+
+//  How to retry a failed uplink.  The delay before retry n is backoff * 2^(n-1),
+//  capped at maxBackoff, plus a random jitter of up to jitter ms.
+struct RetryPolicy {
+  uint8_t maxAttempts;  //  Drop the message after this many failed attempts.
+  unsigned long backoff;  //  Delay (ms) before the first retry.
+  unsigned long maxBackoff;  //  Longest delay (ms) between retries.
+  unsigned long jitter;  //  Max random delay (ms) added, so that nodes don't retry in step.
+  bool useDutyCycle;  //  If true, assume a failed attempt went on air and wait SEND_DELAY before retrying.
+  //  Reboot the module after this many consecutive timeouts.  0 to never reboot.  Skipped
+  //  while a Supervisor has the watchdog armed, since it escalates on the same timeouts.
+  uint8_t rebootAfter;
+};
+
+//  Default: 3 attempts, retrying after 5 s then 10 s, reboot after 2 timeouts in a row.
+const RetryPolicy DEFAULT_RETRY_POLICY = { 3, 5000, SEND_DELAY, 2000, false, 2 };
+
+class UplinkQueue
+{
+public:
+  UplinkQueue(Radiocrafts &transceiver);  //  Construct a queue for Radiocrafts.
+  UplinkQueue(Wisol &transceiver);  //  Construct a queue for Wisol.
+  void setRetryPolicy(const RetryPolicy &policy);  //  Set the policy for retrying failed uplinks.
+  bool push(const String &payload);  //  Queue a payload of hex digits, max 12 bytes.  Drops the oldest if full.
+  bool push(const char *payload);  //  Same, without making a String, e.g. for PayloadEncoder::hex().
+  //  Send the oldest queued payload if due.  Failed payloads are requeued for retry.  Only
+  //  failures reported by the transceiver are retried: Radiocrafts doesn't acknowledge uplinks.
+  bool sendNext();
+  bool isDue();  //  Return true if a payload is queued and its retry delay has passed.
+  unsigned long nextAttemptTime();  //  millis() when the next payload may be sent.
+  bool peek(String &payload);  //  Return the oldest queued payload without removing it.
+  void pop();  //  Remove the oldest queued payload.
+  uint8_t count();  //  Number of queued payloads.
+  bool isEmpty();
+  bool isFull();
+  unsigned int dropped();  //  Number of payloads dropped because the queue was full.
+  unsigned int failed();  //  Number of payloads dropped after too many failed attempts.
+
+private:
+  void init();
+  bool sendPayload(const String &payload);
+  SendError getLastError();
+  bool reboot();
+  char payloads[UPLINK_QUEUE_SIZE][MAX_BYTES_PER_MESSAGE * 2 + 1];  //  Hex digits, null-terminated.
+  uint8_t attempts[UPLINK_QUEUE_SIZE];  //  Number of failed attempts for each payload.
+  uint8_t head;  //  Index of the oldest payload.
+  uint8_t size;  //  Number of queued payloads.
+  unsigned int dropCount;
+  unsigned int failCount;
+  RetryPolicy policy;
+  unsigned long nextAttempt;  //  millis() when the next attempt is allowed, if backingOff.
+  bool backingOff;  //  True while waiting for nextAttempt after a failed attempt.
+  uint8_t timeouts;  //  Number of consecutive timeouts.
+  Radiocrafts *radiocrafts = 0;  //  Reference to Radiocrafts transceiver for sending the messages.
+  Wisol *wisol = 0;  //  Reference to Wisol transceiver for sending the messages.
+};
+
+#endif // UNABIZ_ARDUINO_UPLINK_H
@@ -9,11 +9,24 @@
 
 #include "SIGFOX.h"
 
-//  Use a macro for logging because Flash strings not supported with String class in Bean+
+//  Use a macro for logging because Flash strings not supported with String class in Bean+.
+//  Levels disabled by SIGFOX_LOG_LEVEL compile to nothing, so their arguments are never evaluated.
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
 #define log1(x) { echoPort->println(x); }
 #define log2(x, y) { echoPort->print(x); echoPort->println(y); }
-#define log3(x, y, z) { echoPort->print(x); echoPort->print(y); echoPort->println(z); }
 #define log4(x, y, z, a) { echoPort->print(x); echoPort->print(y); echoPort->print(z); echoPort->println(a); }
+#else  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#define log1(x) {}
+#define log2(x, y) {}
+#define log4(x, y, z, a) {}
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_INFO
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+#define error1(x) { echoPort->println(x); }
+#define error2(x, y) { echoPort->print(x); echoPort->println(y); }
+#else  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
+#define error1(x) {}
+#define error2(x, y) {}
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_ERROR
 
 #define MODEM_BITS_PER_SECOND 9600  //  Connect to modem at this bps.
 #define END_OF_RESPONSE '\r'  //  Character '\r' marks the end of response.
@@ -27,8 +40,8 @@
 #define CMD_GET_TEMPERATURE "AT$T?"  //  Get the module temperature.
 #define CMD_GET_VOLTAGE "AT$V?"  //  Get the module voltage.
 #define CMD_RESET "AT$P=0"  //  Software reset.
-#define CMD_SLEEP "AT$P=1"  //  TODO: Switch to sleep mode : consumption is < 1.5uA
-#define CMD_WAKEUP "AT$P=0"  //  TODO: Switch back to normal mode : consumption is 0.5 mA
+#define CMD_SLEEP "AT$P=1"  //  Switch to sleep mode : consumption is < 1.5uA.  Wake up with a UART break.
+#define CMD_WAKEUP "AT"  //  Sent after the UART break to confirm normal mode : consumption is 0.5 mA
 #define CMD_END "\r"
 #define CMD_RCZ1 "AT$IF=868130000"  //  EU / RCZ1 Frequency
 #define CMD_RCZ2 "AT$IF=902200000"  //  US / RCZ2 Frequency
@@ -47,6 +60,48 @@ static String data;
 const uint8_t markerPosMax = 5;
 static uint8_t markerPos[markerPosMax];
 
+//  Index into the command table below.
+enum WisolCommand {
+  WISOL_SEND_MESSAGE = 0,
+  WISOL_OUTPUT_POWER_MAX = 1,
+  WISOL_PRESEND = 2,
+  WISOL_PRESEND2 = 3,
+  WISOL_GET_ID = 4,
+  WISOL_GET_PAC = 5,
+  WISOL_GET_TEMPERATURE = 6,
+  WISOL_GET_VOLTAGE = 7,
+  WISOL_RESET = 8,
+  WISOL_SLEEP = 9,
+  WISOL_EMULATOR_DISABLE = 10,
+  WISOL_EMULATOR_ENABLE = 11,
+  WISOL_WAKEUP = 12,
+};
+
+//  AT commands and their trace ids, kept in flash and streamed to the module
+//  so they don't take up RAM or need a String for each command.
+struct CommandEntry {
+  char text[10];  //  AT command without CMD_END.
+  uint8_t traceCommand;  //  TRACE_CMD_ id for the trace and stats->
+};
+static const CommandEntry commandTable[] PROGMEM = {
+  { CMD_SEND_MESSAGE, TRACE_CMD_SEND_MESSAGE },
+  { CMD_OUTPUT_POWER_MAX, TRACE_CMD_OUTPUT_POWER },
+  { CMD_PRESEND, TRACE_CMD_PRESEND },
+  { CMD_PRESEND2, TRACE_CMD_PRESEND2 },
+  { CMD_GET_ID, TRACE_CMD_GET_ID },
+  { CMD_GET_PAC, TRACE_CMD_GET_PAC },
+  { CMD_GET_TEMPERATURE, TRACE_CMD_GET_TEMPERATURE },
+  { CMD_GET_VOLTAGE, TRACE_CMD_GET_VOLTAGE },
+  { CMD_RESET, TRACE_CMD_RESET },
+  { CMD_SLEEP, TRACE_CMD_SLEEP },
+  { CMD_EMULATOR_DISABLE, TRACE_CMD_EMULATOR },
+  { CMD_EMULATOR_ENABLE, TRACE_CMD_EMULATOR },
+  { CMD_WAKEUP, TRACE_CMD_WAKEUP },
+};
+//  Sent after the command and payload.
+static const char commandEnd[] PROGMEM = CMD_END;
+static const char responseEnd[] PROGMEM = CMD_SEND_MESSAGE_RESPONSE CMD_END;
+
 void sleep(int milliSeconds) {
 #ifdef BEAN_BEAN_BEAN_H
   Bean.sleep(milliSeconds);
@@ -55,41 +110,59 @@ void sleep(int milliSeconds) {
 #endif // BEAN_BEAN_BEAN_H
 }
 
-bool Wisol::sendBuffer(const String &buffer, const int timeout,
-                       uint8_t expectedMarkerCount, String &response,
+bool Wisol::sendBuffer(uint8_t index, const char *payload, const char *suffix,
+                       const int timeout, uint8_t expectedMarkerCount, String &response,
                        uint8_t &actualMarkerCount) {
-  //  buffer contains a string of ASCII chars to be sent to the modem.
-  //  We send the buffer to the modem.  Return true if successful.
+  //  We send the command from the command table at index, followed by the payload in RAM
+  //  and the suffix in flash, to the modem.  Return true if successful.
   //  expectedMarkerCount is the number of end-of-command markers '\r' we
   //  expect to see.  actualMarkerCount contains the actual number seen.
-  log2(F(" - Wisol.sendBuffer: "), buffer);
+  CommandEntry entry;
+  memcpy_P(&entry, &commandTable[index], sizeof(entry));
+  const uint8_t command = entry.traceCommand;
+  const unsigned int commandLength = strlen(entry.text);
+  const unsigned int payloadEnd = commandLength + strlen(payload);
+  const unsigned int length = payloadEnd + strlen_P(suffix);
+  log4(F(" - Wisol.sendBuffer: "), entry.text, payload, (const __FlashStringHelper *) suffix);
+  //  Module must be awake to respond.  Wake up before clearing response, since it may share the buffer.
+  if (sleeping && !wake()) return false;
   response = "";
 
   actualMarkerCount = 0;
+#if SIGFOX_STATS
+  const unsigned long settleStart = millis();
+#endif  //  SIGFOX_STATS
+  captureExchange();
   //  Start serial interface.
   serialPort->begin(MODEM_BITS_PER_SECOND);
-  sleep(200);
+  ::sleep(200);
   serialPort->flush();
   serialPort->listen();
 
   //  Send the buffer: need to write/read char by char because of echo.
-  const char *rawBuffer = buffer.c_str();
   //  Send buffer and read response.  Loop until timeout or we see the end of response marker.
   unsigned long startTime = millis(); int i = 0;
+#if SIGFOX_STATS
+  const unsigned long sendStart = startTime;
+#endif  //  SIGFOX_STATS
   //  Previous code for verifying that data was sent correctly.
   //static String echoSend = "", echoReceive = "";
   for (;;) {
     //  If there is data to send, send it.
-    if (i < buffer.length()) {
-      //  Send the char.
-      uint8_t txChar = rawBuffer[i];
+    if (i < length) {
+      //  Send the char from the command, payload or suffix.
+      uint8_t txChar = i < commandLength ? entry.text[i]
+        : i < payloadEnd ? payload[i - commandLength]
+        : pgm_read_byte(suffix + i - payloadEnd);
       //echoSend.concat(toHex((char) txChar) + ' ');
       serialPort->write(txChar);
-      sleep(10);  //  Need to wait a while because SoftwareSerial has no FIFO and may overflow.
+      captureByte(CAPTURE_SENT, txChar);
+      ::sleep(10);  //  Need to wait a while because SoftwareSerial has no FIFO and may overflow.
       i = i + 1;
       startTime = millis();  //  Start the timer only when all data has been sent.
     }
-    //  If timeout, quit.
+    //  If timeout, quit.  Keep the watchdog from resetting us while we wait.
+    watchdogFeed();
     const unsigned long currentTime = millis();
     if (currentTime - startTime > timeout) break;
 
@@ -98,6 +171,7 @@ bool Wisol::sendBuffer(const String &buffer, const int timeout,
       int rxChar = serialPort->read();
       //  echoReceive.concat(toHex((char) rxChar) + ' ');
       if (rxChar == -1) continue;
+      captureByte(CAPTURE_RECEIVED, rxChar);
       if (rxChar == END_OF_RESPONSE) {
         if (actualMarkerCount < markerPosMax)
           markerPos[actualMarkerCount] = response.length();  //  Remember the marker pos.
@@ -105,42 +179,105 @@ bool Wisol::sendBuffer(const String &buffer, const int timeout,
         if (actualMarkerCount >= expectedMarkerCount) break;  //  Seen all markers already.
       } else {
         // log2(F("rxChar "), rxChar);
-        response.concat(String((char) rxChar));
+        response.concat((char) rxChar);
       }
+    } else if (i >= length) {
+      //  Waiting for the module to respond: let the background tasks of the scheduler run.
+      schedulerYield();
     }
   }
   serialPort->end();
+  captureFlush();
+#if SIGFOX_STATS
+  //  startTime is now when the last byte was sent.
+  const unsigned long endTime = millis();
+  stats->commands++;
+  if (actualMarkerCount >= expectedMarkerCount) stats->successes++;
+  else if (response.length() == 0) stats->timeouts++;
+  else stats->unknownResponses++;
+  stats->bytesOut += length;
+  stats->bytesIn += response.length();
+  stats->settleTime += sendStart - settleStart;
+  stats->txTime += startTime - sendStart;
+  stats->waitTime += endTime - startTime;
+  statsAddCommand(*stats, command, endTime - sendStart);
+  if (command == TRACE_CMD_SEND_MESSAGE) {
+    //  Module is transmitting while we wait, then listening if a downlink was requested.
+    if (expectedMarkerCount > 1) { stats->downlinks++; stats->downlinkWaitTime += endTime - startTime; }
+    else stats->uplinkWaitTime += endTime - startTime;
+  }
+#endif  //  SIGFOX_STATS
   //  Log the actual bytes sent and received.
   //log2(F(">> "), echoSend);
   //  if (echoReceive.length() > 0) { log2(F("<< "), echoReceive); }
-  logBuffer(F(">> "), rawBuffer, 0, 0);
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
+  log4(F(">> "), entry.text, payload, (const __FlashStringHelper *) suffix);
   logBuffer(F("<< "), response.c_str(), markerPos, actualMarkerCount);
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
+  memoryCheck(MEMORY_SEND_BUFFER);
 
   //  If we did not see the terminating '\r', something is wrong.
   if (actualMarkerCount < expectedMarkerCount) {
     if (response.length() == 0) {
-      log1(F(" - Wisol.sendBuffer: Error: No response"));  //  Response timeout.
+      error1(F(" - Wisol.sendBuffer: Error: No response"));  //  Response timeout.
+      lastError = SEND_NO_RESPONSE;
     } else {
-      log2(F(" - Wisol.sendBuffer: Error: Unknown response: "), response);
+      error2(F(" - Wisol.sendBuffer: Error: Unknown response: "), response);
+      lastError = SEND_UNKNOWN_RESPONSE;
     }
+    trace(TRACE_SEND_BUFFER, command, length, actualMarkerCount, lastError);
     return false;
   }
+  lastError = SEND_OK;
+  trace(TRACE_SEND_BUFFER, command, length, actualMarkerCount, lastError);
   log2(F(" - Wisol.sendBuffer: response: "), response);
   return true;
 }
 
+static bool parseDownlink(const String &data, String &response) {
+  //  Copy the 8 bytes of a downlink OK\nRX=01 23 45 67 89 AB CD EF as 16 hex digits.
+  static const char prefix[] = "OK\nRX=";
+  if (strncmp(data.c_str(), prefix, sizeof(prefix) - 1) != 0) return false;
+  response = "";
+  for (const char *p = data.c_str() + sizeof(prefix) - 1; *p; p++) {
+    if (*p == ' ') continue;
+    if (!isxdigit((unsigned char) *p) || response.length() >= 2 * BYTES_PER_DOWNLINK) return false;
+    response.concat(*p);
+  }
+  return response.length() == 2 * BYTES_PER_DOWNLINK;
+}
+
+static bool isOk(const String &data) {
+  //  The module answers OK, then the downlink if one was requested, once the uplink is on air.
+  //  Anything else, like ERROR, means that it refused the uplink.
+  return strncmp(data.c_str(), "OK", 2) == 0;
+}
+
 bool Wisol::sendMessage(const String &payload) {
   //  Payload contains a string of hex digits, up to 24 digits / 12 bytes.
   //  We prefix with AT$SF= and send to SIGFOX.  Return true if successful.
   log2(F(" - Wisol.sendMessage: "), device + ',' + payload);
-  if (!isReady()) return false;  //  Prevent user from sending too many messages.
+  if (!isReady()) {  //  Prevent user from sending too many messages.
+    lastError = SEND_NOT_READY;
+    trace(TRACE_SEND_MESSAGE, TRACE_CMD_SEND_MESSAGE, payload.length() / 2, 0, lastError);
+    return false;
+  }
+  const unsigned long uplinkStart = millis();
   //  Exit command mode and prepare to send message.
   if (!exitCommandMode()) return false;
   //  Set the output power for the zone.
-  if (!setOutputPower()) return false;
+  if (!setOutputPower()) { recordUplink(false, uplinkStart); return false; }
   //  Send the data.
-  String message = String(CMD_SEND_MESSAGE) + payload + CMD_END, data;
-  if (sendBuffer(message, WISOL_COMMAND_TIMEOUT, 1, data, markers)) {  //  One '\r' marker expected ("OK\r").
+  bool status = sendBuffer(WISOL_SEND_MESSAGE, payload.c_str(), commandEnd,
+                           WISOL_COMMAND_TIMEOUT, 1, data, markers);  //  One '\r' marker expected ("OK\r").
+  if (status && !isOk(data)) {
+    error2(F(" - Wisol.sendMessage: Error: Refused: "), data);
+    lastError = SEND_MODULE_ERROR;
+    status = false;
+  }
+  trace(TRACE_SEND_MESSAGE, TRACE_CMD_SEND_MESSAGE, payload.length() / 2, markers, lastError);
+  recordUplink(status, uplinkStart);
+  if (status) {
     log1(data);
     lastSend = millis();
     return true;
@@ -152,22 +289,38 @@ bool Wisol::sendMessageAndGetResponse(const String &payload, String &response) {
   //  Payload contains a string of hex digits, up to 24 digits / 12 bytes.
   //  We prefix with AT$SF= and send to SIGFOX.  Return response message from Sigfox in the response parameter.
   log2(F(" - Wisol.sendMessageAndGetResponse: "), device + ',' + payload);
-  if (!isReady()) return false;  //  Prevent user from sending too many messages.
+  if (!isReady()) {  //  Prevent user from sending too many messages.
+    lastError = SEND_NOT_READY;
+    trace(TRACE_SEND_MESSAGE, TRACE_CMD_SEND_MESSAGE, payload.length() / 2, 0, lastError);
+    return false;
+  }
+  const unsigned long uplinkStart = millis();
   //  Exit command mode and prepare to send message.
   if (!exitCommandMode()) return false;
   //  Set the output power for the zone.
-  if (!setOutputPower()) return false;
+  if (!setOutputPower()) { recordUplink(false, uplinkStart); return false; }
   //  Send the data.
-  String message = String(CMD_SEND_MESSAGE) + payload + CMD_SEND_MESSAGE_RESPONSE + CMD_END, data;
   //  Two '\r' markers expected ("OK\r RX=...\r").
-  if (sendBuffer(message, WISOL_COMMAND_TIMEOUT, 2, data, markers)) {
+  bool status = sendBuffer(WISOL_SEND_MESSAGE, payload.c_str(), responseEnd,
+                           WISOL_COMMAND_TIMEOUT, 2, data, markers);
+  //  After ERROR the module sends no second line, so a refusal also ends in a timeout.
+  if (data.length() > 0 && !isOk(data)) {
+    error2(F(" - Wisol.sendMessageAndGetResponse: Error: Refused: "), data);
+    lastError = SEND_MODULE_ERROR;
+    status = false;
+  }
+  trace(TRACE_SEND_MESSAGE, TRACE_CMD_SEND_MESSAGE, payload.length() / 2, markers, lastError);
+  recordUplink(status, uplinkStart);
+  if (status) {
     log1(data);
     lastSend = millis();
-    response = data;
     //  Response contains OK\nRX=01 23 45 67 89 AB CD EF
-    //  Remove the prefix and spaces.
-    response.replace("OK\nRX=", "");
-    response.replace(" ", "");
+    //  Keep the hex digits.  Anything else, like the error when no downlink came, leaves the
+    //  response empty.  The uplink was still sent.
+    if (!parseDownlink(data, response)) {
+      error2(F(" - Wisol.sendMessageAndGetResponse: No downlink: "), data);
+      response = "";
+    }
     return true;
   }
   return false;
@@ -178,20 +331,22 @@ bool Wisol::setOutputPower() {
   switch(zone) {
     case 1:  //  RCZ1
     case 3:  //  RCZ3
-      if (!sendCommand(String(CMD_OUTPUT_POWER_MAX) + CMD_END, 1, data, markers)) return false;
+      if (!sendCommand(WISOL_OUTPUT_POWER_MAX, 1, data, markers)) return false;
       break;
     case 2:  //  RCZ2
     case 4: {  //  RCZ4
-      if (!sendCommand(String(CMD_PRESEND) + CMD_END, 1, data, markers)) return false;
-      //  Parse the returned X,Y.
-      int x = data.charAt(0) - '0';
-      int y = data.charAt(2) - '0';
+      if (!sendCommand(WISOL_PRESEND, 1, data, markers)) return false;
+      //  Parse the returned X,Y.  If it's not X,Y, reset the channel as if X were 0.
+      const char *xy = data.c_str();
+      const bool parsed = data.length() >= 3 && isdigit((unsigned char) xy[0]) && xy[1] == ',' && isdigit((unsigned char) xy[2]);
+      const int x = parsed ? xy[0] - '0' : 0;
+      const int y = parsed ? xy[2] - '0' : 0;
       // log4("x,y=", String(x), ',', String(y));
-      if (x == 0 || y < 3) sendCommand(String(CMD_PRESEND2) + CMD_END, 1, data, markers);
+      if (x == 0 || y < 3) sendCommand(WISOL_PRESEND2, 1, data, markers);
       break;
     }
     default:
-      log2(F(" - Wisol.setOutputPower: Unknown zone "), zone);
+      error2(F(" - Wisol.setOutputPower: Unknown zone "), zone);
       return false;
   }
   return true;
@@ -209,12 +364,51 @@ bool Wisol::exitCommandMode() {
   return true;
 }
 
+bool Wisol::sleep() {
+  //  Put the module to sleep until wake() is called.  The module doesn't
+  //  respond to commands while asleep.
+  log1(F(" - Wisol.sleep"));
+  if (sleeping) return true;
+  if (!sendCommand(WISOL_SLEEP, 1, data, markers)) {
+    trace(TRACE_SLEEP, TRACE_CMD_SLEEP, 0, markers, 0);
+    return false;
+  }
+  sleeping = true;
+  trace(TRACE_SLEEP, TRACE_CMD_SLEEP, 0, markers, 1);
+  return true;
+}
+
+bool Wisol::wake() {
+  //  Wake up the module by holding the transmit line low (UART break),
+  //  then wait for it to start and confirm that it responds.
+  log1(F(" - Wisol.wake"));
+  sleeping = false;
+  serialPort->end();
+  pinMode(txPin, OUTPUT);
+  digitalWrite(txPin, LOW);
+  ::sleep(WISOL_BREAK_TIME);
+  digitalWrite(txPin, HIGH);
+  ::sleep(WISOL_WAKEUP_TIME);
+  if (!sendCommand(WISOL_WAKEUP, 1, data, markers)) {
+    sleeping = true;  //  Still asleep, try again next time.
+    trace(TRACE_WAKE, TRACE_CMD_WAKEUP, 0, markers, 0);
+    return false;
+  }
+  trace(TRACE_WAKE, TRACE_CMD_WAKEUP, 0, markers, 1);
+  return true;
+}
+
+bool Wisol::isSleeping() {
+  //  Return true if the module has been put to sleep.
+  return sleeping;
+}
+
 bool Wisol::getID(String &id, String &pac) {
   //  Get the SIGFOX ID and PAC for the module.
-  if (!sendCommand(String(CMD_GET_ID) + CMD_END, 1, data, markers)) return false;
+  if (!sendCommand(WISOL_GET_ID, 1, data, markers)) return false;
   id = data;
   device = id;
-  if (!sendCommand(String(CMD_GET_PAC) + CMD_END, 1, data, markers)) return false;
+  if (!sendCommand(WISOL_GET_PAC, 1, data, markers)) return false;
   pac = data;
   log2(F(" - Wisol.getID: returned id="), id + ", pac=" + pac);
   return true;
@@ -222,7 +416,7 @@ bool Wisol::getID(String &id, String &pac) {
 
 bool Wisol::getTemperature(float &temperature) {
   //  Returns the temperature of the SIGFOX module.
-  if (!sendCommand(String(CMD_GET_TEMPERATURE) + CMD_END, 1, data, markers)) return false;
+  if (!sendCommand(WISOL_GET_TEMPERATURE, 1, data, markers)) return false;
   temperature = data.toInt() / 10.0;
   log2(F(" - Wisol.getTemperature: returned "), temperature);
   return true;
@@ -230,7 +424,7 @@ bool Wisol::getTemperature(float &temperature) {
 
 bool Wisol::getVoltage(float &voltage) {
   //  Returns the power supply voltage.
-  if (!sendCommand(String(CMD_GET_VOLTAGE) + CMD_END, 1, data, markers)) return false;
+  if (!sendCommand(WISOL_GET_VOLTAGE, 1, data, markers)) return false;
   voltage = data.toFloat() / 1000.0;
   log2(F(" - Wisol.getVoltage: returned "), voltage);
   return true;
@@ -238,14 +432,14 @@ bool Wisol::getVoltage(float &voltage) {
 
 bool Wisol::getHardware(String &hardware) {
   //  TODO
-  log1(F(" - Wisol.getHardware: ERROR - Not implemented"));
+  error1(F(" - Wisol.getHardware: ERROR - Not implemented"));
   hardware = "TODO";
   return true;
 }
 
 bool Wisol::getFirmware(String &firmware) {
   //  TODO
-  log1(F(" - Wisol.getFirmware: ERROR - Not implemented"));
+  error1(F(" - Wisol.getFirmware: ERROR - Not implemented"));
   firmware = "TODO";
   return true;
 }
@@ -253,21 +447,21 @@ bool Wisol::getFirmware(String &firmware) {
 bool Wisol::getParameter(uint8_t address, String &value) {
   //  Read the parameter at the address.
   log2(F(" - Wisol.getParameter: address=0x"), toHex((char) address));
-  log1(F(" - Wisol.getParameter: ERROR - Not implemented"));
+  error1(F(" - Wisol.getParameter: ERROR - Not implemented"));
   log4(F(" - Wisol.getParameter: address=0x"), toHex((char) address), F(" returned "), value);
   return true;
 }
 
 bool Wisol::getPower(int &power) {
   //  Get the power step-down.
-  log1(F(" - Wisol.getPower: ERROR - Not implemented"));
+  error1(F(" - Wisol.getPower: ERROR - Not implemented"));
   power = 0;
   return true;
 }
 
 bool Wisol::setPower(int power) {
   //  TODO: Power value: 0...14
-  log1(F(" - Wisol.setPower: ERROR - Not implemented"));
+  error1(F(" - Wisol.setPower: ERROR - Not implemented"));
   return true;
 }
 
@@ -285,7 +479,7 @@ bool Wisol::disableEmulator(String &result) {
   //  Set the module key to the unique SIGFOX key.  This is needed for sending
   //  to a real SIGFOX base station.
   log1(F(" - Disabling SNEK emulation mode..."));
-  if (!sendCommand(String(CMD_EMULATOR_DISABLE) + CMD_END, 1, data, markers)) return false;
+  if (!sendCommand(WISOL_EMULATOR_DISABLE, 1, data, markers)) return false;
   return true;
 }
 
@@ -293,8 +487,8 @@ bool Wisol::enableEmulator(String &result) {
   //  Set the module key to the public key.  This is needed for sending
   //  to an emulator.
   log1(F(" - Enabling SNEK emulation mode..."));
-  log1(F(" - WARNING: SNEK emulation mode will NOT work with a Sigfox network"));
-  if (!sendCommand(String(CMD_EMULATOR_ENABLE) + CMD_END, 1, data, markers)) return false;
+  error1(F(" - WARNING: SNEK emulation mode will NOT work with a Sigfox network"));
+  if (!sendCommand(WISOL_EMULATOR_ENABLE, 1, data, markers)) return false;
   return true;
 }
 
@@ -318,28 +512,28 @@ bool Wisol::setFrequency(int zone0, String &result) {
   zone = zone0;
   switch(zone) {
     case 1:  //  RCZ1
-      // if (!sendCommand(String(CMD_RCZ1) + CMD_END, 1, data, markers)) return false;
-      // if (!sendCommand(String(CMD_OUTPUT_POWER_MAX) + CMD_END, 1, data, markers)) return false;
-      // if (!sendCommand(String(CMD_MODULATION_ON) + CMD_END, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_RCZ1, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_OUTPUT_POWER_MAX, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_MODULATION_ON, 1, data, markers)) return false;
       break;
     case 2:  //  RCZ2
-      // if (!sendCommand(String(CMD_RCZ2) + CMD_END, 1, data, markers)) return false;
-      // if (!sendCommand(String(CMD_MODULATION_ON) + CMD_END, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_RCZ2, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_MODULATION_ON, 1, data, markers)) return false;
       break;
     case 3:  //  RCZ3
-      // if (!sendCommand(String(CMD_RCZ3) + CMD_END, 1, data, markers)) return false;
-      // if (!sendCommand(String(CMD_OUTPUT_POWER_MAX) + CMD_END, 1, data, markers)) return false;
-      // if (!sendCommand(String(CMD_MODULATION_ON) + CMD_END, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_RCZ3, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_OUTPUT_POWER_MAX, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_MODULATION_ON, 1, data, markers)) return false;
       break;
     case 4:  //  RCZ4
-      // if (!sendCommand(String(CMD_RCZ4) + CMD_END, 1, data, markers)) return false;
-      // if (!sendCommand(String(CMD_MODULATION_ON) + CMD_END, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_RCZ4, 1, data, markers)) return false;
+      // if (!sendCommand(WISOL_MODULATION_ON, 1, data, markers)) return false;
       break;
     default:
-      log2(F(" - Wisol.setFrequency: Unknown zone "), zone);
+      error2(F(" - Wisol.setFrequency: Unknown zone "), zone);
       return false;
   }
-  // if (!sendCommand(String(CMD_MODULATION_OFF) + CMD_END, 1, data, markers)) return false;
+  // if (!sendCommand(WISOL_MODULATION_OFF, 1, data, markers)) return false;
   result = "OK";
   return true;
 }
@@ -372,13 +566,13 @@ bool Wisol::setFrequencyJP(String &result) {
 bool Wisol::reboot(String &result) {
   //  Software reset the module.
   log1(F(" - Wisol.reboot"));
-  if (!sendCommand(String(CMD_RESET) + CMD_END, 1, data, markers)) return false;
+  if (!sendCommand(WISOL_RESET, 1, data, markers)) return false;
   return true;
 }
 
 bool Wisol::writeSettings(String &result) {
   //  TODO: Write settings to module's flash memory.
-  log1(F(" - Wisol.writeSettings: ERROR - Not implemented"));
+  error1(F(" - Wisol.writeSettings: ERROR - Not implemented"));
   return true;
 }
 
@@ -407,6 +601,15 @@ Wisol::Wisol(Country country0, bool useEmulator0, const String device0, bool ech
   //  an alternative class BeanSoftwareSerial to work around this.
   //  For Bean, SoftwareSerial is a #define alias for BeanSoftwareSerial.
   serialPort = new SoftwareSerial(rx, tx);
+  lastError = SEND_OK;
+#if SIGFOX_STATS
+  stats = new TransceiverStats;
+#else  //  SIGFOX_STATS
+  stats = 0;
+#endif  //  SIGFOX_STATS
+  clearStats();
+  txPin = tx;
+  sleeping = false;
   if (echo) echoPort = &Serial;
   else echoPort = &nullPort;
   lastEchoPort = &Serial;
@@ -418,6 +621,9 @@ bool Wisol::begin() {
   lastSend = 0;
   for (int i = 0; i < 5; i++) {
     //  Retry 5 times.
+#if SIGFOX_STATS
+    if (i > 0) stats->retries++;
+#endif  //  SIGFOX_STATS
 #ifdef BEAN_BEAN_BEAN_H
     Bean.sleep(7000);  //  For Bean, delay longer to allow Bluetooth debug console to connect.
 #else  // BEAN_BEAN_BEAN_H
@@ -438,8 +644,8 @@ bool Wisol::begin() {
     //  Read SIGFOX ID and PAC from module.
     log1(F(" - Getting SIGFOX ID..."));  String id, pac;
     if (!getID(id, pac)) continue;
-    echoPort->print(F(" - SIGFOX ID = "));  Serial.println(id);
-    echoPort->print(F(" - PAC = "));  Serial.println(pac);
+    log2(F(" - SIGFOX ID = "), id);
+    log2(F(" - PAC = "), pac);
 
     //  Set the frequency of SIGFOX module.
     // log1(F(" - Setting frequency for country "));
@@ -463,17 +669,19 @@ bool Wisol::begin() {
     log1(F(" - Getting frequency (expecting 3)..."));  String frequency;
     if (!getFrequency(frequency)) continue;
     log2(F(" - Frequency (expecting 3) = "), frequency);
+    trace(TRACE_BEGIN, 0, 0, 0, 1);
     return true;  //  Init module succeeded.
   }
+  trace(TRACE_BEGIN, 0, 0, 0, 0);
   return false;  //  Failed to init module.
 }
 
-bool Wisol::sendCommand(const String &cmd, uint8_t expectedMarkerCount,
+bool Wisol::sendCommand(uint8_t index, uint8_t expectedMarkerCount,
                               String &result, uint8_t &actualMarkerCount) {
-  //  We send the command string in cmd to SIGFOX.  Return true if successful.
+  //  We send the command at index in the command table to SIGFOX.  Return true if successful.
   //  Enter command mode.
   if (!enterCommandMode()) return false;
-  if (!sendBuffer(cmd, WISOL_COMMAND_TIMEOUT, expectedMarkerCount,
+  if (!sendBuffer(index, "", commandEnd, WISOL_COMMAND_TIMEOUT, expectedMarkerCount,
                   data, actualMarkerCount)) return false;
   result = data;
   return true;
@@ -519,14 +727,43 @@ bool Wisol::isReady()
   const unsigned long elapsedTime = currentTime - lastSend;
   //  For development, allow sending every 2 seconds.
   if (elapsedTime <= 2 * 1000) {
-    log1(F("***MESSAGE NOT SENT - Must wait 2 seconds before sending the next message"));
+    error1(F("***MESSAGE NOT SENT - Must wait 2 seconds before sending the next message"));
     return false;
   }  //  Wait before sending.
   if (elapsedTime <= SEND_DELAY)
-    log1(F("Warning: Should wait 10 mins before sending the next message"));
+    error1(F("Warning: Should wait 10 mins before sending the next message"));
   return true;
 }
 
+SendError Wisol::getLastError() {
+  //  Return the result of the last send to the module.
+  return lastError;
+}
+
+void Wisol::getStats(TransceiverStats &stats0) {
+  //  Return the command and uplink stats since the last clearStats().
+#if SIGFOX_STATS
+  stats0 = *stats;
+#else  //  SIGFOX_STATS
+  memset(&stats0, 0, sizeof(stats0));
+#endif  //  SIGFOX_STATS
+}
+
+void Wisol::recordUplink(bool status, unsigned long uplinkStart) {
+  //  Count the uplink and add its latency to the histogram.
+#if SIGFOX_STATS
+  if (status) stats->uplinks++; else stats->uplinkFailures++;
+  statsAddLatency(stats->uplinkLatency, millis() - uplinkStart);
+#endif  //  SIGFOX_STATS
+}
+
+void Wisol::clearStats() {
+  //  Reset the stats->
+#if SIGFOX_STATS
+  memset(stats, 0, sizeof(*stats));
+#endif  //  SIGFOX_STATS
+}
+
 void Wisol::echoOn() {
   //  Echo commands and responses to the echo port.
   echoPort = lastEchoPort;
@@ -551,7 +788,7 @@ void Wisol::echo(const String &msg) {
 
 bool Wisol::receive(String &data) {
   //  TODO
-  log1(F(" - Wisol.receive: ERROR - Not implemented"));
+  error1(F(" - Wisol.receive: ERROR - Not implemented"));
   return true;
 }
 
@@ -642,39 +879,55 @@ String Wisol::toHex(char *c, int length) {
 }
 
 uint8_t Wisol::hexDigitToDecimal(char ch) {
-  //  Convert 0..9, a..f, A..F to decimal.
-  if (ch >= '0' && ch <= '9') return (uint8_t) ch - '0';
-  if (ch >= 'a' && ch <= 'z') return (uint8_t) ch - 'a' + 10;
-  if (ch >= 'A' && ch <= 'Z') return (uint8_t) ch - 'A' + 10;
-  log2(F(" - Wisol.hexDigitToDecimal: Error: Invalid hex digit "), ch);
+  //  Convert 0..9, a..f, A..F to decimal.  Anything else is an error and gives 0.
+  const uint8_t value = hexDigitValue(ch);
+  if (value != HEX_DIGIT_INVALID) return value;
+  error2(F(" - Wisol.hexDigitToDecimal: Error: Invalid hex digit "), ch);
   return 0;
 }
 
+#if SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
 //  Convert nibble to hex digit.
 static const char nibbleToHex[] = "0123456789abcdef";
 
+//  Size of the line formatted by logBuffer() before writing to the echo port.
+const uint8_t echoLineSize = 32;
+
+static void addEcho(Print *port, char *line, uint8_t &length, char ch) {
+  //  Add ch to the line, writing the line to the port when full.
+  if (length >= echoLineSize) { port->write(line, length); length = 0; }
+  line[length++] = ch;
+}
+
 void Wisol::logBuffer(const __FlashStringHelper *prefix, const char *buffer,
                             uint8_t *markerPos, uint8_t markerCount) {
   //  Log the send/receive buffer for debugging.  markerPos is an array of positions in buffer
-  //  where the '>' marker was seen and removed.
+  //  where the '>' marker was seen and removed.  The line is formatted first and written in
+  //  as few calls as possible, so a buffered echo port isn't called for every byte.
+  char line[echoLineSize];
+  uint8_t length = 0;
   echoPort->print(prefix);
+  const int size = strlen(buffer);
   int m = 0, i = 0;
-  for (i = 0; i < strlen(buffer); i = i + 2) {
+  for (i = 0; i < size; i = i + 2) {
     if (m < markerCount && markerPos[m] == i) {
-      echoPort->print("0x");
-      echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE / 16]);
-      echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE % 16]);
+      addEcho(echoPort, line, length, '0');
+      addEcho(echoPort, line, length, 'x');
+      addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE / 16]);
+      addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE % 16]);
       m++;
     }
-    echoPort->write((uint8_t) buffer[i]);
-    echoPort->write((uint8_t) buffer[i + 1]);
+    addEcho(echoPort, line, length, buffer[i]);
+    if (i + 1 < size) addEcho(echoPort, line, length, buffer[i + 1]);
   }
   if (m < markerCount && markerPos[m] == i) {
-    echoPort->print("0x");
-    echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE / 16]);
-    echoPort->write((uint8_t) nibbleToHex[END_OF_RESPONSE % 16]);
+    addEcho(echoPort, line, length, '0');
+    addEcho(echoPort, line, length, 'x');
+    addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE / 16]);
+    addEcho(echoPort, line, length, nibbleToHex[END_OF_RESPONSE % 16]);
     m++;
   }
-  echoPort->write('\n');
+  addEcho(echoPort, line, length, '\n');
+  echoPort->write(line, length);
 }
-
+#endif  //  SIGFOX_LOG_LEVEL >= SIGFOX_LOG_DEBUG
@@ -26,6 +26,8 @@
 const uint8_t WISOL_TX = 4;  //  Transmit port for For UnaBiz / Wisol Dev Kit
 const uint8_t WISOL_RX = 5;  //  Receive port for UnaBiz / Wisol Dev Kit
 const unsigned int WISOL_COMMAND_TIMEOUT = 60000;  //  Wait up to 60 seconds for response from SIGFOX module.  Includes downlink response.
+const unsigned int WISOL_BREAK_TIME = 10;  //  Hold the transmit pin low this long (ms) to wake the module.
+const unsigned int WISOL_WAKEUP_TIME = 100;  //  Wait this long (ms) after the break for the module to wake up.
 
 class Wisol
 {
@@ -39,12 +41,18 @@ public:
   void setEchoPort(Print *port);  //  Set the port for sending echo output.
   void echo(const String &msg);  //  Echo the debug message.
   bool isReady();
+  SendError getLastError();  //  Return the result of the last send to the module.
+  void getStats(TransceiverStats &stats);  //  Return the command and uplink stats since the last clearStats().
+  void clearStats();  //  Reset the stats.
   bool sendMessage(const String &payload);  //  Send the payload of hex digits to the network, max 12 bytes.
-  bool sendMessageAndGetResponse(const String &payload, String &response);  //  Send the payload of hex digits to the network and get response.
+  bool sendMessageAndGetResponse(const String &payload, String &response);  //  Send the payload of hex digits to the network and get the 16 hex digits of the downlink, or "" if none came.
   bool sendString(const String &str);  //  Sending a text string, max 12 characters allowed.
   bool receive(String &data);  //  Receive a message.
   bool enterCommandMode();  //  Enter Command Mode for sending module commands, not data.
   bool exitCommandMode();  //  Exit Command Mode so we can send data.
+  bool sleep();  //  Put the module to sleep (< 1.5 uA) until wake() is called.
+  bool wake();  //  Wake up the module.  Called automatically when sending.
+  bool isSleeping();  //  Return true if the module has been put to sleep.
 
   //  Commands for the module, must be run in Command Mode.
   bool getEmulator(int &result);  //  Return 0 if emulator mode disabled, else return 1.
@@ -82,14 +90,16 @@ public:
   String toHex(double d);
   String toHex(char c);
   String toHex(char *c, int length);
+  uint8_t hexDigitToDecimal(char ch);  //  Convert 0..9, a..f, A..F to decimal.
 
 private:
-  bool sendCommand(const String &cmd, uint8_t expectedMarkers,
+  bool sendCommand(uint8_t index, uint8_t expectedMarkers,
                    String &result, uint8_t &actualMarkers);
-  bool sendBuffer(const String &buffer, int timeout, uint8_t expectedMarkers,
-                  String &dataOut, uint8_t &actualMarkers);
+  //  Send the command at index in the flash command table, the payload and the suffix in flash.
+  bool sendBuffer(uint8_t index, const char *payload, const char *suffix, int timeout,
+                  uint8_t expectedMarkers, String &dataOut, uint8_t &actualMarkers);
   bool setFrequency(int zone, String &result);
-  uint8_t hexDigitToDecimal(char ch);
+  void recordUplink(bool status, unsigned long uplinkStart);  //  Update the uplink stats.
   void logBuffer(const __FlashStringHelper *prefix, const char *buffer,
                  uint8_t markerPos[], uint8_t markerCount);
 
@@ -98,9 +108,15 @@ private:
   bool useEmulator;  //  Set to true if using UnaBiz Emulator.
   String device;  //  Name of device if using UnaBiz Emulator.
   SoftwareSerial *serialPort;  //  Serial port for the SIGFOX module.
+  uint8_t txPin;  //  Transmit pin, needed for sending the wake up break.
+  bool sleeping;  //  True if the module has been put to sleep.
   Print *echoPort;  //  Port for sending echo output.  Defaults to Serial.
   Print *lastEchoPort;  //  Last port used for sending echo output.
   unsigned long lastSend;  //  Timestamp of last send.
+  SendError lastError;  //  Result of the last send to the module.
+  //  Command and uplink stats, allocated only if the library itself is built with SIGFOX_STATS,
+  //  so that the layout doesn't depend on how the sketch sets it.
+  TransceiverStats *stats;
   bool setOutputPower();
 };
 
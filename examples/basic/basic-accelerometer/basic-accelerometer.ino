@@ -12,12 +12,21 @@
 #include <Adafruit_Sensor.h>
 #include <Adafruit_MMA8451.h>
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "acc::float:32 orientation::char:3";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 //必要に応じ書き換えてください
 //************************************
 static const bool isDebug = true;
 static const float ACC_THRESHOLD = 1; //移動判定閾値
+static const float ACC_HYSTERESIS = 0.2; //静止判定には ACC_THRESHOLD - ACC_HYSTERESIS 未満が必要
+static const unsigned long MIN_SEND_INTERVAL = 2000; //送信の最小間隔(ミリ秒)
 //************************************
 
+static const uint8_t CH_ACC = 0;  //加速度チャネル
+static Trigger trigger;  //送信判断のルール
+
 Adafruit_MMA8451 mma = Adafruit_MMA8451();
 
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
@@ -27,6 +36,7 @@ static const bool echo = true;  //  Set to true if the SIGFOX library should dis
 static const Country country = COUNTRY_JP;  //  Set this to your country to configure the SIGFOX transmission frequencies.
 static UnaShieldV2S transceiver(country, useEmulator, device, echo);  //  Uncomment this for UnaBiz UnaShield V2S Dev Kit
 static String response;  //  Will store the downlink response from SIGFOX.
+static UplinkQueue uplinks(transceiver);  //  Messages waiting to be sent.
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 
 void setup()
@@ -51,6 +61,9 @@ void setup()
   
   Serial.print("Range = "); Serial.print(2 << mma.getRange());  
   Serial.println("G");
+
+  //動き始めた時(ヒステリシス付き)に送信する
+  trigger.addCrossing(CH_ACC, ACC_THRESHOLD, ACC_HYSTERESIS, 0, MIN_SEND_INTERVAL);
 }
 
 void loop()
@@ -71,26 +84,33 @@ void loop()
   //加速度を計算
   float acc = calcAcc(event.acceleration.x, event.acceleration.y, event.acceleration.z);
 
-  //所定の加速度以上であれば、Sigfoxメッセージ送信
-  if (abs(acc - 9.8) >= ACC_THRESHOLD)
+  //所定の加速度以上になったら、Sigfoxメッセージ送信
+  if (trigger.sample(CH_ACC, abs(acc - 9.8)) && trigger.isAbove(CH_ACC))
   {
-    sendSigfoxMessage(acc, o);
-    delay(2000);
+    queueSigfoxMessage(acc, o);
   }
 
+  //送信待ちのメッセージを送信
+  if (uplinks.isDue()) sendSigfoxMessage();
   delay(500);
 }
 
-//ボタン押下をSigfoxメッセージで送信する
-void sendSigfoxMessage(float acc, uint8_t orientation) 
+//加速度と方向をSigfoxメッセージとして送信待ちにする
+void queueSigfoxMessage(float acc, uint8_t orientation) 
+{
+  payload.set<payload.field("acc")>(acc);
+  payload.set<payload.field("orientation")>(orientationName(orientation));
+  Serial.print("ACC: "); Serial.println(acc);
+  Serial.print("Orientation: "); Serial.print(orientation); Serial.print(" -> "); Serial.println(orientationName(orientation));
+  Serial.print("Payload: "); Serial.println(payload.hex());
+  uplinks.push(payload.hex());
+}
+
+//送信待ちのSigfoxメッセージを送信する
+void sendSigfoxMessage() 
 {
   Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  String sAcc = convertFloatToHex(acc);
-  String sOrientation = convertOrientationToHex(orientation);
-  Serial.print("ACC: "); Serial.print(acc); Serial.print(" -> 0x"); Serial.println(sAcc);
-  Serial.print("Orientation: "); Serial.print(orientation); Serial.print(" -> 0x"); Serial.println(sOrientation);
-  Serial.print("Payload: "); Serial.println(sAcc + sOrientation);  
-  transceiver.sendMessage(sAcc + sOrientation);
+  uplinks.sendNext();
   Serial.println("*****************************");
 }
 
@@ -156,46 +176,18 @@ void displayMM8451Orientation(uint8_t o)
   Serial.println();
 }
 
-String convertOrientationToHex(uint8_t o)
+//方向を3文字で返す(orientation::char:3)
+const char *orientationName(uint8_t o)
 {
-  String sOrientation = "";
   switch (o) {
-    case MMA8451_PL_PUF: 
-      sOrientation = "505546";
-      break;
-    case MMA8451_PL_PUB: 
-      sOrientation = "505542";
-      break;    
-    case MMA8451_PL_PDF: 
-      sOrientation = "504446";
-      break;
-    case MMA8451_PL_PDB: 
-      sOrientation = "504442";
-      break;
-    case MMA8451_PL_LRF: 
-      sOrientation = "4C5246";
-      break;
-    case MMA8451_PL_LRB: 
-      sOrientation = "4C5242";
-      break;
-    case MMA8451_PL_LLF: 
-      sOrientation = "4C4C46";
-      break;
-    case MMA8451_PL_LLB: 
-      sOrientation = "4C4C42";
-      break;
-    }
-  return sOrientation;
-}
-
-//Float型変数をIEEE754に準拠した16進文字列へ変換する
-String convertFloatToHex(float val) 
-{
-  union {
-    uint32_t B32;
-    float Float;
-  } floatb32;
-
-  floatb32.Float = val;
-  return String(floatb32.B32, HEX);
+    case MMA8451_PL_PUF: return "PUF";
+    case MMA8451_PL_PUB: return "PUB";
+    case MMA8451_PL_PDF: return "PDF";
+    case MMA8451_PL_PDB: return "PDB";
+    case MMA8451_PL_LRF: return "LRF";
+    case MMA8451_PL_LRB: return "LRB";
+    case MMA8451_PL_LLF: return "LLF";
+    case MMA8451_PL_LLB: return "LLB";
+  }
+  return "";
 }
@@ -6,8 +6,16 @@
  */
 #include "SIGFOX.h"
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "button::bool:7";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 const int buttonPin = 6;    //ボタンPIN
 const int ledPin = 9;         //LED PIN
+static const unsigned long DEBOUNCE = 50;  //チャタリング除去時間(ミリ秒)
+static const unsigned long SAMPLE_INTERVAL = 10;  //ボタンの読み取り間隔(ミリ秒)
+static const uint8_t CH_BUTTON = 0;  //ボタンチャネル
+static Trigger trigger;  //送信判断のルール
 
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 static const String device = "NOTUSED";  //  Set this to your device name if you're using UnaBiz Emulator.
@@ -16,6 +24,7 @@ static const bool echo = true;  //  Set to true if the SIGFOX library should dis
 static const Country country = COUNTRY_JP;  //  Set this to your country to configure the SIGFOX transmission frequencies.
 static UnaShieldV2S transceiver(country, useEmulator, device, echo);  //  Uncomment this for UnaBiz UnaShield V2S Dev Kit
 static String response;  //  Will store the downlink response from SIGFOX.
+static UplinkQueue uplinks(transceiver);  //  Messages waiting to be sent.
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 
 void setup()
@@ -30,6 +39,17 @@ void setup()
   if (!transceiver.begin()) stop(F("Unable to init SIGFOX module, may be missing"));  //  Will never return.
 
   pinMode(ledPin, OUTPUT);
+
+  //ボタンが押された時(チャタリング除去付き)に送信する
+  trigger.addCrossing(CH_BUTTON, 1, 0, DEBOUNCE);
+
+  //最初の読み取りは判断の基準になるだけで送信されないため、起動時の状態はここで送信する
+  trigger.sample(CH_BUTTON, (digitalRead(buttonPin) == LOW) ? 1 : 0);
+  const bool pushed = trigger.isAbove(CH_BUTTON);
+  digitalWrite(ledPin, pushed ? HIGH : LOW);
+  payload.set<payload.field("button")>(pushed);
+  Serial.print("Initial payload: "); Serial.println(payload.hex());
+  uplinks.push(payload.hex());
 }
 
 void loop()
@@ -37,24 +57,35 @@ void loop()
   //ボタン押下状態を取得する
   int buttonState = digitalRead(buttonPin);
 
-  if (buttonState == LOW)
+  //押下状態の変化を判断する
+  if (trigger.sample(CH_BUTTON, (buttonState == LOW) ? 1 : 0))
   {
-    digitalWrite(ledPin, HIGH);
-    Serial.println(F("Pushed"));
-    sendSigfoxMessage();
-  }
-  else 
-  {
-    digitalWrite(ledPin, LOW);
-    Serial.println(F("Not Pushed"));    
+    if (trigger.isAbove(CH_BUTTON))
+    {
+      digitalWrite(ledPin, HIGH);
+      Serial.println(F("Pushed"));
+      payload.set<payload.field("button")>(true);  //bool:7 -> 0x80
+      Serial.print("Payload: "); Serial.println(payload.hex());
+      uplinks.push(payload.hex());
+    }
+    else 
+    {
+      digitalWrite(ledPin, LOW);
+      Serial.println(F("Not Pushed"));    
+    }
   }
+
+  //送信待ちのメッセージを送信
+  if (uplinks.isDue()) sendSigfoxMessage();
+
+  //次の読み取りまで待つ(モジュールの準備ができるまで空回りしない)
+  delay(SAMPLE_INTERVAL);
 }
 
 //ボタン押下をSigfoxメッセージで送信する
 void sendSigfoxMessage() 
 {
   Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  Serial.print("Payload: "); Serial.println("80");  //0x80 : 10000000
-  transceiver.sendMessage("80");
+  uplinks.sendNext();
   Serial.println("*****************************");
 }
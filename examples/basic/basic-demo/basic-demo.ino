@@ -8,14 +8,29 @@
  */
 #include "SIGFOX.h"
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "count::uint:16:little-endian temperature::float:32 voltage::float:32";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 //必要に応じ書き換えてください
 //************************************
 static const unsigned int MESSAGE_INTERVAL = 30000;   //Sigfoxメッセージ送信間隔(30秒)
 static const unsigned int MAX_MESSAGE_CNT = 10;         //Sigfoxメッセージ最大送信数(10回)
+static const bool useSleep = true;  //送信間隔中にSigfoxモジュールとArduinoをスリープさせる
+static const float BATTERY_MAH = 2000;  //電池容量(mAh)、電池寿命の目安表示用
+static const uint8_t DOWNLINK_EVERY = 4;  //ダウンリンクで設定を受信する間隔(4回に1回、0で受信しない)
 //************************************
 
 unsigned int message_cnt = 0;
 
+//ダウンリンクで変更できる設定(8バイト: バージョン, ダウンリンク間隔, 送信間隔(秒), 最大送信数, 予備 ※各int16リトルエンディアン)
+static const uint8_t CONFIG_INTERVAL = 0;   //送信間隔(秒)
+static const uint8_t CONFIG_MAX_COUNT = 1;  //最大送信数
+static const int16_t configDefaults[CONFIG_PARAMS] = { MESSAGE_INTERVAL / 1000, MAX_MESSAGE_CNT, 0 };
+//ダウンリンクの設定はこの範囲外なら受け付けない(送信間隔0秒や、約49日のパワーダウンを防ぐ)
+static const int16_t configMinimums[CONFIG_PARAMS] = { 10, 1, -32768 };
+static const int16_t configMaximums[CONFIG_PARAMS] = { 3600, 1000, 32767 };
+
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 static const String device = "NOTUSED";  //  Set this to your device name if you're using UnaBiz Emulator.
 static const bool useEmulator = false;  //  Set to true if using UnaBiz Emulator.
@@ -23,18 +38,33 @@ static const bool echo = true;  //  Set to true if the SIGFOX library should dis
 static const Country country = COUNTRY_JP;  //  Set this to your country to configure the SIGFOX transmission frequencies.
 static UnaShieldV2S transceiver(country, useEmulator, device, echo);  //  Uncomment this for UnaBiz UnaShield V2S Dev Kit
 static String response;  //  Will store the downlink response from SIGFOX.
+static Config config(transceiver, configDefaults, DOWNLINK_EVERY, configMinimums, configMaximums);  //  Settings that can be changed by downlink.
+static Supervisor supervisor(transceiver);  //  Watchdog and recovery when the module stops responding.
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 
 void setup()
 {
+  //前回の起動理由(ウォッチドッグによるリセットなど)をEEPROMに記録する
+  supervisor.begin();
   Serial.begin(9600);         // Arduinoハードウェアシリアルを起動(Arduino <-> PC)
   Serial.println("===========================");
   Serial.println("Sigfox UnaShield Basic Sample");
   Serial.print("Send a message in "); Serial.print(MAX_MESSAGE_CNT); Serial.print(" times for each "); Serial.print(MESSAGE_INTERVAL); Serial.println(" msec.");
   Serial.println("===========================");
   
-  //Sigfoxモジュールを起動
-  if (!transceiver.begin()) stop(F("Unable to init SIGFOX module, may be missing"));  //  Will never return.
+  Serial.print("Start cause: "); Serial.println(supervisor.getStartCause());
+
+  //Sigfoxモジュールを起動(応答しない場合はモジュールのリセット、最後はArduinoのリセットで復旧を試みる)
+  supervisor.beginModule();
+  transceiver.clearStats();  //起動時のコマンドを消費電荷の推定に含めない
+#if !SIGFOX_STATS
+  //消費電荷の推定には統計が必要(Arduino IDEの既定では無効)
+  Serial.println(F("No energy estimate: compile with -DSIGFOX_STATS=1 to enable the stats."));
+#endif  //  !SIGFOX_STATS
+
+  //EEPROMから設定を読み込む(未設定の場合は初期値)
+  config.begin();
+  Serial.print("Config version: "); Serial.println(config.getVersion());
 
   Serial.println("Waiting 3 seconds...");
   delay(3000);
@@ -42,50 +72,73 @@ void setup()
 
 void loop()
 { 
+  //モジュールとの通信をウォッチドッグで監視し、タイムアウトが続いたら段階的に復旧する
+  supervisor.arm();
   //温度、バッテリー電圧を取得する
   float temperature = 0;
   float voltage = 0;
   transceiver.getTemperature(temperature);
   transceiver.getVoltage(voltage);
   
-  if (sendSigfoxMessage(message_cnt, temperature, voltage)) 
+  const bool sent = sendSigfoxMessage(message_cnt, temperature, voltage);
+  supervisor.disarm();
+  if (sent)
   {
     message_cnt++;
   }
 
-  if (message_cnt >= MAX_MESSAGE_CNT) 
+  if (message_cnt >= (unsigned int) config.get(CONFIG_MAX_COUNT)) 
+  {
+    transceiver.sleep();
+    halt(String("finish...(Message sent successfully)"));
+  }
+
+  unsigned long interval = config.get(CONFIG_INTERVAL) * 1000UL;
+
+#if SIGFOX_STATS
+  //送信時に計測した通信時間から、送信1回・ダウンリンク1回・1日あたりの消費電荷と電池寿命の目安を表示する
+  //(統計は-DSIGFOX_STATS=1でコンパイルした場合のみ)
+  //スリープしない場合は、送信間隔中もモジュールとArduinoが起きている電流で計算する
+  CurrentProfile profile = DEFAULT_CURRENT_PROFILE;
+  if (!useSleep) { profile.moduleSleep = profile.moduleIdle; profile.mcuSleep = profile.mcuActive; }
+  TransceiverStats stats;
+  EnergyEstimate energy;
+  transceiver.getStats(stats);
+  if (estimateEnergy(stats, interval, energy, profile))
   {
-    stop(String("finish...(Message sent successfully)"));
+    Serial.print("Estimated charge (uAh) per uplink: "); Serial.print(energy.perUplink);
+    Serial.print(" / per downlink: "); Serial.print(energy.perDownlink);
+    Serial.print(" / per day: "); Serial.println(energy.perDay);
+    Serial.print("Estimated battery life (days): "); Serial.println(BATTERY_MAH * 1000 / energy.perDay);
   }
+#endif  //  SIGFOX_STATS
 
-  Serial.print("Waiting "); Serial.print(MESSAGE_INTERVAL/1000); Serial.println(" seconds...");
-  delay(MESSAGE_INTERVAL);  
+  Serial.print("Waiting "); Serial.print(interval/1000); Serial.println(" seconds...");
+  if (useSleep)
+  {
+    //Sigfoxモジュールをスリープさせ、次の送信までArduinoをパワーダウンする(次の送信時に自動で起床)
+    transceiver.sleep();
+    Serial.flush();
+    powerDown(interval);
+  }
+  else
+  {
+    delay(interval);  
+  }
 }
 
 //送信回数と温度、バッテリー電圧をSigfoxメッセージで送信する
 bool sendSigfoxMessage(unsigned int cnt, float temperature, float voltage) 
 {
   Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  String sCnt = transceiver.toHex(cnt);
-  String sTemp = convertFloatToHex(temperature);
-  String sVoltage = convertFloatToHex(voltage);
+  payload.set<payload.field("count")>(cnt);
+  payload.set<payload.field("temperature")>(temperature);
+  payload.set<payload.field("voltage")>(voltage);
   Serial.print("Count: "); Serial.print(cnt);
   Serial.print(" / Temperature: "); Serial.print(temperature); 
   Serial.print(" / Voltage: "); Serial.println(voltage);
-  Serial.print("Payload: "); Serial.println(sCnt + sTemp + sVoltage);
-  bool success = transceiver.sendMessage(sCnt + sTemp + sVoltage);
+  Serial.print("Payload: "); Serial.println(payload.hex());
+  bool success = config.sendMessage(payload.hex());  //DOWNLINK_EVERY回に1回ダウンリンクで設定を受信
   Serial.println("*****************************");
   return success;
 }
-
-//Float型変数をIEEE754に準拠した16進文字列へ変換する
-String convertFloatToHex(float val) 
-{
-  union {
-    uint32_t B32;
-    float Float;
-  } floatb32;
-
-  floatb32.Float = val;
-  return String(floatb32.B32, HEX);
-}
@@ -13,6 +13,10 @@
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BME280.h>
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "temperature::float:32 humidity::float:32 pressure::uint:16 altitude::int:16";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 #define SEALEVELPRESSURE_HPA (1013.25)
 
 Adafruit_BME280 bme; // I2C
@@ -67,7 +71,7 @@ void loop()
 
   if (message_cnt >= MAX_MESSAGE_CNT) 
   {
-    stop(String("finish...(Message sent successfully)"));
+    halt(String("finish...(Message sent successfully)"));
   }
 
   Serial.print("Waiting "); Serial.print(MESSAGE_INTERVAL/1000); Serial.println(" seconds...");
@@ -78,28 +82,16 @@ void loop()
 bool sendSigfoxMessage(float temperature, float humidity, unsigned int pressure, int altitude) 
 {
   Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  String sTemp = convertFloatToHex(temperature);
-  String sHumid = convertFloatToHex(humidity);
-  String sPressure = transceiver.toHex(pressure);
-  String sAltitude = transceiver.toHex(altitude);
-  Serial.print("Temp: "); Serial.print(temperature); Serial.print(" *C -> 0x"); Serial.println(sTemp);
-  Serial.print("Humid: "); Serial.print(humidity);  Serial.print(" % -> 0x"); Serial.println(sHumid);
-  Serial.print("Pressure: "); Serial.print(pressure); Serial.print(" hPa -> 0x"); Serial.println(sPressure);
-  Serial.print("Altitude: "); Serial.print(altitude); Serial.print(" m -> 0x"); Serial.println(sAltitude);
-  Serial.print("Payload: "); Serial.println(sTemp + sHumid + sPressure + sAltitude);
-  bool success = transceiver.sendMessage(sTemp + sHumid + sPressure + sAltitude);
+  payload.set<payload.field("temperature")>(temperature);
+  payload.set<payload.field("humidity")>(humidity);
+  payload.set<payload.field("pressure")>(pressure);
+  payload.set<payload.field("altitude")>(altitude);
+  Serial.print("Temp: "); Serial.print(temperature); Serial.println(" *C");
+  Serial.print("Humid: "); Serial.print(humidity); Serial.println(" %");
+  Serial.print("Pressure: "); Serial.print(pressure); Serial.println(" hPa");
+  Serial.print("Altitude: "); Serial.print(altitude); Serial.println(" m");
+  Serial.print("Payload: "); Serial.println(payload.hex());
+  bool success = transceiver.sendMessage(payload.hex());
   Serial.println("*****************************");
   return success;
 }
-
-//Float型変数をIEEE754に準拠した16進文字列へ変換する
-String convertFloatToHex(float val) 
-{
-  union {
-    uint32_t B32;
-    float Float;
-  } floatb32;
-
-  floatb32.Float = val;
-  return String(floatb32.B32, HEX);
-}
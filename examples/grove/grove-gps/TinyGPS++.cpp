@@ -114,17 +114,20 @@ int TinyGPSPlus::fromHex(char a)
 // Parse a (potentially negative) number with up to 2 decimal digits -xxxx.yy
 int32_t TinyGPSPlus::parseDecimal(const char *term)
 {
+  // Unsigned, so that too many digits wrap instead of overflowing
   bool negative = *term == '-';
   if (negative) ++term;
-  int32_t ret = 100 * (int32_t)atol(term);
-  while (isdigit(*term)) ++term;
+  uint32_t ret = 0;
+  while (isdigit(*term))
+    ret = 10 * ret + (*term++ - '0');
+  ret *= 100;
   if (*term == '.' && isdigit(term[1]))
   {
     ret += 10 * (term[1] - '0');
     if (isdigit(term[2]))
       ret += term[2] - '0';
   }
-  return negative ? -ret : ret;
+  return (int32_t)(negative ? 0 - ret : ret);
 }
 
 // static
@@ -330,7 +333,10 @@ double TinyGPSPlus::courseTo(double lat1, double long1, double lat2, double long
 const char *TinyGPSPlus::cardinal(double course)
 {
   static const char* directions[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE", "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
-  int direction = (int)((course + 11.25f) / 22.5f);
+  // Courses outside 0 to 360, or not a number, would index outside the table
+  double sector = fmod((course + 11.25f) / 22.5f, 16.0);
+  if (!(sector >= 0)) sector = sector < 0 ? sector + 16 : 0;
+  int direction = (int)sector;
   return directions[direction % 16];
 }
 
@@ -7,16 +7,24 @@
 #include "TinyGPS++.h"
 #include <SoftwareSerial.h>
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "lat::float:32 lng::float:32";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 //必要に応じ書き換えてください
 //************************************
 static const bool isDebug = true;
 static const double DISTANCE = 5; //DISTANCE(m)移動時にSigfox送信
+static const unsigned long CHECK_INTERVAL = 1000; //GPS緯度経度の確認間隔(ミリ秒)
+static const unsigned long READ_INTERVAL = 10; //GPSデータの読み取り間隔(ミリ秒)。9600bpsでSoftwareSerialの受信バッファ(64バイト)が溢れる前に読む
 //************************************
 
 TinyGPSPlus gps;
 SoftwareSerial SoftSerial(A3,A2);
 float lastLat = 0;
 float lastLng = 0;
+static bool newData = false; //GPSデータのencodeに成功したかどうか？
+static Scheduler scheduler;  //GPS読み取りと送信のタスク
 
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 static const String device = "NOTUSED";  //  Set this to your device name if you're using UnaBiz Emulator.
@@ -39,46 +47,55 @@ void setup()
   //Sigfoxモジュールを起動
   if (!transceiver.begin()) stop(F("Unable to init SIGFOX module, may be missing"));  //  Will never return.
 
+  //GPSデータは読み取りタスクでこまめに読み、緯度経度は1秒間隔で確認する
+  scheduler.every(scheduler.add(readGps), READ_INTERVAL);
+  scheduler.every(scheduler.add(checkGps), CHECK_INTERVAL);
 }
 
 void loop()
 { 
-  bool newData = false; //GPSデータのencodeに成功したかどうか？
-
-  SoftSerial.listen();  //SoftSerialをlisten (UnaShieldのモジュールシリアルとの関係上、必須）
+  //期限が来たタスクを実行
+  scheduler.run();
+}
 
-  //1秒間隔でGPSデータを取得する
-  for (unsigned long start = millis(); millis() - start < 1000;) 
+//届いているGPSデータを読む(届くのを待たない)
+void readGps(void *)
+{
+  //SoftSerialをlisten (UnaShieldのモジュールシリアルとの関係上、必須）
+  //listenを呼ぶため、バックグラウンドにはしない
+  if (!SoftSerial.isListening()) SoftSerial.listen();
+  while (SoftSerial.available()) 
   {
-    while (SoftSerial.available()) 
+    char c = SoftSerial.read();
+    if (isDebug) Serial.write(c);
+    if (gps.encode(c)) 
     {
-      char c = SoftSerial.read();
-      if (isDebug) Serial.write(c);
-      if (gps.encode(c)) 
-      {
-        newData = true;
-      }
+      newData = true;
     }
   }
-  
-  if (newData)
+}
+
+//GPS緯度経度が移動していればSigfoxで送信
+void checkGps(void *)
+{
+  if (!newData) return;
+  newData = false;
+  if (gps.location.isUpdated()) 
   {
-    if (gps.location.isUpdated()) 
+    monitorGpsInfo(); //GPSデコード情報を表示
+    //GPS緯度経度取得
+    float lat = (float)gps.location.lat();
+    float lng = (float)gps.location.lng();
+    //以前の緯度経度との距離を取得
+    double dist = getDistanceBetween(lat, lng, lastLat, lastLng);
+    if (dist >= DISTANCE)   //GPS緯度経度が移動していたら
     {
-      monitorGpsInfo(); //GPSデコード情報を表示
-      //GPS緯度経度取得
-      float lat = (float)gps.location.lat();
-      float lng = (float)gps.location.lng();
-      //以前の緯度経度との距離を取得
-      double dist = getDistanceBetween(lat, lng, lastLat, lastLng);
-      if (dist >= DISTANCE)   //GPS緯度経度が移動していたら
-      {
-        //Sigfoxで緯度経度を送信
-        sendSigfoxMessage(lat, lng);
-        lastLat = lat;
-        lastLng = lng;
-        delay(2000);
-      }
+      //Sigfoxで緯度経度を送信
+      sendSigfoxMessage(lat, lng);
+      lastLat = lat;
+      lastLng = lng;
+      //次の確認は2秒後から
+      scheduler.every(scheduler.current(), CHECK_INTERVAL, 2000);
     }
   }
 }
@@ -87,11 +104,12 @@ void loop()
 void sendSigfoxMessage(float lat, float lng) 
 {
   Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  String sLat = convertFloatToHex(lat);
-  String sLng = convertFloatToHex(lng);
-  Serial.print("Latitude: "); Serial.print(lat, 5); Serial.print(" -> 0x"); Serial.println(sLat);
-  Serial.print("Longitude: "); Serial.print(lng, 5); Serial.print(" -> 0x"); Serial.println(sLng);
-  transceiver.sendMessage(sLat + sLng);
+  payload.set<payload.field("lat")>(lat);
+  payload.set<payload.field("lng")>(lng);
+  Serial.print("Latitude: "); Serial.println(lat, 5);
+  Serial.print("Longitude: "); Serial.println(lng, 5);
+  Serial.print("Payload: "); Serial.println(payload.hex());
+  transceiver.sendMessage(payload.hex());
   Serial.println("*****************************");
 }
 
@@ -115,15 +133,3 @@ double getDistanceBetween(float currLat, float currLng, float lastLat, float las
   Serial.println("*************************");   
   return distance;
 }
-
-//Float型変数をIEEE754に準拠した16進文字列へ変換する
-String convertFloatToHex(float val) 
-{
-  union {
-    uint32_t B32;
-    float Float;
-  } floatb32;
-
-  floatb32.Float = val;
-  return String(floatb32.B32, HEX);
-}
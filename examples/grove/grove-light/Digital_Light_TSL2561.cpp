@@ -73,9 +73,17 @@ void TSL2561_CalculateLux::init()
 }
 
 signed long TSL2561_CalculateLux::readVisibleLux()
+{
+   startVisibleLux();
+   delay(TSL2561_INTEGRATION_TIME);
+   return finishVisibleLux();
+}
+void TSL2561_CalculateLux::startVisibleLux()
 {
    writeRegister(TSL2561_Address,TSL2561_Control,0x03);  // POWER UP
-   delay(14);
+}
+signed long TSL2561_CalculateLux::finishVisibleLux()
+{
    getLux();
 
    writeRegister(TSL2561_Address,TSL2561_Control,0x00);  // POWER Down
@@ -100,10 +100,14 @@
 #define K8C 0x029a   // 1.3 * 2^RATIO_SCALE
 #define B8C 0x0000   // 0.000 * 2^LUX_SCALE
 #define M8C 0x0000   // 0.000 * 2^LUX_SCALE
+
+#define TSL2561_INTEGRATION_TIME 14  // ms from startVisibleLux() to finishVisibleLux(), 13.7 ms integration
 class TSL2561_CalculateLux
 {
  public:
   signed long readVisibleLux();
+  void startVisibleLux(void);          // power up, measuring starts
+  signed long finishVisibleLux(void);  // read after TSL2561_INTEGRATION_TIME ms and power down
   unsigned long calculateLux(unsigned int iGain, unsigned int tInt,int iType);
   void getLux(void);
   void init(void);
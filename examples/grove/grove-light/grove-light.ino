@@ -9,14 +9,27 @@
 #include "Digital_Light_TSL2561.h"
 #include <Wire.h>
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "lux::uint:16:little-endian isBright::bool:7";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 //必要に応じ書き換えてください
 //************************************
 static const bool isDebug = true;
 static const int LIGHT_THRESHOLD = 40; //明暗判断の閾値(Lux)
+static const int LIGHT_HYSTERESIS = 10; //明→暗と判断するには LIGHT_THRESHOLD - LIGHT_HYSTERESIS 未満になる必要あり(Lux)
+static const unsigned long MIN_SEND_INTERVAL = 2000; //送信の最小間隔(ミリ秒)
+static const unsigned long SAMPLE_INTERVAL = 500; //照度の測定間隔(ミリ秒)
 //************************************
 
 const int ledPin = 9;
-bool lastLightState = false;
+static const uint8_t CH_LIGHT = 0;  //照度チャネル
+static Trigger trigger;  //送信判断のルール
+static Scheduler scheduler;  //測定と送信のタスク
+static int8_t readTask;  //照度の読み取りタスク
+static bool pending = false;  //送信待ちにする照度があるか
+static int pendingLux;
+static bool pendingBright;
 
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 static const String device = "NOTUSED";  //  Set this to your device name if you're using UnaBiz Emulator.
@@ -25,6 +38,7 @@ static const bool echo = true;  //  Set to true if the SIGFOX library should dis
 static const Country country = COUNTRY_JP;  //  Set this to your country to configure the SIGFOX transmission frequencies.
 static UnaShieldV2S transceiver(country, useEmulator, device, echo);  //  Uncomment this for UnaBiz UnaShield V2S Dev Kit
 static String response;  //  Will store the downlink response from SIGFOX.
+static UplinkQueue uplinks(transceiver);  //  Messages waiting to be sent.
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 
 void setup()
@@ -44,37 +58,69 @@ void setup()
 
   //明暗LED
   pinMode(ledPin, OUTPUT);
+
+  //明暗の変化(ヒステリシス付き)で送信する
+  trigger.addCrossing(CH_LIGHT, LIGHT_THRESHOLD, LIGHT_HYSTERESIS, 0, MIN_SEND_INTERVAL);
+
+  //測定はSigfox送信中(約6秒)もバックグラウンドで続ける
+  int8_t startTask = scheduler.add(startLight);
+  readTask = scheduler.add(readLight);
+  scheduler.setBackground(startTask, true);
+  scheduler.setBackground(readTask, true);
+  scheduler.every(startTask, SAMPLE_INTERVAL);
+  scheduler.every(scheduler.add(sendTask), SAMPLE_INTERVAL);
+  scheduler.begin();
 }
 
 void loop()
 { 
-  //Lightセンサから照度を取得
-  int lux = TSL2561.readVisibleLux();
+  //期限が来たタスクを実行
+  scheduler.run();
+}
+
+//Lightセンサの測定を開始し、測定が終わる頃に読み取る(delayで待たない)
+void startLight(void *)
+{
+  TSL2561.startVisibleLux();
+  scheduler.after(readTask, TSL2561_INTEGRATION_TIME);
+}
+
+//Lightセンサから照度を取得
+void readLight(void *)
+{
+  int lux = TSL2561.finishVisibleLux();
   if (isDebug) {Serial.print("Light(lux): "); Serial.println(lux);}
   
-  //明暗判断
-  bool lightState = (lux >= LIGHT_THRESHOLD) ? true : false;
+  //明暗判断(明暗の変化時にSigfoxで照度を送信)
+  bool changed = trigger.sample(CH_LIGHT, lux);
+  bool lightState = trigger.isAbove(CH_LIGHT);
+  if (changed) { pending = true; pendingLux = lux; pendingBright = lightState; }
   
   //LEDを明暗にあわせてON/OFFする
   digitalWrite(ledPin, lightState);
-  //明暗の変化時にSigfoxで照度を送信
-  if (lightState != lastLightState)
-  {
-    sendSigfoxMessage(lux, lightState);
-    lastLightState = lightState;
-    delay(2000);
-  }
-  delay(500);  
 }
 
-//照度と明暗をSigfoxメッセージで送信する
-void sendSigfoxMessage(int lux, bool isBright) 
+//送信待ちのメッセージを送信(送信中のキューを変えないよう、バックグラウンドにしない)
+void sendTask(void *)
 {
-  Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  String sLux = transceiver.toHex(lux);
-  String sIsBright = (isBright) ? "80" : "00"; //0x80(1000000) / 0x00(00000000)
+  if (pending) { pending = false; queueSigfoxMessage(pendingLux, pendingBright); }
+  if (uplinks.isDue()) sendSigfoxMessage();
+}
+
+//照度と明暗をSigfoxメッセージとして送信待ちにする
+void queueSigfoxMessage(int lux, bool isBright) 
+{
+  payload.set<payload.field("lux")>(lux);
+  payload.set<payload.field("isBright")>(isBright);  //bool:7 -> 0x80 / 0x00
   Serial.print("IsBright: "); Serial.println(isBright);
-  Serial.print("Payload: "); Serial.println(sLux + sIsBright);
-  transceiver.sendMessage(sLux + sIsBright);
+  Serial.print("Payload: "); Serial.println(payload.hex());
+  uplinks.push(payload.hex());
+}
+
+//送信待ちのSigfoxメッセージを送信する
+void sendSigfoxMessage() 
+{
+  Serial.println("\n*****SEND SIGFOX MESSAGE*****");
+  uplinks.sendNext();
   Serial.println("*****************************");
 }
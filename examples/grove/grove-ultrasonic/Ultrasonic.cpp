@@ -68,21 +68,27 @@ Ultrasonic::Ultrasonic(int pin)
 /*The measured distance from the range 0 to 400 Centimeters*/
 long Ultrasonic::MeasureInCentimeters(void)
 {
-	pinMode(_pin, OUTPUT);
-	digitalWrite(_pin, LOW);
-	delayMicroseconds(2);
-	digitalWrite(_pin, HIGH);
-	delayMicroseconds(5);
-	digitalWrite(_pin,LOW);
-	pinMode(_pin,INPUT);
-	long duration;
-	duration = pulseIn(_pin,HIGH);
-	long RangeInCentimeters;
-	RangeInCentimeters = duration/29/2;
-	return RangeInCentimeters;
+	return MeasureInCentimeters(1000000L);
 }
 /*The measured distance from the range 0 to 157 Inches*/
 long Ultrasonic::MeasureInInches(void)
+{
+	return MeasureInInches(1000000L);
+}
+/*Waits at most timeout us for the echo, e.g. ULTRASONIC_TIMEOUT between other tasks*/
+long Ultrasonic::MeasureInCentimeters(unsigned long timeout)
+{
+	long RangeInCentimeters;
+	RangeInCentimeters = measure(timeout)/29/2;
+	return RangeInCentimeters;
+}
+long Ultrasonic::MeasureInInches(unsigned long timeout)
+{
+	long RangeInInches;
+	RangeInInches = measure(timeout)/74/2;
+	return RangeInInches;
+}
+long Ultrasonic::measure(unsigned long timeout)
 {
 	pinMode(_pin, OUTPUT);
 	digitalWrite(_pin, LOW);
@@ -92,8 +98,6 @@ long Ultrasonic::MeasureInInches(void)
 	digitalWrite(_pin,LOW);
 	pinMode(_pin,INPUT);
 	long duration;
-	duration = pulseIn(_pin,HIGH);
-	long RangeInInches;
-	RangeInInches = duration/74/2;
-	return RangeInInches;
-}
\ No newline at end of file
+	duration = pulseIn(_pin,HIGH,timeout);
+	return duration;
+}
@@ -33,13 +33,18 @@
 
 #include "Arduino.h"
 
+#define ULTRASONIC_TIMEOUT 30000  // us, a little more than the echo from 400 cm
+
 class Ultrasonic
 {
 	public:
 		Ultrasonic(int pin);
 		long MeasureInCentimeters(void);
 		long MeasureInInches(void);
+		long MeasureInCentimeters(unsigned long timeout);  // 0 if no echo within timeout us
+		long MeasureInInches(unsigned long timeout);
 	private:
+		long measure(unsigned long timeout);
 		int _pin;//pin number of Arduino that is connected with SIG pin of Ultrasonic Ranger.
 };
 
@@ -14,15 +14,27 @@
 #include "Ultrasonic.h"
 #include <Wire.h>
 
+//コールバックのCustom Payload Config(ペイロードはこの設定から作成されます)
+extern constexpr char PAYLOAD_CONFIG[] = "distance::uint:16:little-endian isDetected::bool:7";
+static PayloadEncoder<PAYLOAD_CONFIG> payload;
+
 //必要に応じ書き換えてください
 //************************************
 static const bool isDebug = true;
 static const int DISTANCE_DETECTED = 100; //検知距離(cm)
+static const int DISTANCE_HYSTERESIS = 10; //検知解除には DISTANCE_DETECTED 以上、検知には DISTANCE_DETECTED - DISTANCE_HYSTERESIS 未満が必要(cm)
+static const unsigned long MIN_SEND_INTERVAL = 2000; //送信の最小間隔(ミリ秒)
+static const unsigned long SAMPLE_INTERVAL = 500; //距離の測定間隔(ミリ秒)
 //************************************
 
 Ultrasonic ultrasonic(A3);
 const int ledPin = 9;
-bool lastDetectState = false;
+static const uint8_t CH_RANGE = 0;  //距離チャネル
+static Trigger trigger;  //送信判断のルール
+static Scheduler scheduler;  //測定と送信のタスク
+static bool pending = false;  //送信待ちにする距離があるか
+static long pendingCm;
+static bool pendingDetected;
 
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 static const String device = "NOTUSED";  //  Set this to your device name if you're using UnaBiz Emulator.
@@ -31,6 +43,7 @@ static const bool echo = true;  //  Set to true if the SIGFOX library should dis
 static const Country country = COUNTRY_JP;  //  Set this to your country to configure the SIGFOX transmission frequencies.
 static UnaShieldV2S transceiver(country, useEmulator, device, echo);  //  Uncomment this for UnaBiz UnaShield V2S Dev Kit
 static String response;  //  Will store the downlink response from SIGFOX.
+static UplinkQueue uplinks(transceiver);  //  Messages waiting to be sent.
 // IMPORTANT: Check these settings with UnaBiz to use the SIGFOX library correctly.
 
 void setup()
@@ -46,37 +59,61 @@ void setup()
 
   //物体検知時LED
   pinMode(ledPin, OUTPUT);
+
+  //検知有無の変化(ヒステリシス付き)で送信する
+  trigger.addCrossing(CH_RANGE, DISTANCE_DETECTED, DISTANCE_HYSTERESIS, 0, MIN_SEND_INTERVAL);
+
+  //測定はSigfox送信中(約6秒)もバックグラウンドで続ける
+  int8_t rangeTask = scheduler.add(measureRange);
+  scheduler.setBackground(rangeTask, true);
+  scheduler.every(rangeTask, SAMPLE_INTERVAL);
+  scheduler.every(scheduler.add(sendTask), SAMPLE_INTERVAL);
+  scheduler.begin();
 }
 
 void loop()
 { 
-  //Ultrasonicセンサから距離(cm)を取得
-  long rangeCm = ultrasonic.MeasureInCentimeters();
+  //期限が来たタスクを実行
+  scheduler.run();
+}
+
+//Ultrasonicセンサから距離(cm)を取得(エコーを待つのは最大 ULTRASONIC_TIMEOUT マイクロ秒)
+void measureRange(void *)
+{
+  long rangeCm = ultrasonic.MeasureInCentimeters(ULTRASONIC_TIMEOUT);
+  if (rangeCm == 0) rangeCm = 400;  //時間内にエコーがなければ測定範囲(400cm)外とみなす
   if (isDebug) {Serial.print("Range(cm): "); Serial.println(rangeCm);}
   
-  //物体検知判断
-  bool detectState = (rangeCm < DISTANCE_DETECTED) ? true : false;
+  //物体検知判断(検知有無の変化時にSigfoxで距離を送信)
+  bool changed = trigger.sample(CH_RANGE, rangeCm);
+  bool detectState = !trigger.isAbove(CH_RANGE);
+  if (changed) { pending = true; pendingCm = rangeCm; pendingDetected = detectState; }
   
   //LEDを検知有無にあわせてON/OFFする
   digitalWrite(ledPin, detectState);
-  //検知有無の変化時にSigfoxで距離を送信
-  if (detectState != lastDetectState)
-  {
-    sendSigfoxMessage((unsigned int)rangeCm, detectState);
-    lastDetectState = detectState;
-    delay(2000);
-  }
-  delay(500);  
 }
 
-//距離(cm)と検知有無をSigfoxメッセージで送信する
-void sendSigfoxMessage(unsigned int distCm, bool isDetected) 
+//送信待ちのメッセージを送信(送信中のキューを変えないよう、バックグラウンドにしない)
+void sendTask(void *)
 {
-  Serial.println("\n*****SEND SIGFOX MESSAGE*****");
-  String sDistCm = transceiver.toHex(distCm);
-  String sIsDetected = (isDetected) ? "80" : "00"; //0x80(1000000) / 0x00(00000000)
+  if (pending) { pending = false; queueSigfoxMessage((unsigned int)pendingCm, pendingDetected); }
+  if (uplinks.isDue()) sendSigfoxMessage();
+}
+
+//距離(cm)と検知有無をSigfoxメッセージとして送信待ちにする
+void queueSigfoxMessage(unsigned int distCm, bool isDetected) 
+{
+  payload.set<payload.field("distance")>(distCm);
+  payload.set<payload.field("isDetected")>(isDetected);  //bool:7 -> 0x80 / 0x00
   Serial.print("IsDetected: "); Serial.println(isDetected);
-  Serial.print("Payload: "); Serial.println(sDistCm + sIsDetected);
-  transceiver.sendMessage(sDistCm + sIsDetected);
+  Serial.print("Payload: "); Serial.println(payload.hex());
+  uplinks.push(payload.hex());
+}
+
+//送信待ちのSigfoxメッセージを送信する
+void sendSigfoxMessage() 
+{
+  Serial.println("\n*****SEND SIGFOX MESSAGE*****");
+  uplinks.sendNext();
   Serial.println("*****************************");
 }
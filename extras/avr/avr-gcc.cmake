@@ -0,0 +1,22 @@
+#  Toolchain for building the library and examples for the AVR with avr-gcc, like the
+#  Arduino IDE does.  Used by extras/avr/CMakeLists.txt.
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR avr)
+
+find_program(AVR_GCC avr-gcc)
+if(NOT AVR_GCC)
+  message(FATAL_ERROR "avr-gcc not found.  Install it, or add the Arduino IDE's hardware/tools/avr/bin to PATH.")
+endif()
+get_filename_component(AVR_BIN_DIR "${AVR_GCC}" DIRECTORY)
+
+set(CMAKE_C_COMPILER "${AVR_BIN_DIR}/avr-gcc")
+set(CMAKE_CXX_COMPILER "${AVR_BIN_DIR}/avr-g++")
+set(CMAKE_ASM_COMPILER "${AVR_BIN_DIR}/avr-gcc")
+#  The Arduino IDE links with -flto, so the archives need the plugin.
+set(CMAKE_AR "${AVR_BIN_DIR}/avr-gcc-ar" CACHE FILEPATH "")
+set(CMAKE_RANLIB "${AVR_BIN_DIR}/avr-gcc-ranlib" CACHE FILEPATH "")
+set(AVR_NM "${AVR_BIN_DIR}/avr-nm")
+set(AVR_SIZE "${AVR_BIN_DIR}/avr-size")
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
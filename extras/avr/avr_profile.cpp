@@ -0,0 +1,510 @@
+//  Runs AVR firmware from extras/avr on simavr and reports where the cycles go: the cycles
+//  spent in each function, by the symbol at the program counter before every instruction,
+//  and the cycles of each call marked by the firmware (see profile.cpp).  Interrupt
+//  handlers show up under their own names, e.g. SoftwareSerial::recv() or __vector_5.
+//
+//  The runner plays the module on the Wisol pins, 9600 bps on D4 (from the Arduino) and D5
+//  (to the Arduino), and a TSL2561 on I2C, from a script.  The default script answers
+//  every command the driver sends like a Wisol module; a script file adds lines before it:
+//    uart <command> <delay ms> <response>   Answer the command, '*' matching any text.
+//                                           "\r" ends the response, "\n" and "\r" are escapes.
+//    i2c <address> <register> <value>       Hex bytes read back from the I2C device.
+//
+//  Build with extras/CMakeLists.txt and -DSIGFOX_AVR_PROFILE=ON, then run the profile:
+//    cmake --build build --target run_avr_profile
+//  or any of the examples, for a while:
+//    ./avr_profile elf=avr/grove-light.elf seconds=60 verbose=1
+//  Options: elf (firmware), sym (symbols from avr-nm -C -n -S, else the .elf with .sym),
+//  script (file), mcu (default atmega328p), frequency (Hz, default 16000000), seconds
+//  (virtual time limit, default 600), top (functions shown, default 30), verbose (1 to
+//  copy the firmware's Serial output to stderr).
+
+#include <algorithm>
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "sim_irq.h"
+#include "sim_cycle_timers.h"
+#include "avr_ioport.h"
+#include "avr_twi.h"
+#include "avr_uart.h"
+
+struct Options {
+  std::string elf;
+  std::string sym;
+  std::string script;
+  std::string mcu = "atmega328p";
+  unsigned long frequency = 16000000;
+  unsigned long seconds = 600;
+  unsigned top = 30;
+  bool verbose = false;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const std::string name(arg, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "elf") options.elf = equals + 1;
+  else if (name == "sym") options.sym = equals + 1;
+  else if (name == "script") options.script = equals + 1;
+  else if (name == "mcu") options.mcu = equals + 1;
+  else if (name == "frequency") options.frequency = value;
+  else if (name == "seconds") options.seconds = value;
+  else if (name == "top") options.top = value;
+  else if (name == "verbose") options.verbose = value != 0;
+  else return false;
+  return true;
+}
+
+//  Markers written by profile.cpp to the general purpose I/O registers (data addresses).
+static const avr_io_addr_t GPIOR0_ADDRESS = 0x3E;
+static const avr_io_addr_t GPIOR1_ADDRESS = 0x4A;
+static const avr_io_addr_t GPIOR2_ADDRESS = 0x4B;
+static const uint8_t PROFILE_START = 1;
+static const uint8_t PROFILE_STOP = 2;
+static const uint8_t PROFILE_DONE = 3;
+
+static const unsigned long PEER_BITS_PER_SECOND = 9600;
+static const uint8_t PEER_TX_PIN = 4;  //  Arduino D4 is PD4, from the Arduino to the module.
+static const uint8_t PEER_RX_PIN = 5;  //  Arduino D5 is PD5, from the module to the Arduino.
+
+//  The module's answers, like extras/sim/WisolSim.
+static const char defaultScript[] =
+  "uart AT$SF=*,1 100 OK\\r\\nRX=01 23 45 67 89 AB CD EF\n"
+  "uart AT$SF=* 100 OK\n"
+  "uart AT$GI? 10 1,3\n"
+  "uart AT$I=10 10 002C30EB\n"
+  "uart AT$I=11 10 A8664B5523B5405D\n"
+  "uart AT$T? 10 263\n"
+  "uart AT$V? 10 3300\n"
+  "uart * 10 OK\n"
+  "i2c 29 8C 34\n"  //  TSL2561 channel 0 = 0x0234, channel 1 = 0x0080.
+  "i2c 29 8D 02\n"
+  "i2c 29 8E 80\n"
+  "i2c 29 8F 00\n";
+
+struct Answer {
+  std::string command;
+  unsigned long delay;  //  Milliseconds after the command's '\r'.
+  std::string response;
+};
+
+//  Symbol from avr-nm, covering [address, end) in flash.
+struct Symbol {
+  uint32_t address;
+  uint32_t end;
+  std::string name;
+  avr_cycle_count_t cycles = 0;
+  unsigned long calls = 0;
+};
+
+//  Kernel marked by the firmware.
+struct Kernel {
+  unsigned long runs = 0;
+  avr_cycle_count_t cycles = 0;
+  avr_cycle_count_t minCycles = 0;
+};
+
+struct Profile {
+  avr_t *avr = 0;
+  Options options;
+  std::vector<Answer> answers;
+  std::map<uint8_t, std::vector<uint8_t> > i2cRegisters;  //  Registers of each I2C address.
+  std::vector<Symbol> symbols;
+  avr_cycle_count_t sleepCycles = 0;
+  avr_cycle_count_t otherCycles = 0;  //  Outside every symbol.
+  //  Kernels in the order first seen.
+  std::vector<std::string> kernelNames;
+  std::map<std::string, Kernel> kernels;
+  std::string kernel;
+  avr_cycle_count_t kernelStart = 0;
+  bool done = false;
+  //  UART peer.
+  avr_cycle_count_t bitCycles = 0;
+  uint8_t txLevel = 1;
+  bool txReceiving = false;
+  uint8_t txBit = 0;
+  uint8_t txByte = 0;
+  std::string command;
+  std::string rxQueue;
+  uint8_t rxBit = 0;  //  0 is the start bit, 1 to 8 the data, 9 the stop bit.
+  bool rxSending = false;
+  unsigned long commands = 0;
+  unsigned long unanswered = 0;
+  //  I2C peer.
+  uint8_t i2cSelected = 0;
+  bool i2cFirst = false;
+  uint8_t i2cRegister = 0;
+  //  Serial output of the firmware.
+  std::string serialLine;
+};
+
+static std::string unescape(const std::string &text) {
+  std::string result;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '\\' && i + 1 < text.size() && (text[i + 1] == 'r' || text[i + 1] == 'n')) {
+      result += text[++i] == 'r' ? '\r' : '\n';
+    } else result += text[i];
+  }
+  return result;
+}
+
+static bool readScript(Profile &profile, const char *text, const char *source, bool before) {
+  //  Answers are tried in order, so those of the file go before the default ones.
+  //  Registers set by the file replace the default values.
+  size_t position = before ? 0 : profile.answers.size();
+  unsigned line = 0;
+  for (const char *p = text; *p; ) {
+    const char *end = strchr(p, '\n');
+    if (!end) end = p + strlen(p);
+    std::string entry(p, end - p);
+    p = *end ? end + 1 : end;
+    line++;
+    if (!entry.empty() && entry[entry.size() - 1] == '\r') entry.erase(entry.size() - 1);
+    if (entry.empty() || entry[0] == '#') continue;
+    char kind[8], first[64], second[64];
+    int length = 0;
+    if (sscanf(entry.c_str(), "%7s %63s %63s %n", kind, first, second, &length) < 3) {
+      fprintf(stderr, "%s:%u: expected 3 fields or more\n", source, line);
+      return false;
+    }
+    if (strcmp(kind, "uart") == 0) {
+      Answer answer;
+      answer.command = first;
+      answer.delay = strtoul(second, 0, 10);
+      answer.response = unescape(entry.substr(length)) + '\r';
+      profile.answers.insert(profile.answers.begin() + position++, answer);
+    } else if (strcmp(kind, "i2c") == 0) {
+      const unsigned address = strtoul(first, 0, 16);
+      const unsigned reg = strtoul(second, 0, 16);
+      const unsigned value = strtoul(entry.c_str() + length, 0, 16);
+      std::vector<uint8_t> &registers = profile.i2cRegisters[address];
+      registers.resize(256);
+      registers[reg & 0xff] = value;
+    } else {
+      fprintf(stderr, "%s:%u: unknown peer %s\n", source, line, kind);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool readFile(const std::string &path, std::string &text) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) { perror(path.c_str()); return false; }
+  char buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, length);
+  fclose(file);
+  return true;
+}
+
+static bool readSymbols(Profile &profile, const std::string &path) {
+  //  Lines of avr-nm -n -S are "address size type name", or "address type name" for
+  //  symbols without a size, like the assembler functions in libgcc.  Those end at the
+  //  next symbol.
+  std::string text;
+  if (!readFile(path, text)) return false;
+  std::vector<Symbol> &symbols = profile.symbols;
+  for (size_t p = 0; p < text.size(); ) {
+    size_t end = text.find('\n', p);
+    if (end == std::string::npos) end = text.size();
+    const std::string line = text.substr(p, end - p);
+    p = end + 1;
+    char *next;
+    const unsigned long address = strtoul(line.c_str(), &next, 16);
+    if (next == line.c_str() || *next != ' ') continue;
+    unsigned long size = 0;
+    const char *field = next + 1;
+    if (field[0] && field[1] != ' ') {
+      size = strtoul(field, &next, 16);
+      field = next + 1;
+    }
+    const char type = field[0];
+    if (type != 'T' && type != 't' && type != 'W' && type != 'w') continue;
+    if (!field[1] || !field[2]) continue;
+    Symbol symbol;
+    symbol.address = address;
+    symbol.end = size ? address + size : 0;
+    symbol.name = field + 2;
+    symbols.push_back(symbol);
+  }
+  if (symbols.empty()) { fprintf(stderr, "%s: no functions\n", path.c_str()); return false; }
+  std::stable_sort(symbols.begin(), symbols.end(),
+                   [](const Symbol &a, const Symbol &b) { return a.address < b.address; });
+  for (size_t i = 0; i < symbols.size(); i++) {
+    if (symbols[i].end) continue;
+    symbols[i].end = i + 1 < symbols.size() ? symbols[i + 1].address : symbols[i].address + 2;
+  }
+  return true;
+}
+
+static Symbol *findSymbol(Profile &profile, uint32_t pc) {
+  //  The last symbol that starts at or before pc, if pc is inside it.
+  std::vector<Symbol> &symbols = profile.symbols;
+  size_t low = 0, high = symbols.size();
+  while (low < high) {
+    const size_t middle = (low + high) / 2;
+    if (symbols[middle].address <= pc) low = middle + 1;
+    else high = middle;
+  }
+  if (low == 0 || pc >= symbols[low - 1].end) return 0;
+  return &symbols[low - 1];
+}
+
+static bool matches(const char *pattern, const char *text) {
+  //  '*' matches any text, including none.
+  if (*pattern == '*') return matches(pattern + 1, text) || (*text && matches(pattern, text + 1));
+  if (*pattern != *text) return false;
+  return !*pattern || matches(pattern + 1, text + 1);
+}
+
+//  Module on the UART: receives at the bit times after each start bit, and answers each
+//  command ending with '\r' by sending the response bit by bit.
+
+static avr_irq_t *rxIrq(Profile &profile) {
+  return avr_io_getirq(profile.avr, AVR_IOCTL_IOPORT_GETIRQ('D'), PEER_RX_PIN);
+}
+
+static avr_cycle_count_t sendBit(avr_t *avr, avr_cycle_count_t when, void *param) {
+  Profile &profile = *(Profile *) param;
+  if (profile.rxQueue.empty()) { profile.rxSending = false; return 0; }
+  const uint8_t c = profile.rxQueue[0];
+  const uint8_t bit = profile.rxBit;
+  const uint8_t level = bit == 0 ? 0 : bit == 9 ? 1 : (c >> (bit - 1)) & 1;
+  avr_raise_irq(rxIrq(profile), level);
+  if (++profile.rxBit == 10) { profile.rxBit = 0; profile.rxQueue.erase(0, 1); }
+  return when + profile.bitCycles;
+}
+
+static avr_cycle_count_t startResponse(avr_t *avr, avr_cycle_count_t when, void *param) {
+  Profile &profile = *(Profile *) param;
+  if (!profile.rxSending) {
+    profile.rxSending = true;
+    avr_cycle_timer_register(avr, 1, sendBit, param);
+  }
+  return 0;
+}
+
+//  Response waiting for its delay.
+struct PendingResponse {
+  Profile *profile;
+  std::string text;
+};
+
+static avr_cycle_count_t queueResponse(avr_t *avr, avr_cycle_count_t when, void *param) {
+  PendingResponse *pending = (PendingResponse *) param;
+  Profile &profile = *pending->profile;
+  profile.rxQueue += pending->text;
+  delete pending;
+  return startResponse(avr, when, &profile);
+}
+
+static void answer(Profile &profile) {
+  profile.commands++;
+  for (size_t i = 0; i < profile.answers.size(); i++) {
+    const Answer &answer = profile.answers[i];
+    if (!matches(answer.command.c_str(), profile.command.c_str())) continue;
+    PendingResponse *pending = new PendingResponse;
+    pending->profile = &profile;
+    pending->text = answer.response;
+    const avr_cycle_count_t delay = (avr_cycle_count_t) answer.delay * profile.options.frequency / 1000;
+    avr_cycle_timer_register(profile.avr, delay ? delay : 1, queueResponse, pending);
+    return;
+  }
+  profile.unanswered++;
+}
+
+static avr_cycle_count_t receiveBit(avr_t *avr, avr_cycle_count_t when, void *param) {
+  Profile &profile = *(Profile *) param;
+  if (profile.txBit < 8) {
+    profile.txByte |= profile.txLevel << profile.txBit;
+    profile.txBit++;
+    return when + profile.bitCycles;
+  }
+  //  Stop bit.  Without it, like the break that wakes the module, the byte is dropped.
+  profile.txReceiving = false;
+  if (!profile.txLevel) return 0;
+  const char c = (char) profile.txByte;
+  if (c == '\r') {
+    answer(profile);
+    profile.command.clear();
+  } else if (c != '\n') profile.command += c;
+  return 0;
+}
+
+static void txChanged(avr_irq_t *irq, uint32_t value, void *param) {
+  Profile &profile = *(Profile *) param;
+  const uint8_t level = value ? 1 : 0;
+  if (profile.txLevel && !level && !profile.txReceiving) {
+    //  Start bit: sample the middle of each data bit.
+    profile.txReceiving = true;
+    profile.txBit = 0;
+    profile.txByte = 0;
+    avr_cycle_timer_register(profile.avr, profile.bitCycles * 3 / 2, receiveBit, param);
+  }
+  profile.txLevel = level;
+}
+
+//  I2C device: the first byte written after the address selects the register, the
+//  others are written to it.  Reads return the selected register.
+static void twiChanged(avr_irq_t *irq, uint32_t value, void *param) {
+  Profile &profile = *(Profile *) param;
+  avr_irq_t *input = avr_io_getirq(profile.avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+  avr_twi_msg_irq_t message;
+  message.u.v = value;
+  if (message.u.twi.msg & TWI_COND_STOP) profile.i2cSelected = 0;
+  if (message.u.twi.msg & TWI_COND_START) {
+    profile.i2cSelected = 0;
+    if (profile.i2cRegisters.count(message.u.twi.addr >> 1)) {
+      profile.i2cSelected = message.u.twi.addr;
+      profile.i2cFirst = true;
+      avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, profile.i2cSelected, 1));
+    }
+  }
+  if (!profile.i2cSelected) return;
+  std::vector<uint8_t> &registers = profile.i2cRegisters[profile.i2cSelected >> 1];
+  if (message.u.twi.msg & TWI_COND_WRITE) {
+    avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, profile.i2cSelected, 1));
+    if (profile.i2cFirst) profile.i2cRegister = message.u.twi.data;
+    else registers[profile.i2cRegister] = message.u.twi.data;
+    profile.i2cFirst = false;
+  }
+  if (message.u.twi.msg & TWI_COND_READ) {
+    avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_READ, profile.i2cSelected, registers[profile.i2cRegister]));
+  }
+}
+
+static void serialOutput(avr_irq_t *irq, uint32_t value, void *param) {
+  Profile &profile = *(Profile *) param;
+  if (!profile.options.verbose) return;
+  if (value == '\n') {
+    fprintf(stderr, "%s\n", profile.serialLine.c_str());
+    profile.serialLine.clear();
+  } else if (value != '\r') profile.serialLine += (char) value;
+}
+
+static void markerWritten(avr_t *avr, avr_io_addr_t addr, uint8_t value, void *param) {
+  Profile &profile = *(Profile *) param;
+  avr->data[addr] = value;
+  if (value == PROFILE_START) {
+    //  The name is in RAM at GPIOR2:GPIOR1.
+    const uint16_t name = avr->data[GPIOR2_ADDRESS] << 8 | avr->data[GPIOR1_ADDRESS];
+    profile.kernel.clear();
+    for (uint16_t p = name; p <= avr->ramend && avr->data[p]; p++) profile.kernel += (char) avr->data[p];
+    profile.kernelStart = avr->cycle;
+  } else if (value == PROFILE_STOP && !profile.kernel.empty()) {
+    const avr_cycle_count_t cycles = avr->cycle - profile.kernelStart;
+    if (!profile.kernels.count(profile.kernel)) profile.kernelNames.push_back(profile.kernel);
+    Kernel &kernel = profile.kernels[profile.kernel];
+    if (kernel.runs == 0 || cycles < kernel.minCycles) kernel.minCycles = cycles;
+    kernel.runs++;
+    kernel.cycles += cycles;
+    profile.kernel.clear();
+  } else if (value == PROFILE_DONE) profile.done = true;
+}
+
+static void report(const Profile &profile, avr_cycle_count_t total) {
+  const double microseconds = 1e6 / profile.options.frequency;
+  printf("%llu cycles, %.3f s, %lu commands to the module, %lu unanswered\n",
+         (unsigned long long) total, total * microseconds / 1e6, profile.commands, profile.unanswered);
+  if (!profile.kernelNames.empty()) {
+    printf("\n%-34s %6s %14s %14s %12s\n", "kernel", "runs", "cycles/call", "min cycles", "us/call");
+    for (size_t i = 0; i < profile.kernelNames.size(); i++) {
+      const Kernel &kernel = profile.kernels.find(profile.kernelNames[i])->second;
+      const double average = (double) kernel.cycles / kernel.runs;
+      printf("%-34s %6lu %14.0f %14llu %12.1f\n", profile.kernelNames[i].c_str(), kernel.runs,
+             average, (unsigned long long) kernel.minCycles, average * microseconds);
+    }
+  }
+  std::vector<const Symbol *> sorted;
+  for (size_t i = 0; i < profile.symbols.size(); i++)
+    if (profile.symbols[i].cycles) sorted.push_back(&profile.symbols[i]);
+  std::sort(sorted.begin(), sorted.end(), [](const Symbol *a, const Symbol *b) { return a->cycles > b->cycles; });
+  printf("\n%-48s %14s %7s %10s %12s\n", "function (self)", "cycles", "%", "calls", "cycles/call");
+  for (size_t i = 0; i < sorted.size() && i < profile.options.top; i++) {
+    const Symbol &symbol = *sorted[i];
+    printf("%-48.48s %14llu %6.2f%% %10lu %12.0f\n", symbol.name.c_str(), (unsigned long long) symbol.cycles,
+           100.0 * symbol.cycles / total, symbol.calls, symbol.calls ? (double) symbol.cycles / symbol.calls : 0.0);
+  }
+  if (profile.sleepCycles)
+    printf("%-48s %14llu %6.2f%%\n", "(sleep)", (unsigned long long) profile.sleepCycles, 100.0 * profile.sleepCycles / total);
+  if (profile.otherCycles)
+    printf("%-48s %14llu %6.2f%%\n", "(no symbol)", (unsigned long long) profile.otherCycles, 100.0 * profile.otherCycles / total);
+}
+
+int main(int argc, char **argv) {
+  Profile profile;
+  Options &options = profile.options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  if (options.elf.empty() || options.frequency == 0) { fprintf(stderr, "Usage: %s elf=firmware.elf [name=value...]\n", argv[0]); return 2; }
+  if (options.sym.empty()) {
+    options.sym = options.elf;
+    const size_t dot = options.sym.rfind(".elf");
+    if (dot != std::string::npos) options.sym.erase(dot);
+    options.sym += ".sym";
+  }
+  if (!readScript(profile, defaultScript, "default script", false)) return 1;
+  if (!options.script.empty()) {
+    std::string text;
+    if (!readFile(options.script, text) || !readScript(profile, text.c_str(), options.script.c_str(), true)) return 1;
+  }
+  if (!readSymbols(profile, options.sym)) return 1;
+
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if (elf_read_firmware(options.elf.c_str(), &firmware) != 0) { fprintf(stderr, "%s: can't load\n", options.elf.c_str()); return 1; }
+  avr_t *avr = avr_make_mcu_by_name(options.mcu.c_str());
+  if (!avr) { fprintf(stderr, "Unknown mcu %s\n", options.mcu.c_str()); return 2; }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+  avr->frequency = options.frequency;
+  profile.avr = avr;
+  profile.bitCycles = options.frequency / PEER_BITS_PER_SECOND;
+
+  avr_register_io_write(avr, GPIOR0_ADDRESS, markerWritten, &profile);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('D'), PEER_TX_PIN), txChanged, &profile);
+  avr_raise_irq(rxIrq(profile), 1);  //  Idle line.
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), twiChanged, &profile);
+  //  Take the Serial output instead of letting simavr print it.
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), serialOutput, &profile);
+
+  //  One instruction at a time, charged to the function at the program counter before it.
+  //  A call is counted when the program counter moves to the start of a function.
+  const avr_cycle_count_t limit = (avr_cycle_count_t) options.seconds * options.frequency;
+  Symbol *last = 0;
+  int state = cpu_Running;
+  while (!profile.done && avr->cycle < limit) {
+    const uint32_t pc = avr->pc;
+    const avr_cycle_count_t before = avr->cycle;
+    const bool sleeping = avr->state == cpu_Sleeping;
+    Symbol *symbol = last && pc >= last->address && pc < last->end ? last : findSymbol(profile, pc);
+    if (symbol && symbol != last && pc == symbol->address) symbol->calls++;
+    last = symbol;
+    state = avr_run(avr);
+    const avr_cycle_count_t cycles = avr->cycle - before;
+    if (sleeping) profile.sleepCycles += cycles;
+    else if (symbol) symbol->cycles += cycles;
+    else profile.otherCycles += cycles;
+    if (state == cpu_Done || state == cpu_Crashed) break;
+  }
+  if (!profile.serialLine.empty()) fprintf(stderr, "%s\n", profile.serialLine.c_str());
+  report(profile, avr->cycle);
+  if (state == cpu_Crashed) { fprintf(stderr, "The firmware crashed at 0x%04x\n", avr->pc); return 1; }
+  if (!profile.kernelNames.empty() && !profile.done) { fprintf(stderr, "The firmware didn't finish in %lu s\n", options.seconds); return 1; }
+  return 0;
+}
@@ -0,0 +1,239 @@
+//  Flash and static RAM of the AVR firmware built by extras/avr, by source file and by
+//  symbol, checked against the budget of each firmware.  Fails when one has grown beyond
+//  its budget, so that a change that makes the sketches too big for the Uno is noticed.
+//
+//  Build with extras/CMakeLists.txt and -DSIGFOX_AVR_FOOTPRINT=ON, then check:
+//    cmake --build build --target check_footprint
+//  or run it on the firmware in build/avr:
+//    ./footprint dir=build/avr budget=extras/avr/budget.txt top=20
+//  Options: dir (folder of the <name>.size and <name>.nm files), budget (file with a line
+//  "<name> <flash> <ram>" for each firmware checked, or "<name> - -" for one whose sizes
+//  haven't been recorded, which fails the check), top (largest symbols shown for each
+//  firmware, default 10), update (1 to write the current sizes into the budget instead of
+//  checking, after a change that is worth its bytes).
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Options {
+  std::string dir = ".";
+  std::string budget;
+  unsigned top = 10;
+  bool update = false;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const std::string name(arg, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "dir") options.dir = equals + 1;
+  else if (name == "budget") options.budget = equals + 1;
+  else if (name == "top") options.top = value;
+  else if (name == "update") options.update = value != 0;
+  else return false;
+  return true;
+}
+
+//  Data addresses in the AVR's ELF files start here, below are those in flash.
+static const unsigned long RAM_ADDRESS = 0x800000;
+
+//  Line of the budget: a firmware and its sizes, or a comment kept as it is.
+struct BudgetLine {
+  std::string text;
+  std::string name;  //  Empty for comments.
+  bool recorded = false;  //  False for "-", which fails until update=1 records the sizes.
+  unsigned long flash = 0;
+  unsigned long ram = 0;
+};
+
+struct Usage {
+  unsigned long flash = 0;
+  unsigned long ram = 0;
+};
+
+struct Symbol {
+  std::string name;
+  std::string source;
+  Usage usage;
+};
+
+static bool readLines(const std::string &path, std::vector<std::string> &lines) {
+  FILE *file = fopen(path.c_str(), "r");
+  if (!file) { perror(path.c_str()); return false; }
+  char buffer[1024];
+  while (fgets(buffer, sizeof(buffer), file)) {
+    std::string line(buffer);
+    while (!line.empty() && (line[line.size() - 1] == '\n' || line[line.size() - 1] == '\r'))
+      line.erase(line.size() - 1);
+    lines.push_back(line);
+  }
+  fclose(file);
+  return true;
+}
+
+static bool readBudget(const std::string &path, std::vector<BudgetLine> &budget) {
+  std::vector<std::string> lines;
+  if (!readLines(path, lines)) return false;
+  for (size_t i = 0; i < lines.size(); i++) {
+    BudgetLine entry;
+    entry.text = lines[i];
+    char name[64], flash[8], ram[8];
+    if (lines[i].empty() || lines[i][0] == '#') {
+    } else if (sscanf(lines[i].c_str(), "%63s %lu %lu", name, &entry.flash, &entry.ram) == 3) {
+      entry.name = name;
+      entry.recorded = true;
+    } else if (sscanf(lines[i].c_str(), "%63s %7s %7s", name, flash, ram) == 3 &&
+               strcmp(flash, "-") == 0 && strcmp(ram, "-") == 0) {
+      entry.name = name;
+    } else {
+      fprintf(stderr, "%s:%u: expected <name> <flash> <ram> or <name> - -\n", path.c_str(), (unsigned) i + 1);
+      return false;
+    }
+    budget.push_back(entry);
+  }
+  return true;
+}
+
+static bool readSections(const std::string &path, Usage &usage) {
+  //  From avr-size -A: flash holds .text and the initial .data, RAM holds .data, .bss and
+  //  .noinit.
+  std::vector<std::string> lines;
+  if (!readLines(path, lines)) return false;
+  for (size_t i = 0; i < lines.size(); i++) {
+    char section[64];
+    unsigned long size;
+    if (sscanf(lines[i].c_str(), "%63s %lu", section, &size) != 2) continue;
+    if (strcmp(section, ".text") == 0) usage.flash += size;
+    else if (strcmp(section, ".data") == 0) { usage.flash += size; usage.ram += size; }
+    else if (strcmp(section, ".bss") == 0 || strcmp(section, ".noinit") == 0) usage.ram += size;
+  }
+  return true;
+}
+
+static bool readSymbols(const std::string &path, std::vector<Symbol> &symbols) {
+  //  From avr-nm -C -S -l: "address size type name", then a tab and "file:line" when
+  //  the symbol has debug information.  Initialised data is also in flash.
+  std::vector<std::string> lines;
+  if (!readLines(path, lines)) return false;
+  for (size_t i = 0; i < lines.size(); i++) {
+    const char *line = lines[i].c_str();
+    char *next;
+    const unsigned long address = strtoul(line, &next, 16);
+    if (next == line || *next != ' ') continue;
+    const unsigned long size = strtoul(next + 1, &next, 16);
+    if (*next != ' ' || !next[1] || next[2] != ' ') continue;
+    const char type = next[1];
+    Symbol symbol;
+    symbol.name = next + 3;
+    const size_t tab = symbol.name.find('\t');
+    if (tab != std::string::npos) {
+      std::string source = symbol.name.substr(tab + 1);
+      symbol.name.erase(tab);
+      const size_t colon = source.rfind(':');
+      if (colon != std::string::npos) source.erase(colon);
+      const size_t slash = source.find_last_of("/\\");
+      symbol.source = slash == std::string::npos ? source : source.substr(slash + 1);
+    } else symbol.source = "(libc, libgcc)";
+    if (address < RAM_ADDRESS) symbol.usage.flash = size;
+    else {
+      symbol.usage.ram = size;
+      if (type == 'd' || type == 'D') symbol.usage.flash = size;
+    }
+    symbols.push_back(symbol);
+  }
+  return true;
+}
+
+static void report(const std::string &name, const Usage &usage, const std::vector<Symbol> &symbols,
+                   unsigned top) {
+  std::map<std::string, Usage> sources;
+  Usage total;
+  for (size_t i = 0; i < symbols.size(); i++) {
+    Usage &source = sources[symbols[i].source];
+    source.flash += symbols[i].usage.flash;
+    source.ram += symbols[i].usage.ram;
+    total.flash += symbols[i].usage.flash;
+    total.ram += symbols[i].usage.ram;
+  }
+  //  Vectors, startup code and padding have no size in the symbols.
+  Usage &other = sources["(no symbol)"];
+  other.flash = usage.flash > total.flash ? usage.flash - total.flash : 0;
+  other.ram = usage.ram > total.ram ? usage.ram - total.ram : 0;
+  std::vector<std::pair<std::string, Usage> > sorted(sources.begin(), sources.end());
+  std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, Usage> &a, const std::pair<std::string, Usage> &b) {
+    return a.second.flash + a.second.ram > b.second.flash + b.second.ram;
+  });
+  printf("\n%s: flash %lu, RAM %lu\n", name.c_str(), usage.flash, usage.ram);
+  printf("  %-40s %8s %8s\n", "source", "flash", "RAM");
+  for (size_t i = 0; i < sorted.size(); i++)
+    printf("  %-40.40s %8lu %8lu\n", sorted[i].first.c_str(), sorted[i].second.flash, sorted[i].second.ram);
+  std::vector<const Symbol *> largest;
+  for (size_t i = 0; i < symbols.size(); i++) largest.push_back(&symbols[i]);
+  std::sort(largest.begin(), largest.end(), [](const Symbol *a, const Symbol *b) {
+    return a->usage.flash + a->usage.ram > b->usage.flash + b->usage.ram;
+  });
+  printf("  %-40s %8s %8s  %s\n", "symbol", "flash", "RAM", "source");
+  for (size_t i = 0; i < largest.size() && i < top; i++)
+    printf("  %-40.40s %8lu %8lu  %s\n", largest[i]->name.c_str(), largest[i]->usage.flash,
+           largest[i]->usage.ram, largest[i]->source.c_str());
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  if (options.budget.empty()) { fprintf(stderr, "Usage: %s budget=budget.txt [name=value...]\n", argv[0]); return 2; }
+  std::vector<BudgetLine> budget;
+  if (!readBudget(options.budget, budget)) return 1;
+
+  bool failed = false, unrecorded = false;
+  std::vector<std::string> summary;
+  for (size_t i = 0; i < budget.size(); i++) {
+    BudgetLine &entry = budget[i];
+    if (entry.name.empty()) continue;
+    const std::string base = options.dir + "/" + entry.name;
+    Usage usage;
+    std::vector<Symbol> symbols;
+    if (!readSections(base + ".size", usage) || !readSymbols(base + ".nm", symbols)) return 1;
+    report(entry.name, usage, symbols, options.top);
+    char line[160];
+    const bool over = entry.recorded && (usage.flash > entry.flash || usage.ram > entry.ram);
+    if (entry.recorded) {
+      snprintf(line, sizeof(line), "%-24s %8lu %8lu %+8ld %8lu %8lu %+8ld  %s", entry.name.c_str(),
+               usage.flash, entry.flash, (long) usage.flash - (long) entry.flash,
+               usage.ram, entry.ram, (long) usage.ram - (long) entry.ram,
+               options.update ? "updated" : over ? "OVER BUDGET" : "ok");
+    } else {
+      snprintf(line, sizeof(line), "%-24s %8lu %8s %8s %8lu %8s %8s  %s", entry.name.c_str(),
+               usage.flash, "-", "", usage.ram, "-", "", options.update ? "recorded" : "NO BUDGET");
+      if (!options.update) unrecorded = true;
+    }
+    summary.push_back(line);
+    if (options.update) {
+      entry.flash = usage.flash;
+      entry.ram = usage.ram;
+      snprintf(line, sizeof(line), "%-24s %8lu %8lu", entry.name.c_str(), entry.flash, entry.ram);
+      entry.text = line;
+    } else if (over) failed = true;
+  }
+  printf("\n%-24s %8s %8s %8s %8s %8s %8s\n", "firmware", "flash", "budget", "change", "RAM", "budget", "change");
+  for (size_t i = 0; i < summary.size(); i++) printf("%s\n", summary[i].c_str());
+
+  if (options.update) {
+    FILE *file = fopen(options.budget.c_str(), "w");
+    if (!file) { perror(options.budget.c_str()); return 1; }
+    for (size_t i = 0; i < budget.size(); i++) fprintf(file, "%s\n", budget[i].text.c_str());
+    fclose(file);
+    return 0;
+  }
+  if (failed) fprintf(stderr, "Firmware over budget.  If the bytes are worth it, run again with update=1.\n");
+  if (unrecorded) fprintf(stderr, "Firmware without a budget.  Record its sizes with update=1.\n");
+  return failed || unrecorded ? 1 : 0;
+}
@@ -0,0 +1,30 @@
+#  Turns a sketch into C++ like the Arduino IDE does: includes Arduino.h, and declares each
+#  function before the first one so that the sketch can call functions defined further down.
+#    cmake -DINPUT=sketch.ino -DOUTPUT=sketch.cpp -P ino.cmake
+
+file(READ "${INPUT}" content)
+#  Function definitions start at the beginning of a line, with the brace on the same line
+#  or the next.
+string(REGEX MATCHALL "\n([A-Za-z_][A-Za-z0-9_<>:]*[ \t*&]+)+[A-Za-z_][A-Za-z0-9_]*\\([^;{}()]*\\)[ \t\r]*\n?[ \t]*{"
+  definitions "${content}")
+
+set(prototypes "")
+set(prefix "${content}")
+set(rest "")
+if(definitions)
+  foreach(definition ${definitions})
+    string(REGEX REPLACE "\\)[^)]*$" ")" prototype "${definition}")
+    string(STRIP "${prototype}" prototype)
+    string(APPEND prototypes "${prototype};\n")
+  endforeach()
+  list(GET definitions 0 first)
+  string(FIND "${content}" "${first}" position)
+  math(EXPR position "${position} + 1")
+  string(SUBSTRING "${content}" 0 ${position} prefix)
+  string(SUBSTRING "${content}" ${position} -1 rest)
+endif()
+
+string(REGEX REPLACE "[^\n]" "" newlines "${prefix}")
+string(LENGTH "${newlines}" line)
+math(EXPR line "${line} + 1")
+file(WRITE "${OUTPUT}" "#include <Arduino.h>\n#line 1 \"${INPUT}\"\n${prefix}${prototypes}#line ${line} \"${INPUT}\"\n${rest}")
@@ -0,0 +1,78 @@
+//  Firmware for profiling on simavr with extras/avr/avr_profile.  Runs the kernels of
+//  extras/bench, then the Wisol driver against the module scripted by the runner, and
+//  marks each call so that the runner can count its cycles.
+//
+//  Markers are written to the general purpose I/O registers, which cost one cycle each
+//  and are not used by the core: GPIOR2:GPIOR1 hold the address of the kernel name in RAM,
+//  then GPIOR0 is set to PROFILE_START, and to PROFILE_STOP after the call.
+
+#include "kernels.h"
+#include <Wire.h>
+
+static const uint8_t PROFILE_START = 1;
+static const uint8_t PROFILE_STOP = 2;
+static const uint8_t PROFILE_DONE = 3;  //  All kernels have run, the runner stops.
+
+static const uint8_t PROFILE_RUNS = 8;  //  Calls of each kernel.
+static const uint8_t PROFILE_MODULE_RUNS = 2;  //  Calls of each driver function.
+
+//  The driver refuses another message within 2 seconds, so the driver functions wait this
+//  long before each call, outside the markers.
+static const unsigned long PROFILE_MODULE_INTERVAL = 2100;
+
+static void profileBegin() {
+  benchSink = benchWisol.begin();
+}
+
+static void profileSendMessage() {
+  benchSink = benchWisol.sendMessage("0102030405060708090a0b0c");
+}
+
+static void profileGetTemperature() {
+  float temperature = 0;
+  benchWisol.getTemperature(temperature);
+  benchSink = (unsigned long) temperature;
+}
+
+static void profileGetVoltage() {
+  float voltage = 0;
+  benchWisol.getVoltage(voltage);
+  benchSink = (unsigned long) voltage;
+}
+
+//  Driver functions, which send through SoftwareSerial and receive in its interrupt.
+static const BenchKernel profileModuleKernels[] PROGMEM = {
+  { "Wisol::begin", profileBegin },
+  { "Wisol::sendMessage", profileSendMessage },
+  { "Wisol::getTemperature", profileGetTemperature },
+  { "Wisol::getVoltage", profileGetVoltage },
+};
+static const uint8_t profileModuleKernelCount = sizeof(profileModuleKernels) / sizeof(profileModuleKernels[0]);
+
+static void profileRun(const BenchKernel *kernels, uint8_t count, uint8_t runs, unsigned long interval) {
+  for (uint8_t i = 0; i < count; i++) {
+    BenchKernel kernel;
+    memcpy_P(&kernel, &kernels[i], sizeof(kernel));
+    for (uint8_t run = 0; run < runs; run++) {
+      delay(interval);
+      GPIOR2 = (uint8_t) ((uint16_t) kernel.name >> 8);
+      GPIOR1 = (uint8_t) (uint16_t) kernel.name;
+      GPIOR0 = PROFILE_START;
+      kernel.run();
+      GPIOR0 = PROFILE_STOP;
+    }
+  }
+}
+
+void setup() {
+  //  Channel readings for calculateLux(), read from the runner's TSL2561.
+  Wire.begin();
+  TSL2561.getLux();
+  profileRun(benchKernels, benchKernelCount, PROFILE_RUNS, 0);
+  profileRun(profileModuleKernels, 1, 1, 0);
+  profileRun(profileModuleKernels + 1, profileModuleKernelCount - 1, PROFILE_MODULE_RUNS, PROFILE_MODULE_INTERVAL);
+  GPIOR0 = PROFILE_DONE;
+}
+
+void loop() {
+}
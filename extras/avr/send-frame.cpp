@@ -0,0 +1,13 @@
+//  The smallest sketch that sends a frame: start the module, send one message.  The
+//  footprint of the library itself, for extras/avr/budget.txt.
+
+#include "SIGFOX.h"
+
+static Wisol transceiver(COUNTRY_JP, false, "NOTUSED", false);
+
+void setup() {
+  if (transceiver.begin()) transceiver.sendMessage("0102030405060708090a0b0c");
+}
+
+void loop() {
+}
@@ -0,0 +1,100 @@
+//  Local stand-in for the Sigfox network and callback pipeline.
+
+#include <string.h>
+#include "SIGFOX.h"
+#include "NetworkSim.h"
+
+NetworkSim::NetworkSim(const NetworkSimConfig &config0, FILE *out0) {
+  config = config0;
+  out = out0;
+  format = FORMAT_MESSAGE;
+  randomState = config.seed ? config.seed : 1;
+  for (uint8_t i = 0; i < DOWNLINK_SIZE; i++) downlink[i] = 0x11 * i;
+  clearStats();
+}
+
+bool NetworkSim::uplink(const char *device, const uint8_t *payload, uint8_t length,
+                        bool downlinkRequested, uint8_t downlink0[DOWNLINK_SIZE], unsigned long time) {
+  //  Sequence numbers count every uplink sent, received or not.
+  stats.uplinks++;
+  const unsigned long seqNumber = sequence[device]++;
+  uint8_t stationsReceived = 0;
+  for (uint8_t i = 0; i < config.stations; i++) {
+    if (!chance(config.stationLossPercent)) stationsReceived++;
+  }
+  if (stationsReceived == 0) { stats.lost++; return false; }
+
+  const unsigned long latency = config.latency + (config.jitter ? nextRandom() % (config.jitter + 1) : 0);
+  stats.callbacks++;
+  stats.latencyTotal += latency;
+  if (latency > stats.latencyMax) stats.latencyMax = latency;
+  bool answered = false;
+  if (downlinkRequested) {
+    stats.downlinkRequests++;
+    if (answer(device, payload, length, downlink0)) {
+      //  The answer goes through the callback, so both latencies count.
+      if (latency + config.backendLatency <= config.answerDeadline) { stats.downlinksAnswered++; answered = true; }
+      else stats.downlinksLate++;
+    }
+  }
+  received(device, payload, length, time + latency);
+  if (!out) return answered;
+  //  Like a Sigfox data callback, with the decoded fields and when it arrived.
+  char hex[2 * MAX_BYTES_PER_MESSAGE + 1];
+  for (uint8_t i = 0; i < length; i++) snprintf(hex + 2 * i, 3, "%02x", payload[i]);
+  hex[2 * length] = 0;
+  const unsigned long long arrived = (unsigned long long) config.startTime * 1000 + time + latency;
+  fprintf(out, "{\"device\":\"%s\",\"time\":%llu,\"seqNumber\":%lu,\"data\":\"%s\",\"ack\":%s,"
+          "\"stations\":%u,\"rssi\":%.1f,\"decoded\":%s,\"arrived\":%llu.%03u}\n",
+          device, (unsigned long long) config.startTime + time / 1000, seqNumber, hex,
+          downlinkRequested ? "true" : "false", stationsReceived, -100.0 - nextRandom() % 400 / 10.0,
+          decode(payload, length).c_str(), arrived / 1000, (unsigned) (arrived % 1000));
+  return answered;
+}
+
+bool NetworkSim::answer(const char *device, const uint8_t *payload, uint8_t length,
+                        uint8_t downlink0[DOWNLINK_SIZE]) {
+  memcpy(downlink0, downlink, DOWNLINK_SIZE);
+  return true;
+}
+
+std::string NetworkSim::decode(const uint8_t *payload, uint8_t length) {
+  switch (format) {
+    case FORMAT_MESSAGE: {
+      char hex[2 * MAX_BYTES_PER_MESSAGE + 1];
+      for (uint8_t i = 0; i < length; i++) snprintf(hex + 2 * i, 3, "%02x", payload[i]);
+      hex[2 * length] = 0;
+      return Message::decodeMessage(hex).c_str();
+    }
+    case FORMAT_CUSTOM: {
+      std::string json;
+      payloadPlan.toJson(payload, length, json);
+      return json;
+    }
+    default:
+      return "{}";
+  }
+}
+
+void NetworkSim::setFormat(PayloadFormat format0) { format = format0; }
+
+bool NetworkSim::setPayloadConfig(const char *text, std::string &error) {
+  PayloadConfig payloadConfig;
+  if (!parsePayloadConfig(text, payloadConfig, error)) return false;
+  payloadPlan = PayloadPlan(payloadConfig);
+  format = FORMAT_CUSTOM;
+  return true;
+}
+
+bool NetworkSim::chance(uint8_t percent) {
+  return percent > 0 && nextRandom() % 100 < percent;
+}
+
+unsigned long NetworkSim::nextRandom() {
+  randomState = randomState * 1103515245 + 12345;
+  return (randomState >> 16) & 0x7fff;
+}
+
+void NetworkSim::getStats(NetworkSimStats &stats0) { stats0 = stats; }
+
+void NetworkSim::clearStats() { memset(&stats, 0, sizeof(stats)); }
@@ -0,0 +1,82 @@
+//  Local stand-in for the Sigfox network and callback pipeline, in place of the UnaBiz
+//  emulator.  Receives the uplinks of simulated modules, loses them or delays them like
+//  the network, decodes them and writes each one as a callback-style JSON line.  Answers
+//  downlink requests if the backend replies within the deadline.
+#ifndef UNABIZ_ARDUINO_NETWORK_SIM_H
+#define UNABIZ_ARDUINO_NETWORK_SIM_H
+
+#include <stdio.h>
+#include <map>
+#include <string>
+#include "UplinkSink.h"
+#include "PayloadPlan.h"
+
+struct NetworkSimConfig {
+  unsigned long latency;  //  ms from the end of the uplink to the callback.
+  unsigned long jitter;  //  Max random ms added to the latency.
+  uint8_t stations;  //  Base stations in range of each device.
+  uint8_t stationLossPercent;  //  Uplinks missed by each station.  Lost if all stations miss it.
+  unsigned long backendLatency;  //  ms for the backend to answer a downlink request.
+  unsigned long answerDeadline;  //  ms from the end of the uplink until the answer is too late.
+  unsigned long startTime;  //  Unix time (seconds) at millis() 0, for the callback time.
+  unsigned long seed;  //  Seed for the losses and jitter, so runs are repeatable.
+};
+
+//  2 to 3 seconds to the callback, 3 stations in range, backend answers in 200 ms, 4 s allowed.
+const NetworkSimConfig DEFAULT_NETWORK_SIM = { 2000, 1000, 3, 10, 200, 4000, 1735689600, 1 };
+
+//  How the payload is decoded for the callback.
+enum PayloadFormat {
+  FORMAT_RAW,  //  Only the hex data.
+  FORMAT_MESSAGE,  //  Fields encoded by Message::addField().
+  FORMAT_CUSTOM,  //  Custom Payload Config, set by setPayloadConfig().
+};
+
+struct NetworkSimStats {
+  unsigned long uplinks;  //  Uplinks sent on air by the modules.
+  unsigned long lost;  //  Uplinks missed by all stations.
+  unsigned long callbacks;  //  Callbacks written.
+  unsigned long downlinkRequests;  //  Callbacks that asked for a downlink.
+  unsigned long downlinksAnswered;  //  Downlinks answered within the deadline.
+  unsigned long downlinksLate;  //  Downlinks answered too late for the device.
+  unsigned long latencyTotal;  //  Sum of ms from the end of the uplink to the callback.
+  unsigned long latencyMax;
+};
+
+class NetworkSim: public UplinkSink {
+public:
+  //  Write the callbacks to out, or nowhere if out is 0.
+  NetworkSim(const NetworkSimConfig &config = DEFAULT_NETWORK_SIM, FILE *out = stdout);
+  virtual ~NetworkSim() {}
+  bool uplink(const char *device, const uint8_t *payload, uint8_t length,
+              bool downlinkRequested, uint8_t downlink[DOWNLINK_SIZE], unsigned long time);
+  void setFormat(PayloadFormat format);
+  bool setPayloadConfig(const char *config, std::string &error);  //  Also selects FORMAT_CUSTOM.
+  void getStats(NetworkSimStats &stats);
+  void clearStats();
+
+  uint8_t downlink[DOWNLINK_SIZE];  //  Returned by answer() unless overridden.
+
+protected:
+  //  The backend's answer to a downlink request.  Return false for no downlink.
+  virtual bool answer(const char *device, const uint8_t *payload, uint8_t length,
+                      uint8_t downlink[DOWNLINK_SIZE]);
+  //  Called for each callback, arriving at millis() arrived, e.g. to measure end-to-end latency.
+  virtual void received(const char *device, const uint8_t *payload, uint8_t length,
+                        unsigned long arrived) {}
+
+private:
+  std::string decode(const uint8_t *payload, uint8_t length);
+  unsigned long nextRandom();
+  bool chance(uint8_t percent);
+
+  NetworkSimConfig config;
+  NetworkSimStats stats;
+  FILE *out;
+  PayloadFormat format;
+  PayloadPlan payloadPlan;  //  Compiled from the Custom Payload Config.
+  std::map<std::string, unsigned long> sequence;  //  Next sequence number of each device.
+  unsigned long randomState;  //  State of nextRandom().
+};
+
+#endif // UNABIZ_ARDUINO_NETWORK_SIM_H
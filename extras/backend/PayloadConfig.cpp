@@ -0,0 +1,159 @@
+//  Decoder for the "Custom Payload Config" of Sigfox callbacks.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PayloadConfig.h"
+
+static std::vector<std::string> split(const std::string &text, char separator) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  for (;;) {
+    const size_t end = text.find(separator, start);
+    parts.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    if (end == std::string::npos) return parts;
+    start = end + 1;
+  }
+}
+
+static bool parseNumber(const std::string &text, unsigned long &value) {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+  value = strtoul(text.c_str(), 0, 10);
+  return true;
+}
+
+static bool parseField(const std::string &text, size_t next, PayloadField &field, std::string &error) {
+  //  name:byteIndex:type:arguments
+  const std::vector<std::string> parts = split(text, ':');
+  if (parts.size() < 4 || parts[0].empty()) { error = "expected name:byteIndex:type:size in " + text; return false; }
+  field.name = parts[0];
+  unsigned long value = 0;
+  if (parts[1].empty()) field.byteIndex = next;
+  else if (parseNumber(parts[1], value) && value < 256) field.byteIndex = value;
+  else { error = "bad byte index in " + text; return false; }
+  const std::string &type = parts[2];
+  if (!parseNumber(parts[3], value)) { error = "bad size in " + text; return false; }
+  field.littleEndian = false;
+  field.bit = 0;
+  size_t arguments = 4;
+  if (type == "bool") {
+    if (value > 7) { error = "bit index must be 0 to 7 in " + text; return false; }
+    field.type = PAYLOAD_BOOL;
+    field.size = 1;
+    field.bit = value;
+  } else if (type == "char") {
+    if (value < 1 || value > 12) { error = "char length must be 1 to 12 in " + text; return false; }
+    field.type = PAYLOAD_CHAR;
+    field.size = value;
+  } else if (type == "uint" || type == "int" || type == "float") {
+    field.type = type == "uint" ? PAYLOAD_UINT : type == "int" ? PAYLOAD_INT : PAYLOAD_FLOAT;
+    if (field.type == PAYLOAD_FLOAT ? (value != 32 && value != 64) : (value < 8 || value > 64 || value % 8 != 0)) {
+      error = "unsupported size in " + text;
+      return false;
+    }
+    field.size = value;
+    arguments = 5;
+    if (parts.size() > 4) {
+      if (parts[4] == "little-endian") field.littleEndian = true;
+      else if (parts[4] != "big-endian") { error = "bad endianness in " + text; return false; }
+    }
+  } else {
+    error = "unknown type in " + text;
+    return false;
+  }
+  if (parts.size() > arguments) { error = "too many arguments in " + text; return false; }
+  return true;
+}
+
+static size_t fieldBytes(const PayloadField &field) {
+  return field.type == PAYLOAD_UINT || field.type == PAYLOAD_INT || field.type == PAYLOAD_FLOAT ?
+         field.size / 8 : field.size;
+}
+
+bool parsePayloadConfig(const char *text, PayloadConfig &config, std::string &error) {
+  config.clear();
+  size_t next = 0;  //  Byte after the previous field.
+  const char *p = text;
+  while (*p) {
+    while (*p == ' ' || *p == '\t') p++;
+    if (!*p) break;
+    const char *end = p + strcspn(p, " \t");
+    PayloadField field;
+    if (!parseField(std::string(p, end), next, field, error)) return false;
+    next = field.byteIndex + fieldBytes(field);
+    config.push_back(field);
+    p = end;
+  }
+  if (config.empty()) { error = "no fields"; return false; }
+  return true;
+}
+
+static uint64_t readInteger(const PayloadField &field, const uint8_t *bytes) {
+  const size_t count = field.size / 8;
+  uint64_t value = 0;
+  for (size_t i = 0; i < count; i++) {
+    value = (value << 8) | bytes[field.littleEndian ? count - 1 - i : i];
+  }
+  return value;
+}
+
+void appendJsonString(std::string &json, const char *s, size_t length) {
+  json += '"';
+  for (size_t i = 0; i < length && s[i]; i++) {
+    const unsigned char c = s[i];
+    if (c == '"' || c == '\\') { json += '\\'; json += c; }
+    else if (c < 0x20 || c > 0x7e) { char escaped[8]; snprintf(escaped, sizeof(escaped), "\\u%04x", c); json += escaped; }
+    else json += c;
+  }
+  json += '"';
+}
+
+std::string decodePayload(const PayloadConfig &config, const uint8_t *payload, size_t length) {
+  std::string json = "{";
+  for (size_t f = 0; f < config.size(); f++) {
+    const PayloadField &field = config[f];
+    if (field.byteIndex + fieldBytes(field) > length) continue;
+    const uint8_t *bytes = payload + field.byteIndex;
+    if (json.size() > 1) json += ',';
+    appendJsonString(json, field.name.c_str(), field.name.size());
+    json += ':';
+    char number[32];
+    switch (field.type) {
+      case PAYLOAD_BOOL:
+        json += (bytes[0] >> field.bit) & 1 ? "true" : "false";
+        break;
+      case PAYLOAD_CHAR:
+        appendJsonString(json, (const char *) bytes, field.size);
+        break;
+      case PAYLOAD_UINT:
+        snprintf(number, sizeof(number), "%llu", (unsigned long long) readInteger(field, bytes));
+        json += number;
+        break;
+      case PAYLOAD_INT: {
+        uint64_t value = readInteger(field, bytes);
+        if (field.size < 64 && (value >> (field.size - 1)) & 1) value |= ~(uint64_t) 0 << field.size;
+        snprintf(number, sizeof(number), "%lld", (long long) value);
+        json += number;
+        break;
+      }
+      case PAYLOAD_FLOAT: {
+        const uint64_t value = readInteger(field, bytes);
+        double d;
+        if (field.size == 32) {
+          const uint32_t bits = value;
+          float f;
+          memcpy(&f, &bits, sizeof(f));
+          d = f;
+        } else {
+          memcpy(&d, &value, sizeof(d));
+        }
+        //  JSON has no NaN or infinity.
+        if (d != d || d - d != 0) json += "null";
+        else { snprintf(number, sizeof(number), field.size == 32 ? "%.7g" : "%.17g", d); json += number; }
+        break;
+      }
+    }
+  }
+  json += '}';
+  return json;
+}
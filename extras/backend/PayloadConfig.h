@@ -0,0 +1,41 @@
+//  Decoder for the "Custom Payload Config" of Sigfox callbacks, e.g.
+//    count::uint:16:little-endian temperature::float:32 voltage::float:32
+//  so that payloads can be checked against the callback config on the host.
+#ifndef UNABIZ_ARDUINO_PAYLOAD_CONFIG_H
+#define UNABIZ_ARDUINO_PAYLOAD_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+enum PayloadType {
+  PAYLOAD_BOOL,  //  bool:bit, bit 0 to 7 of one byte.
+  PAYLOAD_CHAR,  //  char:length, length bytes of text.
+  PAYLOAD_UINT,  //  uint:bits[:endianness], bits a multiple of 8, up to 64.
+  PAYLOAD_INT,  //  int:bits[:endianness], two's complement.
+  PAYLOAD_FLOAT,  //  float:32 or float:64[:endianness], IEEE 754.
+};
+
+//  One field, written as name:byteIndex:type:arguments.  If byteIndex is empty, the field
+//  starts after the previous one.  Endianness is big-endian unless little-endian is given.
+struct PayloadField {
+  std::string name;
+  size_t byteIndex;  //  First byte of the field.
+  PayloadType type;
+  uint8_t size;  //  Bits for uint, int and float, bytes for char, 1 for bool.
+  uint8_t bit;  //  For bool: bit index, 7 is the most significant.
+  bool littleEndian;
+};
+
+typedef std::vector<PayloadField> PayloadConfig;
+
+//  Parse the config.  Returns false with a message in error if it is not valid.
+bool parsePayloadConfig(const char *text, PayloadConfig &config, std::string &error);
+//  Decode the payload into a JSON object like {"count":1,"temperature":25.5}.  Fields that
+//  extend past the end of the payload are left out, like in the Sigfox backend.
+std::string decodePayload(const PayloadConfig &config, const uint8_t *payload, size_t length);
+//  Append the text as a JSON string, up to length bytes or the first 0 byte.
+void appendJsonString(std::string &json, const char *s, size_t length);
+
+#endif // UNABIZ_ARDUINO_PAYLOAD_CONFIG_H
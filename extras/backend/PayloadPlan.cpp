@@ -0,0 +1,132 @@
+//  Decode plan compiled from a Custom Payload Config.
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "PayloadPlan.h"
+
+PayloadPlan::PayloadPlan(const PayloadConfig &config0): config(config0) {
+  for (size_t f = 0; f < config.size(); f++) {
+    const PayloadField &field = config[f];
+    PayloadStep step;
+    step.type = field.type;
+    step.byteIndex = field.byteIndex;
+    step.bytes = field.type == PAYLOAD_BOOL ? 1 : field.type == PAYLOAD_CHAR ? field.size : field.size / 8;
+    step.end = step.byteIndex + step.bytes;
+    step.step = field.littleEndian ? -1 : 1;
+    step.first = field.littleEndian ? step.end - 1 : step.byteIndex;
+    step.shift = field.type == PAYLOAD_BOOL ? field.bit : field.type == PAYLOAD_INT ? 64 - field.size : 0;
+    steps.push_back(step);
+    if (step.end > bytes) bytes = step.end;
+    std::string key;
+    if (f > 0) key += ',';
+    appendJsonString(key, field.name.c_str(), field.name.size());
+    key += ':';
+    keys.push_back(key);
+  }
+}
+
+static inline uint64_t readInteger(const PayloadStep &step, const uint8_t *payload) {
+  const uint8_t *p = payload + step.first;
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < step.bytes; i++, p += step.step) value = (value << 8) | *p;
+  return value;
+}
+
+static inline void decodeStep(const PayloadStep &step, const uint8_t *payload, PayloadValue &value) {
+  switch (step.type) {
+    case PAYLOAD_BOOL:
+      value.u = (payload[step.byteIndex] >> step.shift) & 1;
+      break;
+    case PAYLOAD_CHAR: {
+      const void *zero = memchr(payload + step.byteIndex, 0, step.bytes);
+      value.u = zero ? (const uint8_t *) zero - (payload + step.byteIndex) : step.bytes;
+      break;
+    }
+    case PAYLOAD_UINT:
+      value.u = readInteger(step, payload);
+      break;
+    case PAYLOAD_INT:
+      //  Shift the sign bit to the top, then back with the sign extended.
+      value.i = (int64_t) (readInteger(step, payload) << step.shift) >> step.shift;
+      break;
+    case PAYLOAD_FLOAT:
+      if (step.bytes == 4) {
+        const uint32_t bits = readInteger(step, payload);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        value.d = f;
+      } else {
+        const uint64_t bits = readInteger(step, payload);
+        memcpy(&value.d, &bits, sizeof(value.d));
+      }
+      break;
+  }
+}
+
+void PayloadPlan::decode(const uint8_t *payload, size_t length, PayloadValue *values) const {
+  for (size_t f = 0; f < steps.size(); f++) {
+    if (steps[f].end <= length) decodeStep(steps[f], payload, values[f]);
+    else values[f].u = 0;
+  }
+}
+
+void PayloadPlan::decodeRange(const PayloadBatch &batch, size_t begin, size_t end, PayloadValue *values) const {
+  const size_t fields = steps.size();
+  for (size_t n = begin; n < end; n++)
+    decode(batch.frames + n * PAYLOAD_SLOT, batch.lengths[n], values + n * fields);
+}
+
+void PayloadPlan::decodeBatch(const PayloadBatch &batch, PayloadValue *values, unsigned threads) const {
+  //  Each thread decodes a contiguous range of frames into its own part of values.
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  if (threads > batch.count / 1024 + 1) threads = batch.count / 1024 + 1;  //  Not worth a thread for fewer.
+  if (threads <= 1) { decodeRange(batch, 0, batch.count, values); return; }
+  std::vector<std::thread> workers;
+  const size_t chunk = (batch.count + threads - 1) / threads;
+  for (size_t begin = chunk; begin < batch.count; begin += chunk) {
+    const size_t end = begin + chunk < batch.count ? begin + chunk : batch.count;
+    workers.push_back(std::thread(&PayloadPlan::decodeRange, this, std::cref(batch), begin, end, values));
+  }
+  decodeRange(batch, 0, chunk, values);
+  for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+void PayloadPlan::toJson(const uint8_t *payload, size_t length, std::string &json) const {
+  //  Fields past the end of the frame are left out, so the first field written has no comma.
+  PayloadValue value = {};
+  char number[32];
+  const size_t start = json.size();
+  json += '{';
+  for (size_t f = 0; f < steps.size(); f++) {
+    const PayloadStep &step = steps[f];
+    if (step.end > length) continue;
+    decodeStep(step, payload, value);
+    const std::string &key = keys[f];
+    if (json.size() == start + 1 && key[0] == ',') json.append(key, 1, std::string::npos);
+    else json += key;
+    switch (step.type) {
+      case PAYLOAD_BOOL:
+        json += value.u ? "true" : "false";
+        break;
+      case PAYLOAD_CHAR:
+        appendJsonString(json, (const char *) payload + step.byteIndex, value.u);
+        break;
+      case PAYLOAD_UINT:
+        snprintf(number, sizeof(number), "%llu", (unsigned long long) value.u);
+        json += number;
+        break;
+      case PAYLOAD_INT:
+        snprintf(number, sizeof(number), "%lld", (long long) value.i);
+        json += number;
+        break;
+      case PAYLOAD_FLOAT:
+        //  JSON has no NaN or infinity.
+        if (value.d != value.d || value.d - value.d != 0) json += "null";
+        else { snprintf(number, sizeof(number), step.bytes == 4 ? "%.7g" : "%.17g", value.d); json += number; }
+        break;
+    }
+  }
+  json += '}';
+}
@@ -0,0 +1,70 @@
+//  Decode plan compiled from a Custom Payload Config: the offset, byte count, byte order
+//  and shifts of each field are worked out once, so that frames decode without looking at
+//  the config again.  Batches of frames decode into typed values on several threads, for
+//  checking or ingesting many payloads; toJson() gives the same text as decodePayload().
+#ifndef UNABIZ_ARDUINO_PAYLOAD_PLAN_H
+#define UNABIZ_ARDUINO_PAYLOAD_PLAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "PayloadConfig.h"
+
+//  Frames of a batch are stored in slots of this many bytes, the largest Sigfox payload.
+const size_t PAYLOAD_SLOT = 12;
+
+//  Decoded value of a field: u for uint and bool (0 or 1), i for int, d for float, and u
+//  for char, the number of characters before the first 0 byte.
+union PayloadValue {
+  uint64_t u;
+  int64_t i;
+  double d;
+};
+
+//  Frames to decode: frame n is lengths[n] bytes at frames + n * PAYLOAD_SLOT.
+struct PayloadBatch {
+  const uint8_t *frames;
+  const uint8_t *lengths;
+  size_t count;
+};
+
+//  A field, ready to decode.
+struct PayloadStep {
+  PayloadType type;
+  uint16_t byteIndex;
+  uint16_t end;  //  Byte after the field.  Frames shorter than this don't have the field.
+  uint8_t bytes;
+  int8_t step;  //  1 to read the bytes most significant first, -1 for little-endian.
+  uint16_t first;  //  Byte read first: byteIndex, or the last byte if little-endian.
+  uint8_t shift;  //  For int: 64 - bits, to extend the sign.  For bool: the bit.
+};
+
+class PayloadPlan {
+public:
+  PayloadPlan() {}
+  explicit PayloadPlan(const PayloadConfig &config);
+  size_t fieldCount() const { return steps.size(); }
+  size_t length() const { return bytes; }  //  Bytes needed for all the fields.
+  const PayloadField &field(size_t f) const { return config[f]; }
+  //  True if a frame of this length has the field.
+  bool present(size_t f, size_t length) const { return steps[f].end <= length; }
+  //  Decode the fields into values[0 .. fieldCount() - 1].  Fields missing from the
+  //  frame are 0.
+  void decode(const uint8_t *payload, size_t length, PayloadValue *values) const;
+  //  Decode frame n into values[n * fieldCount() ..], using threads threads, or one per
+  //  processor if 0.
+  void decodeBatch(const PayloadBatch &batch, PayloadValue *values, unsigned threads = 0) const;
+  //  Append the JSON object of decodePayload() to json.
+  void toJson(const uint8_t *payload, size_t length, std::string &json) const;
+
+private:
+  void decodeRange(const PayloadBatch &batch, size_t begin, size_t end, PayloadValue *values) const;
+
+  PayloadConfig config;
+  std::vector<PayloadStep> steps;
+  std::vector<std::string> keys;  //  "name": of each field, escaped for JSON.
+  size_t bytes = 0;
+};
+
+#endif // UNABIZ_ARDUINO_PAYLOAD_PLAN_H
@@ -0,0 +1,169 @@
+//  Runs the device-to-backend path on one machine: the Wisol driver and UplinkQueue send
+//  readings to the simulated module, the simulated network loses or delays them, and each
+//  one that gets through is written as a callback-style JSON line.  Every n-th message asks
+//  for a downlink, which the backend answers if it is in time.  Reports the end-to-end
+//  latency from queueing a reading to its callback, and the throughput.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run with options as name=value.  Callbacks go to stdout, the report to stderr:
+//    ./network_sim messages=100 format=demo downlinkevery=10 > callbacks.json
+//  Options: messages, interval (ms), downlinkevery, format (message, demo or raw),
+//  config (Custom Payload Config for the demo format), latency, jitter, stations,
+//  loss (percent per station), backend, deadline (ms), seed, out (file for the callbacks).
+//  The demo format sends count, temperature and voltage like the basic-demo example.
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "WisolSim.h"
+#include "NetworkSim.h"
+
+static const char *DEMO_CONFIG = "count::uint:16:little-endian temperature::float:32 voltage::float:32";
+
+struct Options {
+  unsigned long messages = 100;
+  unsigned long interval = SEND_DELAY;
+  unsigned long downlinkEvery = 0;
+  String format = "message";
+  String config = DEMO_CONFIG;
+  String out;
+  NetworkSimConfig network = DEFAULT_NETWORK_SIM;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const String name = String(arg).substring(0, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "messages") options.messages = value;
+  else if (name == "interval") options.interval = value;
+  else if (name == "downlinkevery") options.downlinkEvery = value;
+  else if (name == "format") options.format = equals + 1;
+  else if (name == "config") options.config = equals + 1;
+  else if (name == "out") options.out = equals + 1;
+  else if (name == "latency") options.network.latency = value;
+  else if (name == "jitter") options.network.jitter = value;
+  else if (name == "stations") options.network.stations = value;
+  else if (name == "loss") options.network.stationLossPercent = value;
+  else if (name == "backend") options.network.backendLatency = value;
+  else if (name == "deadline") options.network.answerDeadline = value;
+  else if (name == "seed") options.network.seed = value;
+  else return false;
+  return true;
+}
+
+//  Backend that measures the latency from queueing each reading to its callback.  The
+//  reading is found by the counter in the payload.
+class Backend: public NetworkSim {
+public:
+  Backend(const NetworkSimConfig &config, FILE *out, bool messageFormat):
+    NetworkSim(config, out), messageFormat(messageFormat) {}
+  std::map<unsigned, unsigned long> queued;  //  millis() when each counter was queued.
+  unsigned long count = 0, total = 0, max = 0;
+
+protected:
+  void received(const char *device, const uint8_t *payload, uint8_t length, unsigned long arrived) {
+    if (length < 4) return;
+    //  Message puts the counter after the field name, scaled by 10.
+    const unsigned counter = messageFormat ? (payload[2] | (payload[3] << 8)) / 10 : payload[0] | (payload[1] << 8);
+    std::map<unsigned, unsigned long>::iterator i = queued.find(counter);
+    if (i == queued.end()) return;
+    const unsigned long latency = arrived - i->second;
+    queued.erase(i);
+    count++;
+    total += latency;
+    if (latency > max) max = latency;
+  }
+
+private:
+  bool messageFormat;
+};
+
+static String floatToHex(float value) {
+  //  Big-endian IEEE 754, all 8 digits.
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  char hex[9];
+  snprintf(hex, sizeof(hex), "%08lx", (unsigned long) bits);
+  return hex;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  FILE *out = stdout;
+  if (options.out.length() > 0 && !(out = fopen(options.out.c_str(), "w"))) { perror(options.out.c_str()); return 1; }
+  const bool messageFormat = options.format == "message";
+  //  The counter in the payload wraps, so readings in flight must have distinct counters.
+  const unsigned wrap = messageFormat ? 6553 : 65536;
+  Backend backend(options.network, out, messageFormat);
+  if (options.format == "demo") {
+    std::string error;
+    if (!backend.setPayloadConfig(options.config.c_str(), error)) { fprintf(stderr, "config: %s\n", error.c_str()); return 2; }
+  } else if (options.format == "raw") {
+    backend.setFormat(FORMAT_RAW);
+  } else if (!messageFormat) {
+    fprintf(stderr, "Unknown format %s\n", options.format.c_str());
+    return 2;
+  }
+
+  WisolSim module(DEFAULT_WISOL_SIM, WISOL_TX);
+  module.setSink(&backend);
+  SoftwareSerial::setModule(&module);
+  static Wisol transceiver(COUNTRY_FR, false, "NOTUSED", false);
+  if (!transceiver.begin()) { fprintf(stderr, "begin failed\n"); return 1; }
+  UplinkQueue queue(transceiver);
+
+  unsigned long downlinks = 0;
+  const unsigned long start = millis();
+  for (unsigned long msg = 0; msg < options.messages; msg++) {
+    hostAdvanceTo((unsigned long long) (start + msg * options.interval) * 1000);
+    const unsigned long cycleEnd = millis() + options.interval;
+    const unsigned counter = msg % wrap;
+    const float temperature = 20 + (msg % 100) / 10.0, voltage = 3.3 - (msg % 30) / 100.0;
+    String payload;
+    if (messageFormat) {
+      Message message(transceiver);
+      message.addField("ctr", (int) counter);
+      message.addField("tmp", temperature);
+      message.addField("vlt", voltage);
+      payload = message.getEncodedMessage();
+    } else {
+      payload = transceiver.toHex((unsigned int) counter) + floatToHex(temperature) + floatToHex(voltage);
+    }
+    backend.queued[counter] = millis();
+    if (options.downlinkEvery > 0 && msg % options.downlinkEvery == 0) {
+      //  Downlinks bypass the queue, as in the examples.  The response is empty if no downlink came.
+      String response;
+      if (transceiver.sendMessageAndGetResponse(payload, response) && response.length() > 0) downlinks++;
+      continue;
+    }
+    queue.push(payload);
+    while (!queue.isEmpty() && millis() < cycleEnd) {
+      if (!queue.isDue()) { hostAdvanceTo((unsigned long long) queue.nextAttemptTime() * 1000); continue; }
+      queue.sendNext();
+    }
+  }
+  if (out != stdout) fclose(out);
+
+  NetworkSimStats stats;
+  backend.getStats(stats);
+  const double hours = (millis() - start) / 3600000.0;
+  fprintf(stderr, "Readings %lu, uplinks %lu, lost by the network %lu, callbacks %lu\n",
+          options.messages, stats.uplinks, stats.lost, stats.callbacks);
+  fprintf(stderr, "Downlinks requested %lu, answered %lu, too late %lu, received by the device %lu\n",
+          stats.downlinkRequests, stats.downlinksAnswered, stats.downlinksLate, downlinks);
+  if (stats.callbacks > 0) {
+    fprintf(stderr, "Network latency ms: avg %lu, max %lu\n", stats.latencyTotal / stats.callbacks, stats.latencyMax);
+  }
+  if (backend.count > 0) {
+    fprintf(stderr, "End-to-end latency ms: avg %lu, max %lu\n", backend.total / backend.count, backend.max);
+  }
+  fprintf(stderr, "Throughput: %.2f callbacks per hour\n", hours > 0 ? stats.callbacks / hours : 0);
+  return 0;
+}
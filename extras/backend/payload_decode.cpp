@@ -0,0 +1,155 @@
+//  Decodes payloads with a Custom Payload Config compiled into a PayloadPlan, to check what
+//  the callback will show for the payloads a device sends, or to measure how fast a batch
+//  of frames decodes on all processors.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//  Decode payloads, one in hex on each line, into JSON lines:
+//    ./payload_decode config="count::uint:16:little-endian temperature::float:32" file=payloads.txt
+//  Or time random frames:
+//    ./payload_decode config="..." frames=10000000 threads=0
+//  Options: config, file, frames (random frames to time, default 1000000), threads (0 for
+//  one per processor), check (1 to compare each frame's JSON with decodePayload(), the
+//  decoder the plan is compiled from).
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "PayloadPlan.h"
+
+struct Options {
+  std::string config;
+  std::string file;
+  unsigned long frames = 1000000;
+  unsigned threads = 0;
+  bool check = false;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const std::string name(arg, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "config") options.config = equals + 1;
+  else if (name == "file") options.file = equals + 1;
+  else if (name == "frames") options.frames = value;
+  else if (name == "threads") options.threads = value;
+  else if (name == "check") options.check = value != 0;
+  else return false;
+  return true;
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool parseHex(const char *text, uint8_t *payload, size_t &length) {
+  //  Up to PAYLOAD_SLOT bytes.  Spaces and the line end are ignored.
+  length = 0;
+  for (const char *p = text; *p; ) {
+    if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') { p++; continue; }
+    const int high = hexValue(p[0]);
+    const int low = high < 0 ? -1 : hexValue(p[1]);
+    if (low < 0 || length == PAYLOAD_SLOT) return false;
+    payload[length++] = high << 4 | low;
+    p += 2;
+  }
+  return true;
+}
+
+static bool matchesReference(const PayloadPlan &plan, const PayloadConfig &config,
+                             const uint8_t *payload, size_t length, std::string &json) {
+  json.clear();
+  plan.toJson(payload, length, json);
+  return json == decodePayload(config, payload, length);
+}
+
+static int decodeFile(const Options &options, const PayloadPlan &plan, const PayloadConfig &config) {
+  FILE *file = options.file == "-" ? stdin : fopen(options.file.c_str(), "r");
+  if (!file) { perror(options.file.c_str()); return 1; }
+  char line[256];
+  unsigned long number = 0, mismatches = 0;
+  std::string json;
+  while (fgets(line, sizeof(line), file)) {
+    number++;
+    uint8_t payload[PAYLOAD_SLOT];
+    size_t length;
+    if (!parseHex(line, payload, length)) { fprintf(stderr, "%s:%lu: bad payload\n", options.file.c_str(), number); continue; }
+    if (options.check && !matchesReference(plan, config, payload, length, json)) {
+      fprintf(stderr, "%s:%lu: plan %s, decodePayload %s\n", options.file.c_str(), number, json.c_str(),
+              decodePayload(config, payload, length).c_str());
+      mismatches++;
+    }
+    json.clear();
+    plan.toJson(payload, length, json);
+    printf("%s\n", json.c_str());
+  }
+  if (file != stdin) fclose(file);
+  return mismatches ? 1 : 0;
+}
+
+static double timeBatch(const PayloadPlan &plan, const PayloadBatch &batch, PayloadValue *values,
+                        unsigned threads, unsigned &runs) {
+  //  Seconds per batch, repeated for at least 0.5 seconds.
+  typedef std::chrono::steady_clock Clock;
+  const Clock::time_point start = Clock::now();
+  for (runs = 1;; runs++) {
+    plan.decodeBatch(batch, values, threads);
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    if (elapsed >= 0.5) return elapsed / runs;
+  }
+}
+
+static int timeFrames(const Options &options, const PayloadPlan &plan, const PayloadConfig &config) {
+  //  Random frames, as long as the config or shorter, so that some fields are missing.
+  const size_t longest = plan.length() < PAYLOAD_SLOT ? plan.length() : PAYLOAD_SLOT;
+  std::vector<uint8_t> frames(options.frames * PAYLOAD_SLOT), lengths(options.frames);
+  unsigned long state = 1;
+  for (size_t i = 0; i < frames.size(); i++) { state = state * 1103515245 + 12345; frames[i] = state >> 16; }
+  for (size_t n = 0; n < lengths.size(); n++) lengths[n] = n % 16 ? longest : frames[n * PAYLOAD_SLOT] % (longest + 1);
+  std::vector<PayloadValue> values(options.frames * plan.fieldCount());
+  const PayloadBatch batch = { frames.data(), lengths.data(), options.frames };
+
+  unsigned long mismatches = 0;
+  if (options.check) {
+    std::string json;
+    for (size_t n = 0; n < batch.count; n++) {
+      if (matchesReference(plan, config, &frames[n * PAYLOAD_SLOT], lengths[n], json)) continue;
+      if (mismatches++ < 10) fprintf(stderr, "frame %lu: plan %s, decodePayload %s\n", (unsigned long) n, json.c_str(),
+                                     decodePayload(config, &frames[n * PAYLOAD_SLOT], lengths[n]).c_str());
+    }
+    fprintf(stderr, "%lu of %lu frames differ from decodePayload()\n", mismatches, options.frames);
+  }
+
+  unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  printf("%lu frames of up to %lu bytes, %lu fields\n", options.frames, (unsigned long) longest,
+         (unsigned long) plan.fieldCount());
+  printf("%-10s %8s %14s %12s\n", "threads", "runs", "frames/s", "MB/s in");
+  for (unsigned t = 1;; t = t * 2 < threads ? t * 2 : threads) {
+    unsigned runs;
+    const double seconds = timeBatch(plan, batch, values.data(), t, runs);
+    printf("%-10u %8u %14.0f %12.1f\n", t, runs, options.frames / seconds,
+           options.frames * PAYLOAD_SLOT / seconds / 1e6);
+    if (t == threads) break;
+  }
+  return mismatches ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  PayloadConfig config;
+  std::string error;
+  if (!parsePayloadConfig(options.config.c_str(), config, error)) { fprintf(stderr, "config: %s\n", error.c_str()); return 2; }
+  const PayloadPlan plan(config);
+  if (!options.file.empty()) return decodeFile(options, plan, config);
+  return timeFrames(options, plan, config);
+}
@@ -0,0 +1,156 @@
+//  Checks PayloadEncoder, which the sketches use to pack their payloads, against PayloadPlan,
+//  which decodes them like the callback: random values are encoded with the Custom Payload
+//  Configs of the examples and a few that use every type, decoded again, and compared.  Also
+//  checks that float:64 fields are right on the AVR, where double is a float.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//    ./payload_encode frames=100000
+//  Options: frames (random payloads for each config, default 100000).
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "PayloadPlan.h"
+
+struct Options {
+  unsigned long frames = 100000;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const std::string name(arg, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "frames") options.frames = value;
+  else return false;
+  return true;
+}
+
+extern constexpr char BUTTON_CONFIG[] = "button::bool:7";
+extern constexpr char DEMO_CONFIG[] = "count::uint:16:little-endian temperature::float:32 voltage::float:32";
+extern constexpr char BME280_CONFIG[] = "temperature::float:32 humidity::float:32 pressure::uint:16 altitude::int:16";
+extern constexpr char ACCELEROMETER_CONFIG[] = "acc::float:32 orientation::char:3";
+extern constexpr char GPS_CONFIG[] = "lat::float:32 lng::float:32";
+extern constexpr char LIGHT_CONFIG[] = "lux::uint:16:little-endian isBright::bool:7";
+extern constexpr char INTEGER_CONFIG[] = "a::uint:8 b::int:24:little-endian c::uint:40 d::int:16:big-endian";
+extern constexpr char WIDE_CONFIG[] = "e::int:64 f::uint:32:little-endian";
+extern constexpr char BITS_CONFIG[] = "x:0:bool:0 y:0:bool:3 z:0:bool:7 v:1:int:8 w::char:2 u::float:64:little-endian";
+
+static uint64_t state = 1;
+
+static uint64_t random64() {
+  state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return state ^ (state >> 29);
+}
+
+//  A random value of each type, and what PayloadPlan should decode.
+static void randomValue(bool &value, PayloadValue &expected, uint8_t) {
+  value = random64() & 1;
+  expected.u = value;
+}
+
+static void randomValue(const char *&value, PayloadValue &expected, uint8_t bytes) {
+  static char text[16];
+  const uint8_t length = random64() % (bytes + 1);
+  for (uint8_t i = 0; i < length; i++) text[i] = 'A' + random64() % 26;
+  text[length] = 0;
+  value = text;
+  expected.u = length;
+}
+
+static void randomValue(float &value, PayloadValue &expected, uint8_t) {
+  const uint32_t bits = random64();
+  memcpy(&value, &bits, sizeof(value));
+  expected.d = value;
+}
+
+static void randomValue(double &value, PayloadValue &expected, uint8_t) {
+  const uint64_t bits = random64();
+  memcpy(&value, &bits, sizeof(value));
+  expected.d = value;
+}
+
+template <typename T> static void randomValue(T &value, PayloadValue &expected, uint8_t bytes) {
+  //  Integers: only the bytes of the field are sent, so the rest must be a sign extension.
+  const int shift = 64 - 8 * bytes;
+  const uint64_t bits = random64();
+  if ((T) -1 < 0) { value = (T) ((int64_t) (bits << shift) >> shift); expected.i = value; }
+  else { value = (T) ((bits << shift) >> shift); expected.u = value; }
+}
+
+static bool sameValue(const PayloadValue &a, const PayloadValue &b, PayloadType type) {
+  if (type != PAYLOAD_FLOAT) return a.u == b.u;
+  return a.d == b.d || (isnan(a.d) && isnan(b.d));
+}
+
+//  Set fields f and after to random values.
+template <const char *config, uint8_t f, bool done = f == PayloadEncoder<config>::fields> struct RandomFields {
+  static void set(PayloadEncoder<config> &encoder, PayloadValue *expected) {
+    typename PayloadEncoder<config>::template Field<f>::Put::Value value;
+    randomValue(value, expected[f], PayloadGrammar::bytes(config, f));
+    encoder.template set<f>(value);
+    RandomFields<config, f + 1>::set(encoder, expected);
+  }
+};
+template <const char *config, uint8_t f> struct RandomFields<config, f, true> {
+  static void set(PayloadEncoder<config> &, PayloadValue *) {}
+};
+
+template <const char *config> static unsigned long check(const Options &options) {
+  PayloadConfig parsed;
+  std::string error;
+  if (!parsePayloadConfig(config, parsed, error)) { fprintf(stderr, "%s: %s\n", config, error.c_str()); return 1; }
+  const PayloadPlan plan(parsed);
+  unsigned long mismatches = 0;
+  if (plan.fieldCount() != PayloadEncoder<config>::fields || plan.length() != PayloadEncoder<config>::length) {
+    fprintf(stderr, "%s: encoder has %u fields in %u bytes, plan %u in %u\n", config,
+            PayloadEncoder<config>::fields, PayloadEncoder<config>::length,
+            (unsigned) plan.fieldCount(), (unsigned) plan.length());
+    return 1;
+  }
+  PayloadEncoder<config> encoder;
+  PayloadValue expected[PayloadEncoder<config>::fields], decoded[PayloadEncoder<config>::fields];
+  for (unsigned long n = 0; n < options.frames; n++) {
+    RandomFields<config, 0>::set(encoder, expected);
+    plan.decode(encoder.getBytes(), encoder.length, decoded);
+    for (uint8_t f = 0; f < PayloadEncoder<config>::fields; f++) {
+      if (sameValue(expected[f], decoded[f], plan.field(f).type)) continue;
+      if (mismatches++ < 10) fprintf(stderr, "%s: field %s of %s\n", config, plan.field(f).name.c_str(), encoder.hex());
+    }
+  }
+  printf("%-100s %lu mismatches\n", config, mismatches);
+  return mismatches;
+}
+
+static unsigned long checkWidening(const Options &options) {
+  //  Widening the bits of a float, as on the AVR, must give the bits of the double.
+  unsigned long mismatches = 0;
+  for (unsigned long n = 0; n < options.frames; n++) {
+    const uint32_t single = random64();
+    float value;
+    memcpy(&value, &single, sizeof(value));
+    const double wide = value;
+    uint64_t bits;
+    memcpy(&bits, &wide, sizeof(bits));
+    if (isnan(value) || bits == PayloadDouble<4>::bits(value)) continue;
+    if (mismatches++ < 10) fprintf(stderr, "float %08lx widened wrongly\n", (unsigned long) single);
+  }
+  printf("%-100s %lu mismatches\n", "float to float:64 on the AVR", mismatches);
+  return mismatches;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  const unsigned long mismatches = check<BUTTON_CONFIG>(options) + check<DEMO_CONFIG>(options) +
+    check<BME280_CONFIG>(options) + check<ACCELEROMETER_CONFIG>(options) + check<GPS_CONFIG>(options) +
+    check<LIGHT_CONFIG>(options) + check<INTEGER_CONFIG>(options) + check<WIDE_CONFIG>(options) +
+    check<BITS_CONFIG>(options) +
+    checkWidening(options);
+  return mismatches ? 1 : 0;
+}
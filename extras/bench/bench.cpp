@@ -0,0 +1,47 @@
+//  Microbenchmarks for the library's encoders and the parsers used by the examples.
+//  Each kernel is repeated until it has run for at least 0.2 seconds.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//  Run all benchmarks, or only those whose name contains the filter:
+//    ./bench [filter]
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include "Wire.h"
+#include "kernels.h"
+
+static void benchBegin() {
+  //  Channel readings for calculateLux(), read through the I2C registers.
+  hostWireSetRegister(TSL2561_Channal0L, 0x34);
+  hostWireSetRegister(TSL2561_Channal0H, 0x02);
+  hostWireSetRegister(TSL2561_Channal1L, 0x80);
+  hostWireSetRegister(TSL2561_Channal1H, 0x00);
+  TSL2561.getLux();
+}
+
+static double timeKernel(const BenchKernel &kernel, unsigned long &iterations) {
+  //  Return the nanoseconds per call.
+  typedef std::chrono::steady_clock Clock;
+  for (iterations = 16;; iterations *= 2) {
+    const Clock::time_point start = Clock::now();
+    for (unsigned long i = 0; i < iterations; i++) kernel.run();
+    const double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (elapsed >= 2e8) return elapsed / iterations;
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *filter = argc > 1 ? argv[1] : "";
+  benchBegin();
+  printf("%-34s %12s %12s\n", "benchmark", "iterations", "ns/call");
+  for (uint8_t i = 0; i < benchKernelCount; i++) {
+    const BenchKernel &kernel = benchKernels[i];
+    if (!strstr(kernel.name, filter)) continue;
+    unsigned long iterations;
+    const double ns = timeKernel(kernel, iterations);
+    printf("%-34s %12lu %12.1f\n", kernel.name, iterations, ns);
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+//  Kernels timed by the benchmarks.  Each one does a single unit of work, so the same
+//  table can be timed natively or counted in cycles on an AVR simulator.
+#ifndef UNABIZ_ARDUINO_BENCH_KERNELS_H
+#define UNABIZ_ARDUINO_BENCH_KERNELS_H
+
+#include "SIGFOX.h"
+#include "TinyGPS++.h"
+#include "Digital_Light_TSL2561.h"
+
+//  Results are stored here so the compiler can't drop the work.
+static volatile unsigned long benchSink;
+
+static Wisol benchWisol(COUNTRY_SG, false, "NOTUSED", false);
+static TinyGPSPlus benchGPS;
+
+//  NMEA sentences like those captured from the Grove GPS.  In flash, like the kernel
+//  names, so that the table fits in the Uno's RAM next to the library.
+static const char benchNMEA[] PROGMEM =
+  "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n"
+  "$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*0A\r\n"
+  "$GPRMC,092751.000,A,5321.6802,N,00630.3371,W,0.06,31.66,280511,,,A*45\r\n"
+  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+  "$GPRMC,225446,A,4916.45,N,12311.12,W,000.5,054.7,191194,020.3,E*68\r\n";
+
+static void benchAddField() {
+  Message msg(benchWisol);
+  msg.addField("ctr", 123);
+  msg.addField("tmp", 36.5f);
+  msg.addField("vlt", 12.3);
+  benchSink = msg.getEncodedMessage().length();
+}
+
+static void benchDecodeMessage() {
+  benchSink = Message::decodeMessage("920e0a00b051060194592000").length();
+}
+
+static void benchToHexInt() { benchSink = benchWisol.toHex((int) -1234).length(); }
+static void benchToHexUnsignedInt() { benchSink = benchWisol.toHex((unsigned int) 54321).length(); }
+static void benchToHexLong() { benchSink = benchWisol.toHex((long) -12345678).length(); }
+static void benchToHexUnsignedLong() { benchSink = benchWisol.toHex((unsigned long) 87654321).length(); }
+static void benchToHexFloat() { benchSink = benchWisol.toHex(3.14159f).length(); }
+static void benchToHexDouble() { benchSink = benchWisol.toHex(2.71828).length(); }
+static void benchToHexChar() { benchSink = benchWisol.toHex('A').length(); }
+
+static void benchToHexBuffer() {
+  char buffer[] = "Hello World!";
+  benchSink = benchWisol.toHex(buffer, 12).length();
+}
+
+static void benchHexDigitToDecimal() {
+  static const char digits[] = "0123456789abcdefABCDEF";
+  unsigned long sum = 0;
+  for (uint8_t i = 0; i < sizeof(digits) - 1; i++) sum += benchWisol.hexDigitToDecimal(digits[i]);
+  benchSink = sum;
+}
+
+static void benchGPSEncode() {
+  //  All the sentences above, one character at a time.
+  for (const char *p = benchNMEA; pgm_read_byte(p); p++) benchGPS.encode(pgm_read_byte(p));
+  benchSink = benchGPS.passedChecksum();
+}
+
+static void benchDistanceBetween() {
+  //  Singapore to Tokyo.
+  benchSink = (unsigned long) TinyGPSPlus::distanceBetween(1.3521, 103.8198, 35.6762, 139.6503);
+}
+
+static void benchCalculateLux() {
+  //  Both packages, all integration times, with and without gain, on the channels
+  //  from the last getLux().
+  unsigned long sum = 0;
+  for (unsigned int tInt = 0; tInt < 3; tInt++)
+    for (int iType = 0; iType < 2; iType++)
+      sum += TSL2561.calculateLux(0, tInt, iType) + TSL2561.calculateLux(1, tInt, iType);
+  benchSink = sum;
+}
+
+struct BenchKernel {
+  char name[32];
+  void (*run)();
+};
+
+static const BenchKernel benchKernels[] PROGMEM = {
+  { "Message::addField x3", benchAddField },
+  { "Message::decodeMessage", benchDecodeMessage },
+  { "toHex(int)", benchToHexInt },
+  { "toHex(unsigned int)", benchToHexUnsignedInt },
+  { "toHex(long)", benchToHexLong },
+  { "toHex(unsigned long)", benchToHexUnsignedLong },
+  { "toHex(float)", benchToHexFloat },
+  { "toHex(double)", benchToHexDouble },
+  { "toHex(char)", benchToHexChar },
+  { "toHex(char *, 12)", benchToHexBuffer },
+  { "hexDigitToDecimal x22", benchHexDigitToDecimal },
+  { "TinyGPSPlus::encode 5 sentences", benchGPSEncode },
+  { "TinyGPSPlus::distanceBetween", benchDistanceBetween },
+  { "calculateLux x12", benchCalculateLux },
+};
+static const uint8_t benchKernelCount = sizeof(benchKernels) / sizeof(benchKernels[0]);
+
+#endif // UNABIZ_ARDUINO_BENCH_KERNELS_H
@@ -0,0 +1,356 @@
+//  Simulates a fleet of nodes on a shared virtual clock.  Each node runs a simplified model
+//  of the grove-light loop, written out in Node::step(), not the sketch itself: sample a
+//  light level, queue a message through Trigger and UplinkQueue, and send it with the real
+//  Wisol and Message code to its own simulated module.  Unlike grove-light it doesn't use
+//  the Scheduler, the background TSL2561 tasks or PayloadEncoder, so sketch changes aren't
+//  reflected here.  Reports duty cycle compliance, message counts, queue depths and the
+//  rate of uplinks arriving at the backend.
+//
+//  The library and the host core keep state in globals, so nodes can't run in threads.
+//  Instead the fleet is split across worker processes, one per core by default.  Within a
+//  worker, nodes take turns in order of their next wake up time: the clock is set to that
+//  time and the node runs until it sleeps again.  Nodes don't share a radio channel, so
+//  this gives the same result as running them side by side.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run with options as name=value, e.g. a week of 10000 nodes:
+//    ./fleet_model nodes=10000 days=7
+//  Options: nodes, days, workers, sample (ms between sensor readings), threshold,
+//  hysteresis, noise (lux), mininterval (ms between triggers), noresponse, loss (percent),
+//  hourly (uplinks per hour allowed by the module), seed.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "SIGFOX.h"
+#include "HostHeap.h"
+#include "WisolSim.h"
+
+static const unsigned long MINUTE = 60UL * 1000;
+static const unsigned long HOUR = 60 * MINUTE;
+static const unsigned long DAY = 24 * HOUR;
+static const unsigned int MAX_DAILY_UPLINKS = 140;  //  Most uplinks per day in a Sigfox subscription.
+static const unsigned int MAX_HOURLY_UPLINKS = 6;  //  1% duty cycle with 6-second uplinks.
+static const uint8_t CH_LIGHT = 0;
+
+struct Options {
+  unsigned long nodes = 1000;
+  unsigned long days = 7;
+  long workers = 0;  //  0 for one per core.
+  unsigned long sampleInterval = MINUTE;
+  float threshold = 40;  //  As in grove-light.
+  float hysteresis = 10;
+  float noise = 20;
+  unsigned long minInterval = 2000;
+  unsigned long seed = 1;
+  WisolSimConfig sim = DEFAULT_WISOL_SIM;
+};
+
+//  Totals for the nodes of one worker, added up by the parent.
+struct Summary {
+  unsigned long nodes, begun, samples, triggers, dropped, failed;
+  unsigned long queued;  //  Messages still queued at the end.
+  unsigned long commands, uplinks, refused, airTime;
+  unsigned long nodesRefused;  //  Nodes that the module stopped for the duty cycle.
+  unsigned long nodesOverHourly;  //  Nodes that sent more than MAX_HOURLY_UPLINKS in a clock hour.
+  unsigned long nodesOverDaily;  //  Nodes that sent more than MAX_DAILY_UPLINKS in a day.
+  unsigned long minUplinks, maxUplinks;  //  Uplinks of the quietest and busiest node.
+  unsigned long maxDepth[UPLINK_QUEUE_SIZE + 1];  //  Nodes by the deepest their queue got.
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const String name = String(arg).substring(0, equals - arg);
+  const char *text = equals + 1;
+  const unsigned long value = strtoul(text, 0, 10);
+  if (name == "nodes") options.nodes = value;
+  else if (name == "days") options.days = value;
+  else if (name == "workers") options.workers = value;
+  else if (name == "sample") options.sampleInterval = value;
+  else if (name == "threshold") options.threshold = atof(text);
+  else if (name == "hysteresis") options.hysteresis = atof(text);
+  else if (name == "noise") options.noise = atof(text);
+  else if (name == "mininterval") options.minInterval = value;
+  else if (name == "noresponse") options.sim.noResponsePercent = value;
+  else if (name == "loss") options.sim.downlinkLossPercent = value;
+  else if (name == "hourly") options.sim.maxUplinksPerHour = value;
+  else if (name == "seed") options.seed = value;
+  else return false;
+  return true;
+}
+
+class Node {
+public:
+  Node(const Options &options, unsigned long index):
+      module(simConfig(options, index), WISOL_TX),
+      transceiver(COUNTRY_FR, false, "NOTUSED", false),
+      uplinks(transceiver) {
+    this->options = &options;
+    randomState = options.seed * 7919 + index + 1;
+    phase = nextRandom() / 32768.0;
+    begun = false;
+    nextSample = 0;
+    samples = triggers = 0;
+    maxDepth = 0;
+    hour = day = 0;
+    hourCount = dayCount = 0;
+    maxHour = maxDay = 0;
+    trigger.addCrossing(CH_LIGHT, options.threshold, options.hysteresis, 0, options.minInterval);
+  }
+
+  //  Run the node until it sleeps.  Returns the millis() to wake up, or 0 to stop.
+  unsigned long step(unsigned long *ingest) {
+    SoftwareSerial::setModule(&module);
+    if (!begun) {
+      //  setup()
+      if (!transceiver.begin()) return 0;
+      transceiver.clearStats();
+      begun = true;
+      nextSample = millis();
+    }
+    //  loop(): sample the sensor when due, then send the oldest queued message.
+    if ((long) (millis() - nextSample) >= 0) {
+      samples++;
+      const int lux = readLux(millis());
+      if (trigger.sample(CH_LIGHT, lux)) {
+        triggers++;
+        Message msg(transceiver);
+        msg.addField("lux", lux);
+        msg.addField("brt", trigger.isAbove(CH_LIGHT) ? 1 : 0);
+        uplinks.push(msg.getEncodedMessage());
+      }
+      nextSample += options->sampleInterval;
+    }
+    if (uplinks.count() > maxDepth) maxDepth = uplinks.count();
+    if (uplinks.isDue()) {
+      WisolSimStats before, after;
+      module.getStats(before);
+      uplinks.sendNext();
+      module.getStats(after);
+      if (after.uplinks > before.uplinks) delivered(millis(), ingest);
+    }
+    unsigned long wake = nextSample;
+    if (!uplinks.isEmpty() && (long) (uplinks.nextAttemptTime() - wake) < 0) wake = uplinks.nextAttemptTime();
+    if ((long) (wake - millis()) < 0) wake = millis();
+    return wake;
+  }
+
+  void summarise(Summary &summary) {
+    WisolSimStats sim;
+    module.getStats(sim);
+    summary.nodes++;
+    if (begun) summary.begun++;
+    summary.samples += samples;
+    summary.triggers += triggers;
+    summary.dropped += uplinks.dropped();
+    summary.failed += uplinks.failed();
+    summary.queued += uplinks.count();
+    summary.commands += sim.commands;
+    summary.uplinks += sim.uplinks;
+    summary.refused += sim.refused;
+    summary.airTime += sim.airTime;
+    if (sim.refused > 0) summary.nodesRefused++;
+    if (maxHour > MAX_HOURLY_UPLINKS) summary.nodesOverHourly++;
+    if (maxDay > MAX_DAILY_UPLINKS) summary.nodesOverDaily++;
+    if (summary.nodes == 1 || sim.uplinks < summary.minUplinks) summary.minUplinks = sim.uplinks;
+    if (sim.uplinks > summary.maxUplinks) summary.maxUplinks = sim.uplinks;
+    summary.maxDepth[maxDepth]++;
+  }
+
+private:
+  static WisolSimConfig simConfig(const Options &options, unsigned long index) {
+    WisolSimConfig config = options.sim;
+    config.seed = options.seed * 104729 + index + 1;
+    return config;
+  }
+
+  int readLux(unsigned long now) {
+    //  Daylight follows the sun from a random time zone, plus sensor noise.
+    const double daylight = sin(2 * PI * ((double) now / DAY + phase));
+    const double noise = options->noise * (nextRandom() / 16384.0 - 1);
+    const double lux = (daylight > 0 ? 1000 * daylight : 0) + noise;
+    return lux > 0 ? (int) lux : 0;
+  }
+
+  void delivered(unsigned long now, unsigned long *ingest) {
+    ingest[now / MINUTE]++;
+    if (now / HOUR != hour) { hour = now / HOUR; hourCount = 0; }
+    if (now / DAY != day) { day = now / DAY; dayCount = 0; }
+    if (++hourCount > maxHour) maxHour = hourCount;
+    if (++dayCount > maxDay) maxDay = dayCount;
+  }
+
+  unsigned long nextRandom() {
+    randomState = randomState * 1103515245 + 12345;
+    return (randomState >> 16) & 0x7fff;
+  }
+
+  const Options *options;
+  WisolSim module;
+  Wisol transceiver;
+  UplinkQueue uplinks;
+  Trigger trigger;
+  unsigned long randomState;
+  double phase;  //  Time of day offset, as a fraction of a day.
+  bool begun;
+  unsigned long nextSample;
+  unsigned long samples, triggers;
+  uint8_t maxDepth;
+  unsigned long hour, day;  //  Current clock hour and day, for counting uplinks.
+  unsigned int hourCount, dayCount, maxHour, maxDay;
+};
+
+static void runWorker(const Options &options, unsigned long first, unsigned long last,
+                      Summary &summary, unsigned long *ingest) {
+  //  Run nodes first..last-1 until the end of the simulation, earliest wake up first.
+  hostHeapSetUnlimited();
+  const unsigned long end = options.days * DAY;
+  std::vector<Node *> nodes;
+  typedef std::pair<unsigned long, unsigned long> Wake;  //  millis() and node.
+  std::priority_queue<Wake, std::vector<Wake>, std::greater<Wake> > wakes;
+  for (unsigned long i = first; i < last; i++) {
+    nodes.push_back(new Node(options, i));
+    //  Power up over the first minute.
+    wakes.push(Wake((i * 7919) % MINUTE, i - first));
+  }
+  while (!wakes.empty()) {
+    const Wake wake = wakes.top();
+    wakes.pop();
+    hostSetTime(wake.first);
+    const unsigned long next = nodes[wake.second]->step(ingest);
+    if (next != 0 && next < end) wakes.push(Wake(next, wake.second));
+  }
+  memset(&summary, 0, sizeof(summary));
+  for (size_t i = 0; i < nodes.size(); i++) {
+    nodes[i]->summarise(summary);
+    delete nodes[i];
+  }
+}
+
+static bool readAll(int fd, void *buffer, size_t size) {
+  uint8_t *p = (uint8_t *) buffer;
+  while (size > 0) {
+    const ssize_t n = read(fd, p, size);
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static void writeAll(int fd, const void *buffer, size_t size) {
+  const uint8_t *p = (const uint8_t *) buffer;
+  while (size > 0) {
+    const ssize_t n = write(fd, p, size);
+    if (n <= 0) _exit(1);
+    p += n;
+    size -= n;
+  }
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  //  millis() wraps after 49 days.
+  if (options.days < 1 || options.days > 49) { fprintf(stderr, "days must be 1 to 49\n"); return 2; }
+  if (options.workers <= 0) options.workers = sysconf(_SC_NPROCESSORS_ONLN);
+  if (options.workers < 1) options.workers = 1;
+  if ((unsigned long) options.workers > options.nodes) options.workers = options.nodes;
+  const size_t minutes = options.days * 24 * 60 + 1;
+
+  //  Fork the workers, each sending back its summary and uplinks per minute.
+  const std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+  std::vector<int> pipes;
+  for (long w = 0; w < options.workers; w++) {
+    int fds[2];
+    if (pipe(fds) != 0) { perror("pipe"); return 1; }
+    const pid_t pid = fork();
+    if (pid < 0) { perror("fork"); return 1; }
+    if (pid == 0) {
+      close(fds[0]);
+      Summary summary;
+      std::vector<unsigned long> ingest(minutes, 0);
+      runWorker(options, options.nodes * w / options.workers, options.nodes * (w + 1) / options.workers,
+                summary, &ingest[0]);
+      writeAll(fds[1], &summary, sizeof(summary));
+      writeAll(fds[1], &ingest[0], minutes * sizeof(unsigned long));
+      _exit(0);
+    }
+    close(fds[1]);
+    pipes.push_back(fds[0]);
+  }
+
+  Summary total;
+  memset(&total, 0, sizeof(total));
+  std::vector<unsigned long> ingest(minutes, 0), part(minutes);
+  for (size_t w = 0; w < pipes.size(); w++) {
+    Summary summary;
+    if (!readAll(pipes[w], &summary, sizeof(summary)) ||
+        !readAll(pipes[w], &part[0], minutes * sizeof(unsigned long))) {
+      fprintf(stderr, "Worker %u failed\n", (unsigned) w);
+      return 1;
+    }
+    close(pipes[w]);
+    const bool first = total.nodes == 0;
+    total.nodes += summary.nodes;
+    total.begun += summary.begun;
+    total.samples += summary.samples;
+    total.triggers += summary.triggers;
+    total.dropped += summary.dropped;
+    total.failed += summary.failed;
+    total.queued += summary.queued;
+    total.commands += summary.commands;
+    total.uplinks += summary.uplinks;
+    total.refused += summary.refused;
+    total.airTime += summary.airTime;
+    total.nodesRefused += summary.nodesRefused;
+    total.nodesOverHourly += summary.nodesOverHourly;
+    total.nodesOverDaily += summary.nodesOverDaily;
+    if (first || summary.minUplinks < total.minUplinks) total.minUplinks = summary.minUplinks;
+    if (summary.maxUplinks > total.maxUplinks) total.maxUplinks = summary.maxUplinks;
+    for (uint8_t d = 0; d <= UPLINK_QUEUE_SIZE; d++) total.maxDepth[d] += summary.maxDepth[d];
+    for (size_t m = 0; m < minutes; m++) ingest[m] += part[m];
+  }
+  while (wait(0) > 0) {}
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  printf("Simulated %lu nodes for %lu days in %.1f s with %ld workers\n",
+         total.nodes, options.days, wall, options.workers);
+  printf("Nodes started %lu, samples %lu, triggers %lu\n", total.begun, total.samples, total.triggers);
+  printf("Uplinks %lu, per node min %lu, avg %.1f, max %lu\n", total.uplinks, total.minUplinks,
+         total.nodes ? (double) total.uplinks / total.nodes : 0, total.maxUplinks);
+  printf("Messages dropped from full queues %lu, failed after retries %lu, still queued %lu\n",
+         total.dropped, total.failed, total.queued);
+  //  Sent as far as the driver could tell, but not on air, e.g. refused by the module.
+  const unsigned long accounted = total.uplinks + total.dropped + total.failed + total.queued;
+  printf("Messages lost without an error %lu\n", total.triggers > accounted ? total.triggers - accounted : 0);
+  printf("Deepest queue, nodes:");
+  for (uint8_t d = 0; d <= UPLINK_QUEUE_SIZE; d++) printf(" %u=%lu", d, total.maxDepth[d]);
+  printf("\n");
+  printf("Duty cycle: nodes over %u uplinks per hour %lu, over %u per day %lu, "
+         "refused by the module %lu (%lu uplinks)\n",
+         MAX_HOURLY_UPLINKS, total.nodesOverHourly, MAX_DAILY_UPLINKS, total.nodesOverDaily,
+         total.nodesRefused, total.refused);
+  printf("Air time %.3f%% of the time per node\n",
+         total.nodes ? 100.0 * total.airTime / total.nodes / (options.days * DAY) : 0);
+  unsigned long peak = 0, peakMinute = 0;
+  for (size_t m = 0; m < minutes; m++) {
+    if (ingest[m] > peak) { peak = ingest[m]; peakMinute = m; }
+  }
+  printf("Backend ingest: avg %.2f uplinks per second, peak %lu in minute %lu (day %lu %02lu:%02lu)\n",
+         (double) total.uplinks / (options.days * DAY / 1000), peak, peakMinute,
+         peakMinute / (24 * 60), peakMinute / 60 % 24, peakMinute % 60);
+  return 0;
+}
@@ -0,0 +1,23 @@
+//  Fuzz target for Message::decodeMessage(), which decodes payloads that arrive from the
+//  network.  The input is taken as the hex digits of the payload.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "HostHeap.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  //  Use the host's malloc() so that the sanitizers see every String.
+  static bool started = false;
+  if (!started) { hostHeapSetUnlimited(); started = true; }
+  //  Longer than a payload can be, to check the loop.
+  char msg[64];
+  if (size >= sizeof(msg)) size = sizeof(msg) - 1;
+  if (size > 0) memcpy(msg, data, size);
+  msg[size] = 0;
+  const String result = Message::decodeMessage(msg);
+  //  Always a JSON object, with one field per 8 digits.
+  if (result.charAt(0) != '{' || result.charAt(result.length() - 1) != '}') __builtin_trap();
+  return 0;
+}
@@ -0,0 +1,28 @@
+//  Fuzz target for TinyGPSPlus::encode(), which parses the NMEA sentences from the GPS
+//  in the grove-gps example, and for the values it returns.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "TinyGPS++.h"
+#include "HostHeap.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static bool started = false;
+  if (!started) { hostHeapSetUnlimited(); started = true; }
+  TinyGPSPlus gps;
+  //  Custom fields are kept in a list sorted by sentence and term.
+  TinyGPSCustom fixQuality(gps, "GPGGA", 6);
+  TinyGPSCustom magneticVariation(gps, "GPRMC", 10);
+  for (size_t i = 0; i < size; i++) gps.encode((char) data[i]);
+  //  Read everything the sketch could, as garbage values must not crash.
+  volatile double sink = gps.location.lat() + gps.location.lng() + gps.altitude.meters() +
+    gps.speed.kmph() + gps.hdop.value() + gps.satellites.value() + gps.date.year() +
+    gps.date.month() + gps.date.day() + gps.time.hour() + gps.time.minute() +
+    gps.time.second() + gps.time.centisecond();
+  volatile const char *text = TinyGPSPlus::cardinal(gps.course.deg());
+  text = fixQuality.value();
+  text = magneticVariation.value();
+  (void) sink;
+  (void) text;
+  return 0;
+}
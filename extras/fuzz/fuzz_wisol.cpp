@@ -0,0 +1,43 @@
+//  Fuzz target for the Wisol driver's handling of responses from the module: the markers
+//  in sendBuffer(), the X,Y of AT$GI? in setOutputPower() and the downlink returned by
+//  sendMessageAndGetResponse().  The input is the module's answer to each command in turn,
+//  separated by 0 bytes.  Commands after the input runs out get no answer and time out.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "SIGFOX.h"
+#include "HostHeap.h"
+
+class FuzzModule: public HostModule {
+public:
+  const uint8_t *data;
+  size_t size;
+
+  void receive(uint8_t c) {
+    if (c != '\r') return;
+    wait(1);
+    while (size > 0) {
+      const uint8_t b = *data++;
+      size--;
+      if (b == 0) break;
+      respond(b);
+    }
+  }
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static bool started = false;
+  if (!started) { hostHeapSetUnlimited(); started = true; }
+  static FuzzModule module;
+  module.data = data;
+  module.size = size;
+  SoftwareSerial::setModule(&module);
+  //  Zone 4 until begin(), so setOutputPower() sends AT$GI? and maybe AT$RC.
+  static Wisol transceiver(COUNTRY_SG, false, "NOTUSED", false);
+  hostAdvanceTo(hostClock() + (unsigned long long) SEND_DELAY * 1000);
+  String response;
+  transceiver.sendMessageAndGetResponse("0102030405060708090a0b0c", response);
+  //  The downlink is 8 bytes or nothing.
+  if (response.length() != 0 && response.length() != 2 * BYTES_PER_DOWNLINK) __builtin_trap();
+  return 0;
+}
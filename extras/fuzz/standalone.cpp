@@ -0,0 +1,47 @@
+//  Runs a fuzz target once on each file given, or on each file in each directory given,
+//  for compilers without libFuzzer.  Checks that the corpus still passes, and reproduces
+//  a crash found elsewhere.
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static bool runFile(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) { perror(path.c_str()); return false; }
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + length);
+  fclose(file);
+  LLVMFuzzerTestOneInput(data.empty() ? 0 : &data[0], data.size());
+  return true;
+}
+
+int main(int argc, char **argv) {
+  unsigned long runs = 0;
+  for (int i = 1; i < argc; i++) {
+    struct stat info;
+    if (stat(argv[i], &info) != 0) { perror(argv[i]); return 1; }
+    if (!S_ISDIR(info.st_mode)) {
+      if (!runFile(argv[i])) return 1;
+      runs++;
+      continue;
+    }
+    DIR *dir = opendir(argv[i]);
+    if (!dir) { perror(argv[i]); return 1; }
+    for (struct dirent *entry; (entry = readdir(dir)) != 0; ) {
+      if (entry->d_name[0] == '.') continue;
+      if (!runFile(std::string(argv[i]) + "/" + entry->d_name)) return 1;
+      runs++;
+    }
+    closedir(dir);
+  }
+  printf("%lu inputs passed\n", runs);
+  return 0;
+}
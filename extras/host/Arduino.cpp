@@ -0,0 +1,326 @@
+//  Minimal Arduino core for building the library on the host.  String is a port of the
+//  Arduino WString, allocating on the emulated AVR heap.
+
+#include "Arduino.h"
+#include "HostHeap.h"
+
+HardwareSerial Serial;
+
+static unsigned long long hostTime = 0;  //  Virtual clock in microseconds.  millis() and micros() wrap like on the Arduino.
+
+unsigned long millis() { return (uint32_t) (hostTime / 1000); }
+unsigned long micros() { return (uint32_t) hostTime; }
+void delay(unsigned long ms) { hostTime += (unsigned long long) ms * 1000; }
+void delayMicroseconds(unsigned int us) { hostTime += us; }
+void hostAdvance(unsigned long ms) { delay(ms); }
+void hostSetTime(unsigned long ms) { hostTime = (unsigned long long) ms * 1000; }
+unsigned long long hostClock() { return hostTime; }
+void hostAdvanceTo(unsigned long long us) { if (us > hostTime) hostTime = us; }
+
+static uint8_t pins[32];
+void pinMode(uint8_t pin, uint8_t mode) {}
+void (*hostPinHook)(uint8_t pin, uint8_t value) = 0;
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < sizeof(pins)) pins[pin] = value;
+  if (hostPinHook) hostPinHook(pin, value);
+}
+int digitalRead(uint8_t pin) { return pin < sizeof(pins) ? pins[pin] : LOW; }
+
+static unsigned long seed = 1;
+void randomSeed(unsigned long s) { if (s) seed = s; }
+long random(long max) {
+  //  Same generator on every host, so runs are repeatable.
+  if (max <= 0) return 0;
+  seed = seed * 1103515245 + 12345;
+  return (long) ((seed >> 16) % (unsigned long) max);
+}
+long random(long min, long max) { return min >= max ? min : min + random(max - min); }
+
+//  String, following WString.cpp from the Arduino AVR core.
+
+String::String(const char *cstr) { init(); if (cstr) copy(cstr, strlen(cstr)); }
+String::String(const String &value) { init(); *this = value; }
+String::String(const __FlashStringHelper *pstr) { init(); *this = pstr; }
+String::String(String &&rval) { init(); move(rval); }
+String::String(char c) { init(); char buf[2] = { c, 0 }; *this = buf; }
+
+static void toBase(unsigned long value, unsigned char base, char *buf) {
+  char tmp[33]; int i = 0;
+  if (base < 2) base = 10;
+  do { tmp[i++] = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base]; value /= base; } while (value);
+  while (i) *buf++ = tmp[--i];
+  *buf = 0;
+}
+
+static void signedToBase(long value, unsigned char base, char *buf) {
+  //  Like ltoa(): only base 10 gets a minus sign.
+  if (value < 0 && base == 10) { *buf++ = '-'; toBase(-(unsigned long) value, base, buf); }
+  else toBase((unsigned long) value, base, buf);
+}
+
+String::String(unsigned char value, unsigned char base) { init(); char buf[9]; toBase(value, base, buf); *this = buf; }
+String::String(int value, unsigned char base) {
+  //  itoa() works on 16-bit int on AVR.
+  init(); char buf[18];
+  if (base == 10) signedToBase((int16_t) value, base, buf); else toBase((uint16_t) value, base, buf);
+  *this = buf;
+}
+String::String(unsigned int value, unsigned char base) { init(); char buf[17]; toBase((uint16_t) value, base, buf); *this = buf; }
+String::String(long value, unsigned char base) {
+  init(); char buf[34];
+  if (base == 10) signedToBase((int32_t) value, base, buf); else toBase((uint32_t) value, base, buf);
+  *this = buf;
+}
+String::String(unsigned long value, unsigned char base) { init(); char buf[33]; toBase((uint32_t) value, base, buf); *this = buf; }
+String::String(float value, unsigned char decimalPlaces) { init(); char buf[33]; snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value); *this = buf; }
+String::String(double value, unsigned char decimalPlaces) { init(); char buf[33]; snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value); *this = buf; }
+String::~String() { hostFree(buffer); }
+
+void String::init() { buffer = 0; capacity = 0; len = 0; }
+
+void String::invalidate() {
+  if (buffer) hostFree(buffer);
+  buffer = 0;
+  capacity = len = 0;
+}
+
+unsigned char String::reserve(unsigned int size) {
+  if (buffer && capacity >= size) return 1;
+  if (changeBuffer(size)) {
+    if (len == 0) buffer[0] = 0;
+    return 1;
+  }
+  return 0;
+}
+
+unsigned char String::changeBuffer(unsigned int maxStrLen) {
+  //  Exact size, no spare capacity: this is what fragments the AVR heap.
+  char *newbuffer = (char *) hostRealloc(buffer, maxStrLen + 1);
+  if (!newbuffer) return 0;
+  buffer = newbuffer;
+  capacity = maxStrLen;
+  return 1;
+}
+
+String &String::copy(const char *cstr, unsigned int length) {
+  if (!reserve(length)) { invalidate(); return *this; }
+  len = length;
+  memmove(buffer, cstr, length);
+  buffer[length] = 0;
+  return *this;
+}
+
+void String::move(String &rhs) {
+  if (buffer) {
+    if (rhs.buffer && capacity >= rhs.len) {
+      strcpy(buffer, rhs.buffer);
+      len = rhs.len;
+      rhs.len = 0;
+      return;
+    }
+    hostFree(buffer);
+  }
+  buffer = rhs.buffer;
+  capacity = rhs.capacity;
+  len = rhs.len;
+  rhs.buffer = 0;
+  rhs.capacity = 0;
+  rhs.len = 0;
+}
+
+String &String::operator=(const String &rhs) {
+  if (this == &rhs) return *this;
+  if (rhs.buffer) copy(rhs.buffer, rhs.len);
+  else invalidate();
+  return *this;
+}
+
+String &String::operator=(String &&rval) { if (this != &rval) move(rval); return *this; }
+String &String::operator=(const char *cstr) { if (cstr) copy(cstr, strlen(cstr)); else invalidate(); return *this; }
+String &String::operator=(const __FlashStringHelper *pstr) { return *this = (const char *) pstr; }
+
+unsigned char String::concat(const String &s) { return concat(s.buffer ? s.buffer : "", s.len); }
+
+unsigned char String::concat(const char *cstr, unsigned int length) {
+  const unsigned int newlen = len + length;
+  if (!cstr) return 0;
+  if (length == 0) return 1;
+  if (!reserve(newlen)) return 0;
+  memmove(buffer + len, cstr, length);
+  len = newlen;
+  buffer[len] = 0;
+  return 1;
+}
+
+unsigned char String::concat(const char *cstr) { return cstr ? concat(cstr, strlen(cstr)) : 0; }
+unsigned char String::concat(const __FlashStringHelper *str) { return concat((const char *) str); }
+unsigned char String::concat(char c) { char buf[2] = { c, 0 }; return concat(buf, 1); }
+unsigned char String::concat(unsigned char num) { return concat(String(num)); }
+unsigned char String::concat(int num) { return concat(String(num)); }
+unsigned char String::concat(unsigned int num) { return concat(String(num)); }
+unsigned char String::concat(long num) { return concat(String(num)); }
+unsigned char String::concat(unsigned long num) { return concat(String(num)); }
+unsigned char String::concat(float num) { return concat(String(num)); }
+unsigned char String::concat(double num) { return concat(String(num)); }
+
+String operator+(const String &lhs, const String &rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String &lhs, const char *cstr) { String s(lhs); s.concat(cstr); return s; }
+String operator+(const String &lhs, const __FlashStringHelper *rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String &lhs, char c) { String s(lhs); s.concat(c); return s; }
+String operator+(const String &lhs, unsigned char num) { String s(lhs); s.concat(num); return s; }
+String operator+(const String &lhs, int num) { String s(lhs); s.concat(num); return s; }
+String operator+(const String &lhs, unsigned int num) { String s(lhs); s.concat(num); return s; }
+String operator+(const String &lhs, long num) { String s(lhs); s.concat(num); return s; }
+String operator+(const String &lhs, unsigned long num) { String s(lhs); s.concat(num); return s; }
+String operator+(const String &lhs, float num) { String s(lhs); s.concat(num); return s; }
+String operator+(const String &lhs, double num) { String s(lhs); s.concat(num); return s; }
+String operator+(const char *lhs, const String &rhs) { String s(lhs); s.concat(rhs); return s; }
+
+int String::compareTo(const String &s) const { return strcmp(c_str(), s.c_str()); }
+unsigned char String::equals(const String &s) const { return len == s.len && compareTo(s) == 0; }
+unsigned char String::equals(const char *cstr) const { return strcmp(c_str(), cstr ? cstr : "") == 0; }
+unsigned char String::startsWith(const String &s) const { return len >= s.len && strncmp(c_str(), s.c_str(), s.len) == 0; }
+unsigned char String::endsWith(const String &s) const { return len >= s.len && strcmp(c_str() + len - s.len, s.c_str()) == 0; }
+
+char String::charAt(unsigned int index) const { return index < len ? buffer[index] : 0; }
+void String::setCharAt(unsigned int index, char c) { if (index < len) buffer[index] = c; }
+
+void String::toCharArray(char *buf, unsigned int bufsize, unsigned int index) const {
+  if (!bufsize || !buf) return;
+  if (index >= len) { buf[0] = 0; return; }
+  unsigned int n = bufsize - 1;
+  if (n > len - index) n = len - index;
+  strncpy(buf, buffer + index, n);
+  buf[n] = 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  if (fromIndex >= len) return -1;
+  const char *temp = strchr(buffer + fromIndex, ch);
+  return temp ? temp - buffer : -1;
+}
+
+int String::indexOf(const String &s, unsigned int fromIndex) const {
+  if (fromIndex >= len) return -1;
+  const char *found = strstr(buffer + fromIndex, s.c_str());
+  return found ? found - buffer : -1;
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+  if (left > right) { const unsigned int temp = right; right = left; left = temp; }
+  String out;
+  if (left >= len) return out;
+  if (right > len) right = len;
+  out.copy(buffer + left, right - left);
+  return out;
+}
+
+void String::replace(char find, char replace) {
+  for (unsigned int i = 0; i < len; i++) if (buffer[i] == find) buffer[i] = replace;
+}
+
+void String::replace(const String &find, const String &replace) {
+  //  Same strategy as WString: in place if not growing, else reserve the final size once.
+  if (len == 0 || find.len == 0) return;
+  const int diff = replace.len - find.len;
+  char *readFrom = buffer, *foundAt;
+  if (diff == 0) {
+    while ((foundAt = strstr(readFrom, find.buffer)) != 0) {
+      memmove(foundAt, replace.buffer, replace.len);
+      readFrom = foundAt + replace.len;
+    }
+  } else if (diff < 0) {
+    char *writeTo = buffer;
+    while ((foundAt = strstr(readFrom, find.buffer)) != 0) {
+      const unsigned int n = foundAt - readFrom;
+      memmove(writeTo, readFrom, n);
+      writeTo += n;
+      memmove(writeTo, replace.c_str(), replace.len);
+      writeTo += replace.len;
+      readFrom = foundAt + find.len;
+      len += diff;
+    }
+    memmove(writeTo, readFrom, strlen(readFrom) + 1);
+  } else {
+    unsigned int size = len;
+    while ((foundAt = strstr(readFrom, find.buffer)) != 0) {
+      readFrom = foundAt + find.len;
+      size += diff;
+    }
+    if (size == len) return;
+    if (size > capacity && !changeBuffer(size)) return;
+    int index = len - 1;
+    while (index >= 0 && (index = lastIndexOf(find, index)) >= 0) {
+      readFrom = buffer + index + find.len;
+      memmove(readFrom + diff, readFrom, len - (readFrom - buffer));
+      len += diff;
+      buffer[len] = 0;
+      memmove(buffer + index, replace.buffer, replace.len);
+      index--;
+    }
+  }
+}
+
+int String::lastIndexOf(const String &s, unsigned int fromIndex) const {
+  if (s.len == 0 || len == 0 || s.len > len) return -1;
+  if (fromIndex >= len) fromIndex = len - 1;
+  int found = -1;
+  for (char *p = buffer; p <= buffer + fromIndex; p++) {
+    p = strstr(p, s.buffer);
+    if (!p) break;
+    if ((unsigned int) (p - buffer) <= fromIndex) found = p - buffer;
+  }
+  return found;
+}
+
+void String::remove(unsigned int index) { remove(index, (unsigned int) -1); }
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= len || count == 0) return;
+  if (count > len - index) count = len - index;
+  memmove(buffer + index, buffer + index + count, len - index - count + 1);
+  len -= count;
+}
+
+void String::toLowerCase() { for (unsigned int i = 0; i < len; i++) buffer[i] = tolower(buffer[i]); }
+void String::toUpperCase() { for (unsigned int i = 0; i < len; i++) buffer[i] = toupper(buffer[i]); }
+
+void String::trim() {
+  if (!buffer || len == 0) return;
+  char *begin = buffer;
+  while (isspace(*begin)) begin++;
+  char *end = buffer + len - 1;
+  while (isspace(*end) && end >= begin) end--;
+  len = end + 1 - begin;
+  if (begin > buffer) memmove(buffer, begin, len);
+  buffer[len] = 0;
+}
+
+long String::toInt() const { return buffer ? (int32_t) atol(buffer) : 0; }
+float String::toFloat() const { return buffer ? (float) atof(buffer) : 0; }
+
+//  Print
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) { if (!write(*buffer++)) break; n++; }
+  return n;
+}
+
+size_t Print::print(long num, int base) {
+  char buf[34];
+  signedToBase((int32_t) num, base, buf);
+  return write(buf);
+}
+
+size_t Print::print(unsigned long num, int base) {
+  char buf[33];
+  toBase((uint32_t) num, base, buf);
+  return write(buf);
+}
+
+size_t Print::print(double num, int digits) {
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", digits, num);
+  return write(buf);
+}
@@ -0,0 +1,218 @@
+//  Minimal Arduino core for building the library on the host, e.g. for stress tests.
+//  String follows the Arduino WString allocation pattern on the emulated AVR heap in
+//  HostHeap.h, and time only advances through delay(), hostAdvance() and waiting for
+//  SoftwareSerial, so delays and timeouts take no real time.
+#ifndef UNABIZ_ARDUINO_HOST_ARDUINO_H
+#define UNABIZ_ARDUINO_HOST_ARDUINO_H
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARDUINO
+#define ARDUINO 10805
+#endif  //  ARDUINO
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define DEC 10
+#define HEX 16
+
+#define PI 3.1415926535897932384626433832795
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+
+//  Flash strings are ordinary strings on the host.
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *) (p))
+#define pgm_read_word(p) (*(const uint16_t *) (p))
+#define pgm_read_dword(p) (*(const uint32_t *) (p))
+#define pgm_read_ptr(p) (*(void * const *) (p))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+//  Virtual clock.
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void hostAdvance(unsigned long ms);  //  Advance the clock without calling delay().
+void hostSetTime(unsigned long ms);  //  Set the clock, e.g. to test millis() wraparound.
+unsigned long long hostClock();  //  Virtual time in microseconds, without wrapping.
+void hostAdvanceTo(unsigned long long us);  //  Move the clock forward to hostClock() == us.
+
+//  Called by digitalWrite(), so a simulated module can see the UART break that wakes it.
+extern void (*hostPinHook)(uint8_t pin, uint8_t value);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+class String {
+public:
+  String(const char *cstr = "");
+  String(const String &str);
+  String(const __FlashStringHelper *str);
+  String(String &&rval);
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned char decimalPlaces = 2);
+  explicit String(double value, unsigned char decimalPlaces = 2);
+  ~String();
+
+  unsigned char reserve(unsigned int size);
+  unsigned int length() const { return len; }
+
+  String &operator=(const String &rhs);
+  String &operator=(const char *cstr);
+  String &operator=(const __FlashStringHelper *str);
+  String &operator=(String &&rval);
+
+  unsigned char concat(const String &str);
+  unsigned char concat(const char *cstr);
+  unsigned char concat(const char *cstr, unsigned int length);
+  unsigned char concat(const __FlashStringHelper *str);
+  unsigned char concat(char c);
+  unsigned char concat(unsigned char num);
+  unsigned char concat(int num);
+  unsigned char concat(unsigned int num);
+  unsigned char concat(long num);
+  unsigned char concat(unsigned long num);
+  unsigned char concat(float num);
+  unsigned char concat(double num);
+  template<class T> String &operator+=(const T &rhs) { concat(rhs); return *this; }
+
+  int compareTo(const String &s) const;
+  unsigned char equals(const String &s) const;
+  unsigned char equals(const char *cstr) const;
+  unsigned char operator==(const String &rhs) const { return equals(rhs); }
+  unsigned char operator==(const char *cstr) const { return equals(cstr); }
+  unsigned char operator!=(const String &rhs) const { return !equals(rhs); }
+  unsigned char operator!=(const char *cstr) const { return !equals(cstr); }
+  unsigned char startsWith(const String &prefix) const;
+  unsigned char endsWith(const String &suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const;
+  const char *c_str() const { return buffer ? buffer : ""; }
+
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String &str, unsigned int fromIndex = 0) const;
+  int lastIndexOf(const String &str, unsigned int fromIndex) const;
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, len); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void replace(const String &find, const String &replace);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+
+protected:
+  char *buffer;
+  unsigned int capacity;
+  unsigned int len;
+  void init();
+  void invalidate();
+  unsigned char changeBuffer(unsigned int maxStrLen);
+  String &copy(const char *cstr, unsigned int length);
+  void move(String &rhs);
+};
+
+//  Concatenation makes a copy of the left side and appends to it, like StringSumHelper.
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *cstr);
+String operator+(const String &lhs, const __FlashStringHelper *rhs);
+String operator+(const String &lhs, char c);
+String operator+(const String &lhs, unsigned char num);
+String operator+(const String &lhs, int num);
+String operator+(const String &lhs, unsigned int num);
+String operator+(const String &lhs, long num);
+String operator+(const String &lhs, unsigned long num);
+String operator+(const String &lhs, float num);
+String operator+(const String &lhs, double num);
+String operator+(const char *lhs, const String &rhs);
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) { return str ? write((const uint8_t *) str, strlen(str)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *) buffer, size); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const __FlashStringHelper *str) { return write((const char *) str); }
+  size_t print(const String &str) { return write(str.c_str()); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t) c); }
+  size_t print(unsigned char num, int base = DEC) { return print((unsigned long) num, base); }
+  size_t print(int num, int base = DEC) { return print((long) num, base); }
+  size_t print(unsigned int num, int base = DEC) { return print((unsigned long) num, base); }
+  size_t print(long num, int base = DEC);
+  size_t print(unsigned long num, int base = DEC);
+  size_t print(double num, int digits = 2);
+  size_t println() { return write("\r\n"); }
+  template<class T> size_t println(const T &value) { const size_t n = print(value); return n + println(); }
+  template<class T> size_t println(const T &value, int format) { const size_t n = print(value, format); return n + println(); }
+};
+
+class Stream: public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+//  Serial writes to stdout on the host.  Nothing is ever received.
+class HardwareSerial: public Stream {
+public:
+  void begin(unsigned long baud) {}
+  void end() {}
+  int available() { return 0; }
+  int read() { return -1; }
+  int peek() { return -1; }
+  size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+  using Print::write;
+  int availableForWrite() { return 63; }
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // UNABIZ_ARDUINO_HOST_ARDUINO_H
@@ -0,0 +1,183 @@
+//  Emulation of the avr-libc malloc() on a small arena, so that heap fragmentation on the
+//  host behaves like on the Arduino.  Follows avr-libc malloc.c and realloc.c: 2-byte size
+//  header before each block, a free list sorted by address with neighbours merged, best fit
+//  from the free list, and the break moved up or down at the top of the heap.
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostHeap.h"
+
+static uint8_t arena[HOST_HEAP_MAX];
+static size_t heapSize = HOST_HEAP_SIZE;
+//  Offset of the break.  Everything above is unused.  Offsets start after the
+//  first block's header, so 0 can mean none.
+static size_t brk = 2;
+static uint16_t freeList = 0;  //  Offset of the first free block, 0 for none.
+static size_t failures = 0;
+static unsigned long calls = 0;
+static bool unlimited = false;  //  New blocks come from malloc().
+
+//  Free list nodes are stored in the freed block as 16-bit fields, like on AVR:
+//  size (excluding the header), then the offset of the next free block.
+static const size_t HEADER = 2;
+static const size_t NODE = 4;
+
+static bool inArena(void *ptr) { return ptr >= arena && ptr < arena + HOST_HEAP_MAX; }
+
+static uint16_t get16(size_t pos) { return arena[pos] | (arena[pos + 1] << 8); }
+static void set16(size_t pos, uint16_t value) { arena[pos] = value & 0xff; arena[pos + 1] = value >> 8; }
+static size_t blockSize(size_t block) { return get16(block - HEADER); }
+static void setBlockSize(size_t block, size_t size) { set16(block - HEADER, size); }
+static uint16_t nextFree(size_t block) { return get16(block); }
+static void setNextFree(size_t block, uint16_t next) { set16(block, next); }
+
+bool hostHeapSetSize(size_t size) {
+  //  Change the heap size.  Fails if the heap already extends beyond it.
+  if (size > HOST_HEAP_MAX || size < brk) return false;
+  heapSize = size;
+  return true;
+}
+
+static size_t allocate(size_t length) {
+  //  Return the offset of a block of at least length bytes, or 0 if the heap is full.
+  if (length < NODE - HEADER) length = NODE - HEADER;
+  //  Use an exact fit from the free list, else the smallest block that is big enough.
+  size_t best = 0, bestPrev = 0, prev = 0;
+  for (size_t block = freeList; block; prev = block, block = nextFree(block)) {
+    const size_t size = blockSize(block);
+    if (size < length) continue;
+    if (size == length) {
+      if (prev) setNextFree(prev, nextFree(block)); else freeList = nextFree(block);
+      return block;
+    }
+    if (!best || size < blockSize(best)) { best = block; bestPrev = prev; }
+  }
+  if (best) {
+    const size_t size = blockSize(best);
+    if (size - length < NODE) {
+      //  Too small to split, hand out the whole block.
+      if (bestPrev) setNextFree(bestPrev, nextFree(best)); else freeList = nextFree(best);
+      return best;
+    }
+    //  Split, handing out the top part so the free list node stays in place.
+    setBlockSize(best, size - length - HEADER);
+    const size_t block = best + size - length;
+    setBlockSize(block, length);
+    return block;
+  }
+  //  Nothing in the free list.  Extend the break.  Free blocks touching the break
+  //  were already given back by release().
+  if (brk + length > heapSize) { failures++; return 0; }
+  const size_t block = brk;
+  setBlockSize(block, length);
+  brk = block + length + HEADER;
+  return block;
+}
+
+static void release(size_t block) {
+  //  Insert into the free list in address order, merging with neighbours.
+  size_t prev = 0, next = freeList;
+  while (next && next < block) { prev = next; next = nextFree(next); }
+  setNextFree(block, next);
+  if (prev) setNextFree(prev, block); else freeList = block;
+  if (next && block + blockSize(block) + HEADER == next) {
+    setBlockSize(block, blockSize(block) + HEADER + blockSize(next));
+    setNextFree(block, nextFree(next));
+  }
+  if (prev && prev + blockSize(prev) + HEADER == block) {
+    setBlockSize(prev, blockSize(prev) + HEADER + blockSize(block));
+    setNextFree(prev, nextFree(block));
+    block = prev;
+  }
+  //  If the last free block touches the break, give it back.
+  if (!nextFree(block) && block + blockSize(block) + HEADER == brk) {
+    brk = block;
+    if (block == freeList) freeList = 0;
+    else {
+      size_t p = freeList;
+      while (nextFree(p) != block) p = nextFree(p);
+      setNextFree(p, 0);
+    }
+  }
+}
+
+void hostHeapSetUnlimited() { unlimited = true; }
+
+void *hostMalloc(size_t length) {
+  if (unlimited) return malloc(length);
+  calls++;
+  const size_t block = allocate(length);
+  return block ? arena + block : 0;
+}
+
+void hostFree(void *ptr) {
+  if (!ptr) return;
+  if (!inArena(ptr)) { free(ptr); return; }
+  release((uint8_t *) ptr - arena);
+}
+
+void *hostRealloc(void *ptr, size_t length) {
+  //  Shrink in place, grow into the next free block or the break, else move.
+  if (!ptr) return hostMalloc(length);
+  if (!inArena(ptr)) return realloc(ptr, length);
+  calls++;
+  const size_t block = (uint8_t *) ptr - arena;
+  size_t size = blockSize(block);
+  if (length < NODE - HEADER) length = NODE - HEADER;
+  if (length <= size) {
+    if (size - length >= NODE) {
+      //  Split off the rest and free it.
+      setBlockSize(block, length);
+      const size_t rest = block + length + HEADER;
+      setBlockSize(rest, size - length - HEADER);
+      release(rest);
+    }
+    return ptr;
+  }
+  //  Grow into the following free block if it is big enough.
+  const size_t end = block + size + HEADER;
+  size_t prev = 0;
+  for (size_t f = freeList; f; prev = f, f = nextFree(f)) {
+    if (f != end) continue;
+    const size_t combined = size + HEADER + blockSize(f);
+    if (combined < length) break;
+    if (prev) setNextFree(prev, nextFree(f)); else freeList = nextFree(f);
+    setBlockSize(block, combined);
+    if (combined - length >= NODE) {
+      setBlockSize(block, length);
+      const size_t rest = block + length + HEADER;
+      setBlockSize(rest, combined - length - HEADER);
+      release(rest);
+    }
+    return ptr;
+  }
+  //  Grow at the top of the heap.
+  if (end == brk) {
+    if (block + length > heapSize) { failures++; return 0; }
+    setBlockSize(block, length);
+    brk = block + length + HEADER;
+    return ptr;
+  }
+  const size_t moved = allocate(length);
+  if (!moved) return 0;
+  memcpy(arena + moved, ptr, size);
+  hostFree(ptr);
+  return arena + moved;
+}
+
+void hostHeapStats(HostHeapStats &stats) {
+  stats.size = heapSize;
+  stats.free = heapSize > brk ? heapSize - brk : 0;
+  stats.largest = stats.free;
+  stats.freeBlocks = 0;
+  for (size_t block = freeList; block; block = nextFree(block)) {
+    const size_t size = blockSize(block);
+    stats.free += size + HEADER;
+    if (size > stats.largest) stats.largest = size;
+    stats.freeBlocks++;
+  }
+  stats.used = heapSize - stats.free;
+  stats.top = brk - HEADER;
+  stats.failures = failures;
+  stats.calls = calls;
+}
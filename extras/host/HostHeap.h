@@ -0,0 +1,37 @@
+//  Emulation of the avr-libc malloc() on a small arena, so that heap fragmentation on the
+//  host behaves like on the Arduino.  Used by the host String class.
+#ifndef UNABIZ_ARDUINO_HOST_HEAP_H
+#define UNABIZ_ARDUINO_HOST_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+const size_t HOST_HEAP_MAX = 4096;  //  Largest heap supported.  ATmega328P has 2048 bytes of RAM in total.
+//  Default heap size: what is left on an Uno after the library's globals and the stack.
+#ifndef HOST_HEAP_SIZE
+#define HOST_HEAP_SIZE 1024
+#endif  //  HOST_HEAP_SIZE
+
+struct HostHeapStats {
+  size_t size;  //  Heap size.
+  size_t used;  //  Bytes allocated to the program, including the 2-byte headers.
+  size_t free;  //  Bytes free, in the free list and above the break.
+  size_t largest;  //  Largest block that can be allocated.
+  size_t freeBlocks;  //  Number of blocks in the free list.  Grows with fragmentation.
+  size_t top;  //  Highest address used, like __brkval - __malloc_heap_start.
+  size_t failures;  //  Allocations that failed because the heap was full.
+  unsigned long calls;  //  malloc() and realloc() calls, each a few hundred cycles on AVR.
+};
+
+//  Change the heap size.  Fails if the heap already extends beyond it.  Can't start
+//  over with an empty heap, since global Strings allocate before main().
+bool hostHeapSetSize(size_t size);
+//  Allocate from the host's malloc() from now on, for running many simulated nodes in one
+//  process.  Blocks already in the arena stay there until freed.
+void hostHeapSetUnlimited();
+void *hostMalloc(size_t length);
+void *hostRealloc(void *ptr, size_t length);
+void hostFree(void *ptr);
+void hostHeapStats(HostHeapStats &stats);
+
+#endif // UNABIZ_ARDUINO_HOST_HEAP_H
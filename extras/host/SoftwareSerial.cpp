@@ -0,0 +1,105 @@
+//  SoftwareSerial for the host.
+
+#include "SoftwareSerial.h"
+
+static HostModule *module = 0;
+static uint8_t rxBuffer[HOST_SERIAL_BUFFER];
+static size_t rxHead = 0, rxCount = 0;
+bool SoftwareSerial::overflowed = false;
+static long baud = 0;
+static unsigned long byteTime = HOST_BYTE_TIME;
+
+//  Bytes sent by the module and the time each one finishes arriving.
+struct LineByte {
+  uint8_t c;
+  unsigned long long time;
+};
+static LineByte line[HOST_LINE_BUFFER];
+static size_t lineHead = 0, lineCount = 0;
+static unsigned long long lineFree = 0;  //  When the module can start sending the next byte.
+
+void HostModule::respond(uint8_t c) {
+  //  Only a simulator that never waits for the sketch can fill the line.  Drop the byte.
+  if (lineCount >= HOST_LINE_BUFFER) return;
+  if (lineFree < hostClock()) lineFree = hostClock();
+  lineFree += byteTime;
+  LineByte &b = line[(lineHead + lineCount++) % HOST_LINE_BUFFER];
+  b.c = c;
+  b.time = lineFree;
+}
+
+void HostModule::wait(unsigned long ms) {
+  const unsigned long long start = hostClock() + (unsigned long long) ms * 1000;
+  if (lineFree < start) lineFree = start;
+}
+
+static void pinWrite(uint8_t pin, uint8_t value) {
+  if (module) module->pinWrite(pin, value);
+}
+
+void SoftwareSerial::setModule(HostModule *module0) {
+  module = module0;
+  hostPinHook = pinWrite;
+  rxHead = rxCount = 0;
+  lineHead = lineCount = 0;
+  lineFree = 0;
+}
+
+void SoftwareSerial::push(uint8_t c) {
+  //  Like the real SoftwareSerial, bytes are dropped when the buffer is full.
+  if (rxCount >= HOST_SERIAL_BUFFER) { overflowed = true; return; }
+  rxBuffer[(rxHead + rxCount++) % HOST_SERIAL_BUFFER] = c;
+}
+
+static void deliver() {
+  //  Move the bytes that have arrived by now into the receive buffer.
+  while (lineCount && line[lineHead].time <= hostClock()) {
+    SoftwareSerial::push(line[lineHead].c);
+    lineHead = (lineHead + 1) % HOST_LINE_BUFFER;
+    lineCount--;
+  }
+}
+
+void SoftwareSerial::begin(long baud0) {
+  //  10 bits per byte: start, 8 data and stop.
+  baud = baud0;
+  if (baud > 0) byteTime = 10000000UL / baud;
+  listen();
+}
+
+bool SoftwareSerial::listen() {
+  //  Bytes that arrived while nobody was listening are lost.
+  if (listening) return false;
+  deliver();
+  rxHead = rxCount = 0;
+  listening = true;
+  return true;
+}
+
+long SoftwareSerial::getBaud() { return baud; }
+
+int SoftwareSerial::available() {
+  deliver();
+  if (rxCount) return rxCount;
+  //  The sketch is waiting.  Skip ahead instead of spinning.
+  if (lineCount) hostAdvanceTo(line[lineHead].time);
+  else delayMicroseconds(HOST_POLL_TIME);
+  deliver();
+  return rxCount;
+}
+
+int SoftwareSerial::peek() { deliver(); return rxCount ? rxBuffer[rxHead] : -1; }
+
+int SoftwareSerial::read() {
+  deliver();
+  if (!rxCount) return -1;
+  const uint8_t c = rxBuffer[rxHead];
+  rxHead = (rxHead + 1) % HOST_SERIAL_BUFFER;
+  rxCount--;
+  return c;
+}
+
+size_t SoftwareSerial::write(uint8_t c) {
+  if (module) module->receive(c);
+  return 1;
+}
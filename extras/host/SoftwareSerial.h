@@ -0,0 +1,50 @@
+//  SoftwareSerial for the host.  Bytes written are passed to a HostModule, which
+//  simulates the SIGFOX module and queues its response for read().  Responses arrive
+//  one byte at a time at the serial line speed, on the virtual clock.
+#ifndef UNABIZ_ARDUINO_HOST_SOFTWARE_SERIAL_H
+#define UNABIZ_ARDUINO_HOST_SOFTWARE_SERIAL_H
+
+#include "Arduino.h"
+
+const size_t HOST_SERIAL_BUFFER = 64;  //  Same receive buffer size as SoftwareSerial.
+const size_t HOST_LINE_BUFFER = 512;  //  Bytes in flight from the module, not received yet.
+const unsigned long HOST_BYTE_TIME = 1042;  //  Microseconds to send 10 bits at 9600 bps, until begin() sets the speed.
+const unsigned long HOST_POLL_TIME = 1000;  //  Microseconds passed when polling finds nothing to read.
+
+class HostModule {
+public:
+  virtual ~HostModule() {}
+  //  Called for every byte sent to the module.  Call respond() to send bytes back.
+  virtual void receive(uint8_t c) = 0;
+  void respond(const char *s) { while (*s) respond((uint8_t) *s++); }
+  void respond(uint8_t c);  //  Send c after the bytes already sent, at the line speed.
+  void wait(unsigned long ms);  //  Start the next response no earlier than ms from now.
+  virtual void pinWrite(uint8_t pin, uint8_t value) {}  //  Called for every digitalWrite().
+};
+
+class SoftwareSerial: public Stream {
+public:
+  SoftwareSerial(uint8_t rx, uint8_t tx) {}
+  void begin(long baud);  //  The module responds at this speed.
+  void end() { listening = false; }
+  bool listen();  //  Like SoftwareSerial, starting to listen empties the receive buffer.
+  bool isListening() { return listening; }
+  bool overflow() { bool o = overflowed; overflowed = false; return o; }
+  //  If nothing has arrived, the clock moves to the next byte from the module,
+  //  or by HOST_POLL_TIME if the module isn't sending, so timeouts expire.
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t c);
+  using Print::write;
+  void flush() {}
+  static void setModule(HostModule *module);  //  Module that receives the bytes written.
+  static long getBaud();  //  Speed set by the last begin(), or 0 if never set.
+  static void push(uint8_t c);  //  Queue a byte for read() now, as if received from the module.
+
+private:
+  bool listening = false;
+  static bool overflowed;
+};
+
+#endif // UNABIZ_ARDUINO_HOST_SOFTWARE_SERIAL_H
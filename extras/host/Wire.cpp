@@ -0,0 +1,25 @@
+//  I2C for the host.
+
+#include "Wire.h"
+
+TwoWire Wire;
+uint8_t TwoWire::registers[256];
+
+void hostWireSetRegister(uint8_t reg, uint8_t value) { TwoWire::registers[reg] = value; }
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+  count = quantity;
+  return quantity;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (first) { reg = c; first = false; }
+  else registers[reg++] = c;
+  return 1;
+}
+
+int TwoWire::read() {
+  if (!count) return -1;
+  count--;
+  return registers[reg++];
+}
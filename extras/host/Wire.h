@@ -0,0 +1,33 @@
+//  I2C for the host.  Every device reads back from one register map set by
+//  hostWireSetRegister(), enough for sensor drivers in the examples.
+#ifndef UNABIZ_ARDUINO_HOST_WIRE_H
+#define UNABIZ_ARDUINO_HOST_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire: public Stream {
+public:
+  void begin() {}
+  void beginTransmission(uint8_t address) { first = true; }
+  void beginTransmission(int address) { beginTransmission((uint8_t) address); }
+  uint8_t endTransmission() { return 0; }
+  uint8_t requestFrom(uint8_t address, uint8_t quantity);
+  uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t) address, (uint8_t) quantity); }
+  size_t write(uint8_t c);  //  The first byte after beginTransmission() selects the register.
+  using Print::write;
+  int available() { return count; }
+  int read();
+  int peek() { return count ? registers[reg] : -1; }
+
+private:
+  bool first = false;
+  uint8_t reg = 0;  //  Register read or written next.
+  uint8_t count = 0;  //  Bytes left from requestFrom().
+  static uint8_t registers[256];
+  friend void hostWireSetRegister(uint8_t reg, uint8_t value);
+};
+
+extern TwoWire Wire;
+void hostWireSetRegister(uint8_t reg, uint8_t value);  //  Set the value read from the register.
+
+#endif // UNABIZ_ARDUINO_HOST_WIRE_H
@@ -0,0 +1,134 @@
+//  Captures of the traffic between a transceiver and its module.
+
+#include <stdlib.h>
+#include <string.h>
+#include "CaptureFile.h"
+
+static const char MAGIC[] = "SCAP";
+
+static bool isType(int c) {
+  return c == CAPTURE_EXCHANGE || c == CAPTURE_SENT || c == CAPTURE_RECEIVED;
+}
+
+static bool readText(FILE *file, CaptureLog &log, std::string &error) {
+  //  Pick out the "@@" lines, wherever they start, and skip everything else.
+  char line[256];
+  unsigned long time = 0;
+  bool started = false;
+  unsigned long lineNumber = 0;
+  while (fgets(line, sizeof(line), file)) {
+    lineNumber++;
+    const char *p = strstr(line, "@@");
+    if (!p) continue;
+    const char type = p[2];
+    char *end;
+    const unsigned long value = strtoul(p + 3, &end, 16);
+    if (end == p + 3) { error = "bad time on line " + std::to_string(lineNumber); return false; }
+    if (type == CAPTURE_START) {
+      //  Only one capture per file.
+      if (started) break;
+      started = true;
+      log.startTime = value;
+      continue;
+    }
+    if (!isType(type)) { error = "bad type on line " + std::to_string(lineNumber); return false; }
+    time += value;
+    CaptureRecord record;
+    record.type = type;
+    record.time = time;
+    for (const char *h = end; *h; ) {
+      if (*h == ' ' || *h == '\r' || *h == '\n') { h++; continue; }
+      char digits[3] = { h[0], h[1], 0 };
+      char *digitsEnd;
+      const unsigned long b = strtoul(digits, &digitsEnd, 16);
+      if (digitsEnd != digits + 2) { error = "bad hex on line " + std::to_string(lineNumber); return false; }
+      record.bytes.push_back(b);
+      h += 2;
+    }
+    log.records.push_back(record);
+  }
+  if (!started) { error = "no capture found"; return false; }
+  return true;
+}
+
+static bool readVarint(FILE *file, unsigned long &value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 32; shift += 7) {
+    const int c = fgetc(file);
+    if (c == EOF) return false;
+    value |= (unsigned long) (c & 0x7f) << shift;
+    if (!(c & 0x80)) return true;
+  }
+  return false;
+}
+
+static void writeVarint(FILE *file, unsigned long value) {
+  while (value >= 0x80) { fputc((value & 0x7f) | 0x80, file); value >>= 7; }
+  fputc(value, file);
+}
+
+static bool readBinary(FILE *file, CaptureLog &log, std::string &error) {
+  if (fgetc(file) != CAPTURE_FILE_VERSION) { error = "unknown version"; return false; }
+  if (!readVarint(file, log.startTime)) { error = "truncated header"; return false; }
+  unsigned long time = 0;
+  int type;
+  while ((type = fgetc(file)) != EOF) {
+    unsigned long delta, length;
+    if (!isType(type) || !readVarint(file, delta) || !readVarint(file, length) || length > 255) {
+      error = "bad record " + std::to_string(log.records.size());
+      return false;
+    }
+    time += delta;
+    CaptureRecord record;
+    record.type = type;
+    record.time = time;
+    record.bytes.resize(length);
+    if (length > 0 && fread(&record.bytes[0], 1, length, file) != length) { error = "truncated record"; return false; }
+    log.records.push_back(record);
+  }
+  return true;
+}
+
+bool readCapture(const char *path, CaptureLog &log, std::string &error) {
+  FILE *file = fopen(path, "rb");
+  if (!file) { error = std::string("can't open ") + path; return false; }
+  log.startTime = 0;
+  log.records.clear();
+  char magic[4];
+  const bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, MAGIC, sizeof(magic)) == 0;
+  if (!binary) rewind(file);
+  const bool ok = binary ? readBinary(file, log, error) : readText(file, log, error);
+  fclose(file);
+  return ok;
+}
+
+bool writeCapture(const char *path, const CaptureLog &log) {
+  FILE *file = fopen(path, "wb");
+  if (!file) return false;
+  fwrite(MAGIC, 1, 4, file);
+  fputc(CAPTURE_FILE_VERSION, file);
+  writeVarint(file, log.startTime);
+  unsigned long time = 0;
+  for (size_t i = 0; i < log.records.size(); i++) {
+    const CaptureRecord &record = log.records[i];
+    fputc(record.type, file);
+    writeVarint(file, record.time - time);
+    time = record.time;
+    writeVarint(file, record.bytes.size());
+    if (!record.bytes.empty()) fwrite(&record.bytes[0], 1, record.bytes.size(), file);
+  }
+  return fclose(file) == 0;
+}
+
+void printCapture(FILE *out, const CaptureLog &log) {
+  fprintf(out, "@@%c%lX\n", CAPTURE_START, log.startTime);
+  unsigned long time = 0;
+  for (size_t i = 0; i < log.records.size(); i++) {
+    const CaptureRecord &record = log.records[i];
+    fprintf(out, "@@%c%lX", record.type, record.time - time);
+    time = record.time;
+    if (!record.bytes.empty()) fputc(' ', out);
+    for (size_t b = 0; b < record.bytes.size(); b++) fprintf(out, "%02X", record.bytes[b]);
+    fputc('\n', out);
+  }
+}
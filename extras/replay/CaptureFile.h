@@ -0,0 +1,44 @@
+//  Captures of the traffic between a transceiver and its module, as printed by Capture.cpp
+//  ("@@" lines, possibly mixed with other output) or in the compact binary format.
+//
+//  Binary format: "SCAP", a version byte, then the start time as a varint, then records of
+//  a type byte (CaptureType), the ms since the previous record as a varint, the number of
+//  bytes as a varint and the bytes.  Varints have 7 bits per byte, low bits first.
+#ifndef UNABIZ_ARDUINO_CAPTURE_FILE_H
+#define UNABIZ_ARDUINO_CAPTURE_FILE_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "SIGFOX.h"
+
+const uint8_t CAPTURE_FILE_VERSION = 1;
+
+struct CaptureRecord {
+  uint8_t type;  //  CAPTURE_EXCHANGE, CAPTURE_SENT or CAPTURE_RECEIVED.
+  unsigned long time;  //  ms since the start of the capture.
+  std::vector<uint8_t> bytes;
+};
+
+struct CaptureLog {
+  unsigned long startTime;  //  millis() on the device when the capture started.
+  std::vector<CaptureRecord> records;
+};
+
+//  Read a capture in either format.  Returns false with a message in error if it can't.
+bool readCapture(const char *path, CaptureLog &log, std::string &error);
+bool writeCapture(const char *path, const CaptureLog &log);  //  Write in the binary format.
+void printCapture(FILE *out, const CaptureLog &log);  //  Print as "@@" lines.
+
+//  Port that writes what is printed to a file, for capturing on the host.
+class FilePrint: public Print {
+public:
+  FilePrint(FILE *file): file(file) {}
+  virtual size_t write(uint8_t c) { return fputc(c, file) == EOF ? 0 : 1; }
+  using Print::write;
+
+private:
+  FILE *file;
+};
+
+#endif // UNABIZ_ARDUINO_CAPTURE_FILE_H
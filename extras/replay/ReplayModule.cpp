@@ -0,0 +1,108 @@
+//  Module that plays back a capture.
+
+#include <string.h>
+#include "ReplayModule.h"
+
+ReplayModule::ReplayModule(const CaptureLog &log, unsigned speed0) {
+  speed = speed0;
+  //  The capture has the time of the first byte of each line only.  The time of the last
+  //  byte sent, which the response follows, comes from the spacing of the sent lines.
+  unsigned long interval = REPLAY_BYTE_INTERVAL, firstSent = 0, lastSent = 0;
+  size_t lastSentLength = 0;
+  for (size_t i = 0; i < log.records.size(); i++) {
+    const CaptureRecord &record = log.records[i];
+    if (record.type == CAPTURE_EXCHANGE) {
+      ReplayCommand command;
+      command.time = command.sentTime = record.time;
+      command.replayed = false;
+      command.replayedTime = 0;
+      commands.push_back(command);
+      continue;
+    }
+    //  Skip bytes before the first command, e.g. if the capture started in the middle of one.
+    if (commands.empty()) continue;
+    ReplayCommand &command = commands.back();
+    if (record.type == CAPTURE_SENT) {
+      if (command.sent.empty()) firstSent = command.sentTime = record.time;
+      else interval = (record.time - firstSent) / command.sent.size();
+      lastSent = record.time;
+      lastSentLength = record.bytes.size();
+      command.sent.insert(command.sent.end(), record.bytes.begin(), record.bytes.end());
+      continue;
+    }
+    //  Received bytes before anything was sent can't be matched to the driver.
+    if (command.sent.empty() || record.bytes.empty()) continue;
+    const unsigned long lastByte = lastSent + (lastSentLength - 1) * interval;
+    ReplayResponse response;
+    response.after = command.sent.size() - 1;
+    response.wait = record.time > lastByte ? record.time - lastByte : 0;
+    response.bytes = record.bytes;
+    command.responses.push_back(response);
+  }
+  next = 0;
+  current = commands.size();
+  matching = false;
+  commandStart = lastByte = 0;
+  started = false;
+  clearStats();
+}
+
+void ReplayModule::receive(uint8_t c) {
+  const unsigned long now = millis();
+  if (!started || now - lastByte >= REPLAY_COMMAND_GAP) {
+    endCommand();
+    stats.commands++;
+    commandStart = now;
+  }
+  started = true;
+  lastByte = now;
+  sent.push_back(c);
+  //  Stay with the recorded command while it matches, else look for one that does.
+  const size_t index = sent.size() - 1;
+  if (!matching || index >= commands[current].sent.size() || commands[current].sent[index] != c) {
+    matching = findCommand();
+  }
+  if (!matching) { stats.unmatched++; return; }
+  stats.matched++;
+  const ReplayCommand &command = commands[current];
+  for (size_t i = 0; i < command.responses.size(); i++) {
+    const ReplayResponse &response = command.responses[i];
+    if (response.after != index) continue;
+    wait(response.wait * speed / 100);
+    for (size_t b = 0; b < response.bytes.size(); b++) respond(response.bytes[b]);
+    stats.responses += response.bytes.size();
+  }
+}
+
+bool ReplayModule::findCommand() {
+  //  First recorded command not yet matched that starts with the bytes sent so far.
+  const size_t end = next + REPLAY_LOOKAHEAD < commands.size() ? next + REPLAY_LOOKAHEAD : commands.size();
+  for (size_t i = next; i < end; i++) {
+    const std::vector<uint8_t> &recorded = commands[i].sent;
+    if (recorded.size() >= sent.size() && memcmp(&recorded[0], &sent[0], sent.size()) == 0) {
+      current = i;
+      return true;
+    }
+  }
+  current = commands.size();
+  return false;
+}
+
+void ReplayModule::endCommand() {
+  if (current < commands.size()) {
+    ReplayCommand &command = commands[current];
+    if (matching && sent.size() == command.sent.size()) stats.matchedCommands++;
+    command.replayed = true;
+    command.replayedTime = commandStart;
+    stats.skippedCommands += current - next;
+    next = current + 1;
+  }
+  sent.clear();
+  current = commands.size();
+  matching = false;
+  started = false;
+}
+
+void ReplayModule::getStats(ReplayStats &stats0) { stats0 = stats; }
+
+void ReplayModule::clearStats() { memset(&stats, 0, sizeof(stats)); }
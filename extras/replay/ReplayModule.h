@@ -0,0 +1,71 @@
+//  Module that plays back a capture: it answers each byte sent by the driver with the bytes
+//  the real module sent after it, after the recorded delay.  The driver's commands are
+//  matched to the recorded commands, so a driver that sends a command the capture doesn't
+//  have, or skips one, gets back in step at the next command that matches.
+#ifndef UNABIZ_ARDUINO_REPLAY_MODULE_H
+#define UNABIZ_ARDUINO_REPLAY_MODULE_H
+
+#include <vector>
+#include "CaptureFile.h"
+
+//  Both drivers wait 200 ms after opening the port before they send a command, and send
+//  the bytes of a command 10 ms apart.  A longer gap starts a new command.
+const unsigned long REPLAY_COMMAND_GAP = 100;
+const unsigned long REPLAY_BYTE_INTERVAL = 10;  //  ms between sent bytes if the capture can't tell.
+const size_t REPLAY_LOOKAHEAD = 16;  //  Most recorded commands skipped to get back in step.
+
+//  Bytes the module sent after one of the bytes of a command.
+struct ReplayResponse {
+  size_t after;  //  Index of the sent byte that they follow.
+  unsigned long wait;  //  ms from the sent byte to the first byte of the response.
+  std::vector<uint8_t> bytes;
+};
+
+//  One command recorded between captureExchange() and captureFlush().
+struct ReplayCommand {
+  unsigned long time;  //  ms since the start of the capture.
+  unsigned long sentTime;  //  ms since the start of the capture of the first byte sent.
+  std::vector<uint8_t> sent;
+  std::vector<ReplayResponse> responses;
+  bool replayed;  //  The driver sent it in the replay...
+  unsigned long replayedTime;  //  ...starting at this millis().
+};
+
+struct ReplayStats {
+  unsigned long commands;  //  Commands sent by the driver.
+  unsigned long matchedCommands;  //  Commands that matched a recorded command all the way.
+  unsigned long skippedCommands;  //  Recorded commands that the driver didn't send.
+  unsigned long matched;  //  Bytes sent by the driver that matched the capture.
+  unsigned long unmatched;  //  Bytes sent by the driver with no recorded command to match.
+  unsigned long responses;  //  Bytes played back.
+};
+
+class ReplayModule: public HostModule {
+public:
+  //  speed is the percentage of the recorded delays to use, e.g. 0 to answer at once.
+  ReplayModule(const CaptureLog &log, unsigned speed = 100);
+  void receive(uint8_t c);
+  //  End the driver's command, e.g. after each call to the driver.  Otherwise a gap of
+  //  REPLAY_COMMAND_GAP before the next byte ends it.
+  void endCommand();
+  const std::vector<ReplayCommand> &getCommands() const { return commands; }
+  size_t getNext() const { return next; }  //  Index of the next recorded command to match.
+  void getStats(ReplayStats &stats);
+  void clearStats();
+
+private:
+  bool findCommand();
+
+  std::vector<ReplayCommand> commands;
+  unsigned speed;
+  size_t next;  //  Recorded commands before this one have been matched or skipped.
+  size_t current;  //  Recorded command matched by the driver's command, or commands.size() if none.
+  bool matching;  //  All bytes of the driver's command so far matched the current command.
+  std::vector<uint8_t> sent;  //  Bytes sent so far in the driver's command.
+  unsigned long commandStart;  //  millis() of the first byte of the driver's command.
+  unsigned long lastByte;  //  millis() of the previous byte from the driver.
+  bool started;  //  The driver has sent a byte.
+  ReplayStats stats;
+};
+
+#endif // UNABIZ_ARDUINO_REPLAY_MODULE_H
@@ -0,0 +1,88 @@
+//  Converts a capture between the text printed by the device and the compact binary format,
+//  and prints a summary of the commands in it.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run with options as name=value, e.g. to pick the capture out of a Serial Monitor log:
+//    ./capture file=serial.log out=capture.scap
+//  Options: file (text or binary capture), out (binary file to write), text (1 to print the
+//  capture as "@@" lines), verbose (1 to print each command).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "ReplayModule.h"
+
+struct Options {
+  String file;
+  String out;
+  bool text = false;
+  bool verbose = false;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const String name = String(arg).substring(0, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "file") options.file = equals + 1;
+  else if (name == "out") options.out = equals + 1;
+  else if (name == "text") options.text = value != 0;
+  else if (name == "verbose") options.verbose = value != 0;
+  else return false;
+  return true;
+}
+
+static void printBytes(const std::vector<uint8_t> &bytes) {
+  //  Text as text, with \r and other bytes in hex.
+  for (size_t i = 0; i < bytes.size(); i++) {
+    const uint8_t c = bytes[i];
+    if (c >= ' ' && c < 0x7f && c != '\\') putchar(c);
+    else printf("\\x%02X", c);
+  }
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  if (options.file.length() == 0) { fprintf(stderr, "Usage: capture file=serial.log [out=capture.scap]\n"); return 2; }
+  CaptureLog log;
+  std::string error;
+  if (!readCapture(options.file.c_str(), log, error)) { fprintf(stderr, "%s: %s\n", options.file.c_str(), error.c_str()); return 1; }
+  if (options.out.length() > 0 && !writeCapture(options.out.c_str(), log)) { perror(options.out.c_str()); return 1; }
+  if (options.text) { printCapture(stdout, log); return 0; }
+
+  const ReplayModule module(log);
+  const std::vector<ReplayCommand> &commands = module.getCommands();
+  unsigned long sent = 0, received = 0, silent = 0, waitTotal = 0, waitMax = 0;
+  for (size_t i = 0; i < commands.size(); i++) {
+    const ReplayCommand &command = commands[i];
+    sent += command.sent.size();
+    if (command.responses.empty()) silent++;
+    for (size_t r = 0; r < command.responses.size(); r++) {
+      received += command.responses[r].bytes.size();
+      if (r > 0) continue;
+      waitTotal += command.responses[r].wait;
+      if (command.responses[r].wait > waitMax) waitMax = command.responses[r].wait;
+    }
+    if (!options.verbose) continue;
+    printf("%8lu ms ", command.time);
+    printBytes(command.sent);
+    for (size_t r = 0; r < command.responses.size(); r++) {
+      printf(r == 0 ? " -> +%lu ms " : " +%lu ms ", command.responses[r].wait);
+      printBytes(command.responses[r].bytes);
+    }
+    putchar('\n');
+  }
+  const unsigned long duration = log.records.empty() ? 0 : log.records.back().time;
+  printf("Started at %lu ms, lasts %lu ms\n", log.startTime, duration);
+  printf("Commands %lu, without response %lu, bytes sent %lu, received %lu\n",
+         (unsigned long) commands.size(), silent, sent, received);
+  if (commands.size() > silent) {
+    printf("First response after ms: avg %lu, max %lu\n", waitTotal / (commands.size() - silent), waitMax);
+  }
+  return 0;
+}
@@ -0,0 +1,250 @@
+//  Replays a capture from the field against the driver on the virtual clock.  The driver
+//  is started with begin(), then makes each recorded call again at its recorded time, and
+//  the module answers with the recorded bytes after the recorded delays.  Reports the
+//  commands that didn't match the capture, and how the timing compares with the field.
+//
+//  Capture on the device by building with -DSIGFOX_CAPTURE=1 and calling captureStart(Serial)
+//  in setup(), then save the Serial Monitor output to a file.  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run with options as name=value:
+//    ./replay file=capture.txt speed=100
+//  Options: file (text or binary capture), speed (percent of the recorded delays),
+//  transceiver (wisol or radiocrafts, else found from the capture), verbose (1 to print
+//  each call).
+//  The calls replayed are sendMessage(), sendMessageAndGetResponse(), getTemperature(),
+//  getVoltage() and reboot().  Commands of other calls by the sketch are counted as skipped.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "ReplayModule.h"
+
+struct Options {
+  String file;
+  unsigned speed = 100;
+  String transceiver;
+  bool verbose = false;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const String name = String(arg).substring(0, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "file") options.file = equals + 1;
+  else if (name == "speed") options.speed = value;
+  else if (name == "transceiver") options.transceiver = equals + 1;
+  else if (name == "verbose") options.verbose = value != 0;
+  else return false;
+  return true;
+}
+
+//  Calls to the driver found in the capture.
+enum CallType {
+  CALL_SEND,
+  CALL_TEMPERATURE,
+  CALL_VOLTAGE,
+  CALL_REBOOT,  //  Wisol only, e.g. by UplinkQueue after failures.
+};
+
+//  A recorded call to the driver, found by the command that identifies it.
+struct Call {
+  size_t command;  //  Index of the recorded command.
+  CallType type;
+  String payload;  //  Hex digits sent, for CALL_SEND.
+  bool downlink;  //  Asked for a downlink.
+};
+
+static bool startsWith(const std::vector<uint8_t> &bytes, const char *prefix) {
+  const size_t length = strlen(prefix);
+  return bytes.size() >= length && memcmp(&bytes[0], prefix, length) == 0;
+}
+
+static bool equals(const std::vector<uint8_t> &bytes, const char *text) {
+  return bytes.size() == strlen(text) && startsWith(bytes, text);
+}
+
+static String toHex(const uint8_t *bytes, size_t length) {
+  String hex;
+  char digits[3];
+  for (size_t i = 0; i < length; i++) { snprintf(digits, sizeof(digits), "%02x", bytes[i]); hex.concat(digits); }
+  return hex;
+}
+
+static void findCalls(const std::vector<ReplayCommand> &commands, bool wisol, std::vector<Call> &calls) {
+  //  Wisol sends "AT$SF=<hex>\r", or "AT$SF=<hex>,1\r" for a downlink.  Radiocrafts sends
+  //  the payload length from 1 to 12, then the payload, or 'U' or 'V' in Command Mode.
+  for (size_t i = 0; i < commands.size(); i++) {
+    const std::vector<uint8_t> &sent = commands[i].sent;
+    Call call;
+    call.command = i;
+    call.type = CALL_SEND;
+    call.downlink = false;
+    if (wisol) {
+      if (equals(sent, "AT$T?\r")) call.type = CALL_TEMPERATURE;
+      else if (equals(sent, "AT$V?\r")) call.type = CALL_VOLTAGE;
+      else if (equals(sent, "AT$P=0\r")) call.type = CALL_REBOOT;
+      else if (!startsWith(sent, "AT$SF=") || sent.back() != '\r') continue;
+      size_t end = sent.size() - 1;
+      if (end >= 8 && sent[end - 2] == ',' && sent[end - 1] == '1') { call.downlink = true; end -= 2; }
+      if (call.type == CALL_SEND) for (size_t k = 6; k < end; k++) call.payload.concat((char) sent[k]);
+    } else {
+      if (equals(sent, "U")) call.type = CALL_TEMPERATURE;
+      else if (equals(sent, "V")) call.type = CALL_VOLTAGE;
+      else if (sent.empty() || sent[0] < 1 || sent[0] > MAX_BYTES_PER_MESSAGE || sent.size() != 1u + sent[0]) continue;
+      if (call.type == CALL_SEND) call.payload = toHex(&sent[1], sent[0]);
+    }
+    calls.push_back(call);
+  }
+}
+
+static bool send(Wisol &transceiver, const Call &call, String &response) {
+  if (call.downlink) return transceiver.sendMessageAndGetResponse(call.payload, response);
+  return transceiver.sendMessage(call.payload);
+}
+
+static bool send(Radiocrafts &transceiver, const Call &call, String &response) {
+  //  The RC1692HP doesn't do downlinks.
+  return transceiver.sendMessage(call.payload);
+}
+
+//  Wisol returns the temperature in degrees as a float, Radiocrafts as an int.
+static bool getTemperature(Wisol &transceiver, String &result) {
+  float temperature = 0;
+  const bool ok = transceiver.getTemperature(temperature);
+  result = String(temperature);
+  return ok;
+}
+
+static bool getTemperature(Radiocrafts &transceiver, String &result) {
+  int temperature = 0;
+  const bool ok = transceiver.getTemperature(temperature);
+  result = String(temperature);
+  return ok;
+}
+
+template <class Transceiver>
+static bool replayCall(Transceiver &transceiver, const Call &call, String &result) {
+  switch (call.type) {
+    case CALL_TEMPERATURE:
+      return getTemperature(transceiver, result);
+    case CALL_VOLTAGE: {
+      float voltage = 0;
+      const bool ok = transceiver.getVoltage(voltage);
+      result = String(voltage);
+      return ok;
+    }
+    case CALL_REBOOT:
+      return transceiver.reboot(result);
+    default:
+      return send(transceiver, call, result);
+  }
+}
+
+static const char *callName(const Call &call) {
+  switch (call.type) {
+    case CALL_TEMPERATURE: return "getTemperature";
+    case CALL_VOLTAGE: return "getVoltage";
+    case CALL_REBOOT: return "reboot";
+    default: return call.downlink ? "sendMessageAndGetResponse" : "sendMessage";
+  }
+}
+
+template <class Transceiver>
+static int replay(Transceiver &transceiver, ReplayModule &module, const CaptureLog &log,
+                  const Options &options, bool wisol) {
+  const std::vector<ReplayCommand> &commands = module.getCommands();
+  std::vector<Call> calls;
+  findCalls(commands, wisol, calls);
+  //  Start at the device's time when the capture began, so timers like isReady() agree.
+  //  The capture is started just before begin(), which waits before its first command.
+  const unsigned long start = log.startTime;
+  if (millis() < start) hostAdvanceTo((unsigned long long) start * 1000);
+  const unsigned long replayStart = millis();
+  const bool begun = transceiver.begin();
+  module.endCommand();
+  printf("begin: %s in %lu ms\n", begun ? "OK" : "failed", millis() - replayStart);
+
+  unsigned long replayed = 0, failed = 0;
+  for (size_t c = 0; c < calls.size(); c++) {
+    const Call &call = calls[c];
+    String result;
+    bool ok;
+    for (;;) {
+      //  The call starts with the first recorded command not yet replayed, at its recorded time.
+      const size_t first = module.getNext() <= call.command ? module.getNext() : call.command;
+      const unsigned long due = start + commands[first].time;
+      if (millis() < due) hostAdvanceTo((unsigned long long) due * 1000);
+      ok = replayCall(transceiver, call, result);
+      module.endCommand();
+      replayed++;
+      if (!ok) failed++;
+      //  If the call stopped before its command, the recorded call did too, e.g. when
+      //  setOutputPower() got no response.  Make the call again for the next attempt.
+      if (module.getNext() > call.command || module.getNext() == first) break;
+    }
+    if (!options.verbose) continue;
+    const ReplayCommand &command = commands[call.command];
+    printf("%8lu ms %s(%s%s): %s%s%s", command.time, callName(call), call.payload.c_str(),
+           call.downlink ? ",1" : "", ok ? "OK" : "failed", result.length() > 0 ? ", " : "", result.c_str());
+    if (command.replayed) printf(", sent at %+ld ms", (long) (command.replayedTime - start - command.sentTime));
+    else printf(", not sent");
+    putchar('\n');
+  }
+
+  //  How much later or earlier the driver sent each command than in the capture.
+  unsigned long driftCount = 0, driftTotal = 0, driftMax = 0;
+  for (size_t i = 0; i < commands.size(); i++) {
+    const ReplayCommand &command = commands[i];
+    if (!command.replayed) continue;
+    const unsigned long recorded = start + command.sentTime;
+    const unsigned long drift = command.replayedTime > recorded ? command.replayedTime - recorded : recorded - command.replayedTime;
+    driftCount++;
+    driftTotal += drift;
+    if (drift > driftMax) driftMax = drift;
+  }
+  ReplayStats stats;
+  module.getStats(stats);
+  const unsigned long recordedEnd = log.records.empty() ? 0 : log.records.back().time;
+  printf("Calls replayed %lu, failed %lu\n", replayed, failed);
+  printf("Commands: recorded %lu, sent by the driver %lu, matched %lu, skipped %lu, not reached %lu\n",
+         (unsigned long) commands.size(), stats.commands, stats.matchedCommands, stats.skippedCommands,
+         (unsigned long) (commands.size() - module.getNext()));
+  printf("Bytes: matched %lu, unmatched %lu, played back %lu\n", stats.matched, stats.unmatched, stats.responses);
+  printf("Duration: recorded %lu ms, replayed %lu ms at %u%% speed\n",
+         recordedEnd, millis() - replayStart, options.speed);
+  if (driftCount > 0) printf("Drift from the recorded time of each command: avg %lu ms, max %lu ms\n", driftTotal / driftCount, driftMax);
+  TransceiverStats transceiverStats;
+  transceiver.getStats(transceiverStats);
+  printStats(Serial, transceiverStats);
+  return stats.unmatched == 0 ? 0 : 3;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  if (options.file.length() == 0) { fprintf(stderr, "Usage: replay file=capture.txt [speed=100]\n"); return 2; }
+  CaptureLog log;
+  std::string error;
+  if (!readCapture(options.file.c_str(), log, error)) { fprintf(stderr, "%s: %s\n", options.file.c_str(), error.c_str()); return 1; }
+  static ReplayModule module(log, options.speed);
+  const std::vector<ReplayCommand> &commands = module.getCommands();
+  if (commands.empty()) { fprintf(stderr, "%s: no commands\n", options.file.c_str()); return 1; }
+  SoftwareSerial::setModule(&module);
+
+  //  Wisol commands are text starting with "AT".
+  bool wisol = startsWith(commands[0].sent, "AT");
+  if (options.transceiver == "wisol") wisol = true;
+  else if (options.transceiver == "radiocrafts") wisol = false;
+  else if (options.transceiver.length() > 0) { fprintf(stderr, "Unknown transceiver %s\n", options.transceiver.c_str()); return 2; }
+  printf("%s capture, %lu commands\n", wisol ? "Wisol" : "Radiocrafts", (unsigned long) commands.size());
+  if (wisol) {
+    static Wisol transceiver(COUNTRY_FR, false, "NOTUSED", false);
+    return replay(transceiver, module, log, options, true);
+  }
+  static Radiocrafts transceiver(COUNTRY_SG, false, "NOTUSED", false);
+  return replay(transceiver, module, log, options, false);
+}
@@ -0,0 +1,82 @@
+//  Checks Scheduler on the virtual clock: periodic tasks run once per period, and tasks that
+//  reschedule themselves with after() or every() from inside run at most once per pass of
+//  run(), instead of again and again in the same pass.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//    ./scheduler_check
+//  Exits with 1 if a check failed.
+//
+//  millis() wraps at 32 bits here but unsigned long has 64, so the wraparound is not checked.
+
+#include <stdio.h>
+#include "SIGFOX.h"
+
+static Scheduler *scheduler;
+static unsigned long runs;
+
+static void count(void *) { runs++; }
+static void again(void *) { runs++; scheduler->after(scheduler->current(), 0); }
+static void restart(void *) { runs++; scheduler->every(scheduler->current(), 10); }
+static void yielding(void *) { runs++; scheduler->after(scheduler->current(), 0); schedulerYield(); }
+
+static unsigned long failures = 0;
+
+static void expect(const char *name, unsigned long actual, unsigned long expected) {
+  const bool ok = actual == expected;
+  printf("%-60s %lu runs, expected %lu%s\n", name, actual, expected, ok ? "" : "  FAILED");
+  if (!ok) failures++;
+}
+
+//  Calls run() passes times, passesPerMs times in each millisecond, and counts the runs.
+static unsigned long runFor(Scheduler &s, unsigned long passes, unsigned long passesPerMs) {
+  runs = 0;
+  for (unsigned long n = 1; n <= passes; n++) {
+    s.run();
+    if (n % passesPerMs == 0) hostAdvance(1);
+  }
+  return runs;
+}
+
+int main() {
+  hostSetTime(1000);
+  {
+    Scheduler s;
+    scheduler = &s;
+    s.every(s.add(count), 100);
+    expect("every 100 ms for 10000 ms", runFor(s, 10000, 1), 100);
+    expect("  max lateness (ms)", s.getMaxLateness(), 1);
+  }
+  {
+    Scheduler s;
+    scheduler = &s;
+    s.after(s.add(again), 0);
+    expect("after(current(), 0), 1 pass in the same ms", runFor(s, 1, 1), 0);
+    hostAdvance(1);
+    expect("after(current(), 0), 100000 passes in the same ms", runFor(s, 100000, 100001), 1);
+    hostAdvance(1);
+    expect("after(current(), 0), 1000 passes 1 ms apart", runFor(s, 1000, 1), 1000);
+  }
+  {
+    Scheduler s;
+    scheduler = &s;
+    s.after(s.add(restart), 0);
+    hostAdvance(1);
+    expect("every(current(), 10), 100000 passes in the same ms", runFor(s, 100000, 100001), 1);
+    hostAdvance(1);
+    //  The first run of every() is after the delay, 0 here, so it runs in each pass.
+    expect("every(current(), 10), 1000 passes 1 ms apart", runFor(s, 1000, 1), 1000);
+  }
+  {
+    //  A background task that yields runs again only in a pass that starts later.
+    Scheduler s;
+    scheduler = &s;
+    s.begin();
+    const int8_t task = s.add(yielding);
+    s.setBackground(task, true);
+    s.after(task, 0);
+    hostAdvance(1);
+    expect("background after(current(), 0) with schedulerYield()", runFor(s, 100000, 100001), 1);
+  }
+  return failures ? 1 : 0;
+}
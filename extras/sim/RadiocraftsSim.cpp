@@ -0,0 +1,183 @@
+//  Simulator of the Radiocrafts RC1692HP-SIG module for the host build.
+
+#include "RadiocraftsSim.h"
+
+static const uint8_t PROMPT = '>';
+static const uint8_t CMD_READ = 'Y';
+static const uint8_t EXIT_CONFIG = 0xff;
+
+//  Baud rates for the codes at RC_UART_BAUD.
+static const long bauds[] = { 0, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 76800, 115200 };
+
+RadiocraftsSim::RadiocraftsSim(const RadiocraftsSimConfig &config0) {
+  config = config0;
+  mode = SEND_MODE;
+  pending = 0;
+  address = 0;
+  length = 0;
+  received = 0;
+  sink = 0;
+  busyUntil = 0;
+  randomState = config.seed ? config.seed : 1;
+  id = 0x002C30EB;
+  const uint8_t pac0[] = { 0xA8, 0x66, 0x4B, 0x55, 0x23, 0xB5, 0x40, 0x5D };
+  memcpy(pac, pac0, sizeof(pac));
+  temperature = 25;
+  voltage = 3300;
+  memset(memory, 0, sizeof(memory));
+  memory[RC_RF_FREQUENCY_DOMAIN] = 3;  //  RCZ4.
+  memory[RC_RF_POWER] = 0;
+  memory[RC_PUBLIC_KEY] = 0;
+  memory[RC_UART_BAUD] = 5;  //  19200 bps.
+  memory[RC_NETWORK_MODE] = 0;
+  clearStats();
+}
+
+void RadiocraftsSim::receive(uint8_t c) {
+  stats.bytes++;
+  if (chance(config.dropPercent)) { stats.dropped++; return; }
+  //  Bytes sent at another speed arrive as noise.
+  const long baud = SoftwareSerial::getBaud();
+  if (baud != 0 && getBaud() != 0 && baud != getBaud()) { stats.wrongBaud++; return; }
+  //  The UART is not read while the radio is on.
+  if ((long) (millis() - busyUntil) < 0) { stats.busy++; return; }
+  handle(c);
+}
+
+void RadiocraftsSim::handle(uint8_t c) {
+  switch (mode) {
+    case SEND_MODE:
+      if (length > 0) {
+        //  Payload byte.  Transmit once the whole message has arrived.
+        message[received++] = c;
+        if (--length > 0) return;
+        const unsigned long uplinkTime = latency(config.uplinkTime);
+        stats.uplinks++;
+        stats.airTime += uplinkTime;
+        busyUntil = millis() + uplinkTime;
+        if (sink) {
+          char device[9];
+          snprintf(device, sizeof(device), "%08lX", (unsigned long) id);
+          uint8_t downlink[DOWNLINK_SIZE];
+          sink->uplink(device, message, received, false, downlink, busyUntil);
+        }
+        return;
+      }
+      //  First byte is the message length, 1 to 12, or 0 for Command Mode.
+      if (c == 0) {
+        stats.commandModes++;
+        mode = COMMAND_MODE;
+        prompt();
+      } else if (c <= MAX_BYTES_PER_MESSAGE) {
+        length = c;
+        received = 0;
+      } else {
+        stats.ignored++;
+      }
+      return;
+
+    case COMMAND_MODE:
+      if (pending == CMD_READ) {
+        //  Address of the memory read.  Returns the value and a prompt.
+        pending = 0;
+        send(memory[c], config.commandLatency);
+        send(PROMPT, 0);
+        return;
+      }
+      switch (c) {
+        case 'X':  //  Back to Send Mode, without a prompt.
+          stats.sendModes++;
+          mode = SEND_MODE;
+          if (chance(config.strayPromptPercent)) { stats.strayPrompts++; send(PROMPT, config.commandLatency); }
+          return;
+        case 'M':
+          stats.configModes++;
+          mode = CONFIG_MODE;
+          prompt();
+          return;
+        case CMD_READ:  //  Prompt for the address.
+          stats.commands++;
+          pending = CMD_READ;
+          prompt();
+          return;
+        case '9': {  //  ID LSB first, then PAC.
+          stats.commands++;
+          for (uint8_t i = 0; i < 4; i++) send((id >> (8 * i)) & 0xff, i ? 0 : config.commandLatency);
+          for (uint8_t i = 0; i < sizeof(pac); i++) send(pac[i], 0);
+          send(PROMPT, 0);
+          return;
+        }
+        case 'U':
+          stats.commands++;
+          send(temperature + 128, config.commandLatency);
+          send(PROMPT, 0);
+          return;
+        case 'V':
+          stats.commands++;
+          send(voltage / 30, config.commandLatency);
+          send(PROMPT, 0);
+          return;
+        default:
+          stats.ignored++;
+          return;
+      }
+
+    case CONFIG_MODE:
+      //  Pairs of address and value, then 0xFF to return to Command Mode.
+      if (pending == 'M') {
+        pending = 0;
+        memory[address] = c;
+        stats.writes++;
+      } else if (c == EXIT_CONFIG) {
+        mode = COMMAND_MODE;
+        prompt();
+      } else {
+        address = c;
+        pending = 'M';
+      }
+      return;
+  }
+}
+
+void RadiocraftsSim::prompt() {
+  send(PROMPT, config.commandLatency);
+  if (chance(config.strayPromptPercent)) { stats.strayPrompts++; send(PROMPT, 0); }
+}
+
+void RadiocraftsSim::send(uint8_t c, unsigned long latency0) {
+  if (latency0) wait(latency(latency0));
+  respond(c);
+}
+
+unsigned long RadiocraftsSim::latency(unsigned long base) {
+  return config.jitter ? base + nextRandom() % (config.jitter + 1) : base;
+}
+
+bool RadiocraftsSim::chance(uint8_t percent) {
+  return percent > 0 && nextRandom() % 100 < percent;
+}
+
+unsigned long RadiocraftsSim::nextRandom() {
+  //  Own generator, so that each simulated module is repeatable on its own.
+  randomState = randomState * 1103515245 + 12345;
+  return (randomState >> 16) & 0x7fff;
+}
+
+void RadiocraftsSim::getStats(RadiocraftsSimStats &stats0) { stats0 = stats; }
+
+void RadiocraftsSim::clearStats() { memset(&stats, 0, sizeof(stats)); }
+
+Mode RadiocraftsSim::getMode() { return mode; }
+
+void RadiocraftsSim::setMode(Mode mode0) {
+  mode = mode0;
+  pending = 0;
+  length = 0;
+}
+
+void RadiocraftsSim::setSink(UplinkSink *sink0) { sink = sink0; }
+
+long RadiocraftsSim::getBaud() {
+  const uint8_t code = memory[RC_UART_BAUD];
+  return code < sizeof(bauds) / sizeof(bauds[0]) ? bauds[code] : 0;
+}
@@ -0,0 +1,89 @@
+//  Simulator of the Radiocrafts RC1692HP-SIG module for the host build.  Speaks the binary
+//  protocol used by the Radiocrafts driver through the host SoftwareSerial: length-prefixed
+//  messages in Send Mode, 0x00 to enter Command Mode and 'X' to leave it, 'M' and 0xFF for
+//  Config Mode, 'Y' memory reads and '>' prompts.  Latencies and desyncs are injected on
+//  the virtual clock.
+#ifndef UNABIZ_ARDUINO_RADIOCRAFTS_SIM_H
+#define UNABIZ_ARDUINO_RADIOCRAFTS_SIM_H
+
+#include "SoftwareSerial.h"
+#include "SIGFOX.h"
+#include "UplinkSink.h"
+
+//  Addresses in the module's memory map.
+const uint8_t RC_RF_FREQUENCY_DOMAIN = 0x00;  //  Zone - 1: 0 for RCZ1, 1 for RCZ2, 3 for RCZ4.
+const uint8_t RC_RF_POWER = 0x01;  //  Power step-down.
+const uint8_t RC_PUBLIC_KEY = 0x28;  //  1 to send with the public key, for the emulator.
+const uint8_t RC_UART_BAUD = 0x30;  //  Baud rate code, 5 for 19200 bps.
+const uint8_t RC_NETWORK_MODE = 0x3b;  //  0 for uplink only.
+
+struct RadiocraftsSimConfig {
+  unsigned long commandLatency;  //  ms from the end of a command to its response or prompt.
+  unsigned long uplinkTime;  //  ms to send a message on air.  Input is ignored meanwhile.
+  unsigned long jitter;  //  Max random ms added to each latency.
+  uint8_t dropPercent;  //  Bytes from the driver that the module never sees, like a UART glitch.
+  //  Mode switches followed by a stray '>', like a prompt that arrived late.  Makes the
+  //  driver see a prompt it didn't expect, e.g. in answer to 'X'.
+  uint8_t strayPromptPercent;
+  unsigned long seed;  //  Seed for the injected desyncs and jitter, so runs are repeatable.
+};
+
+//  Module answers in 2 ms and transmits for 6 seconds, no injected desyncs.
+const RadiocraftsSimConfig DEFAULT_RADIOCRAFTS_SIM = { 2, 6000, 0, 0, 0, 1 };
+
+struct RadiocraftsSimStats {
+  unsigned long bytes;  //  Bytes received from the driver.
+  unsigned long commandModes;  //  Entered Command Mode from Send Mode.
+  unsigned long configModes;  //  Entered Config Mode from Command Mode.
+  unsigned long sendModes;  //  Returned to Send Mode with 'X'.
+  unsigned long commands;  //  Other Command Mode commands, like 'Y' and '9'.
+  unsigned long writes;  //  Memory written in Config Mode.
+  unsigned long uplinks;  //  Messages sent on air.
+  unsigned long airTime;  //  ms spent transmitting.
+  unsigned long dropped;  //  Injected: bytes dropped.
+  unsigned long strayPrompts;  //  Injected: stray '>' sent.
+  unsigned long busy;  //  Bytes ignored while transmitting.
+  unsigned long wrongBaud;  //  Bytes ignored because the driver used a different baud rate.
+  unsigned long ignored;  //  Bytes not understood in the current mode.
+};
+
+class RadiocraftsSim: public HostModule {
+public:
+  RadiocraftsSim(const RadiocraftsSimConfig &config = DEFAULT_RADIOCRAFTS_SIM);
+  void receive(uint8_t c);
+  void getStats(RadiocraftsSimStats &stats);
+  void clearStats();
+  Mode getMode();  //  Mode the module is really in, to compare with the driver.
+  void setMode(Mode mode);  //  Force the module into a mode, to test the driver's resync.
+  long getBaud();  //  Baud rate set by memory address RC_UART_BAUD, or 0 if unknown.
+  void setSink(UplinkSink *sink);  //  Pass uplinks to the sink.  The module is uplink only.
+
+  //  Values returned by the module.
+  uint32_t id;  //  '9', sent LSB first.
+  uint8_t pac[8];  //  '9', after the ID.
+  int temperature;  //  'U', in degrees C.  Sent as temperature + 128.
+  int voltage;  //  'V', in mV.  Sent in steps of 30 mV.
+  uint8_t memory[256];  //  Read with 'Y', written in Config Mode.
+
+private:
+  void handle(uint8_t c);
+  void send(uint8_t c, unsigned long latency);
+  void prompt();  //  Send '>' after the command latency, maybe followed by a stray one.
+  unsigned long latency(unsigned long base);
+  bool chance(uint8_t percent);
+  unsigned long nextRandom();
+
+  RadiocraftsSimConfig config;
+  RadiocraftsSimStats stats;
+  Mode mode;
+  uint8_t pending;  //  Command waiting for its argument: 'Y', or 'M' for a Config Mode address.
+  uint8_t address;  //  Config Mode address waiting for its value.
+  uint8_t length;  //  Bytes of the message still to come in Send Mode, 0 if none.
+  uint8_t message[MAX_BYTES_PER_MESSAGE];  //  Message being received in Send Mode.
+  uint8_t received;  //  Bytes of the message received so far.
+  UplinkSink *sink;  //  Receiver of the uplinks, or 0.
+  unsigned long busyUntil;  //  millis() when the current transmission ends.
+  unsigned long randomState;  //  State of nextRandom().
+};
+
+#endif // UNABIZ_ARDUINO_RADIOCRAFTS_SIM_H
@@ -0,0 +1,20 @@
+//  Receiver of the uplinks sent on air by a simulated module, e.g. a simulated network.
+#ifndef UNABIZ_ARDUINO_UPLINK_SINK_H
+#define UNABIZ_ARDUINO_UPLINK_SINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+const uint8_t DOWNLINK_SIZE = 8;  //  Bytes in a downlink.
+
+class UplinkSink {
+public:
+  virtual ~UplinkSink() {}
+  //  Called when the module sends the payload, which is on air until time (millis()).
+  //  If downlinkRequested, return true and fill in downlink to answer in time, or false
+  //  if the device gets no downlink.
+  virtual bool uplink(const char *device, const uint8_t *payload, uint8_t length,
+                      bool downlinkRequested, uint8_t downlink[DOWNLINK_SIZE], unsigned long time) = 0;
+};
+
+#endif // UNABIZ_ARDUINO_UPLINK_SINK_H
@@ -0,0 +1,190 @@
+//  Simulator of the Wisol WSSFM10R module for the host build.
+
+#include "WisolSim.h"
+
+static const unsigned long HOUR = 60UL * 60 * 1000;
+
+WisolSim::WisolSim(const WisolSimConfig &config0, uint8_t txPin0) {
+  config = config0;
+  if (config.maxUplinksPerHour > WISOL_SIM_MAX_HOURLY) config.maxUplinksPerHour = WISOL_SIM_MAX_HOURLY;
+  sink = 0;
+  txPin = txPin0;
+  sleeping = false;
+  length = 0;
+  randomState = config.seed ? config.seed : 1;
+  hourlyNext = 0;
+  hourlyCount = 0;
+  for (uint8_t i = 0; i < WISOL_SIM_MAX_HOURLY; i++) hourly[i] = 0;
+  strcpy(id, "002C30EB");
+  strcpy(pac, "A8664B5523B5405D");
+  temperature = 250;
+  voltage = 3300;
+  channelX = 1;
+  channelY = 3;
+  for (uint8_t i = 0; i < sizeof(downlink); i++) downlink[i] = 0x11 * i;
+  outputPower = 14;
+  emulator = false;
+  clearStats();
+}
+
+void WisolSim::receive(uint8_t c) {
+  //  Commands end with '\r'.  Asleep, the module ignores everything until woken by a break.
+  if (sleeping) { stats.ignored++; return; }
+  if (c == '\n') return;
+  if (c != '\r') {
+    if (length < sizeof(line) - 1) line[length++] = c;
+    return;
+  }
+  line[length] = 0;
+  length = 0;
+  handle(line);
+}
+
+void WisolSim::pinWrite(uint8_t pin, uint8_t value) {
+  //  Holding the transmit line low is a UART break, which wakes the module.
+  if (pin == txPin && value == LOW && sleeping) {
+    sleeping = false;
+    length = 0;
+  }
+}
+
+void WisolSim::handle(char *command) {
+  stats.commands++;
+  if (chance(config.noResponsePercent)) { stats.noResponses++; return; }
+  if (chance(config.errorPercent)) { stats.errors++; send("ERROR\r", config.commandLatency); return; }
+  char response[48];
+  if (strncmp(command, "AT$SF=", 6) == 0) {
+    //  Payload of up to 12 bytes in hex, then ",1" to request a downlink.
+    char *payload = command + 6;
+    char *option = strchr(payload, ',');
+    const bool downlinkRequested = option && strcmp(option, ",1") == 0;
+    if (option && !downlinkRequested && strcmp(option, ",0") != 0) { send("ERROR\r", config.commandLatency); return; }
+    if (option) *option = 0;
+    uplink(payload, downlinkRequested);
+    return;
+  }
+  if (strcmp(command, "AT") == 0 || strcmp(command, "AT$RC") == 0 || strcmp(command, "AT$P=0") == 0) {
+    send("OK\r", config.commandLatency);
+  } else if (strcmp(command, "AT$P=1") == 0 || strcmp(command, "AT$P=2") == 0) {
+    send("OK\r", config.commandLatency);
+    sleeping = true;
+  } else if (strcmp(command, "AT$GI?") == 0) {
+    snprintf(response, sizeof(response), "%d,%d\r", channelX, channelY);
+    send(response, config.commandLatency);
+  } else if (strcmp(command, "AT$I=10") == 0) {
+    snprintf(response, sizeof(response), "%s\r", id);
+    send(response, config.commandLatency);
+  } else if (strcmp(command, "AT$I=11") == 0) {
+    snprintf(response, sizeof(response), "%s\r", pac);
+    send(response, config.commandLatency);
+  } else if (strcmp(command, "AT$T?") == 0) {
+    snprintf(response, sizeof(response), "%d\r", temperature);
+    send(response, config.commandLatency);
+  } else if (strcmp(command, "AT$V?") == 0) {
+    snprintf(response, sizeof(response), "%d\r", voltage);
+    send(response, config.commandLatency);
+  } else if (strncmp(command, "ATS302=", 7) == 0) {
+    outputPower = atoi(command + 7);
+    send("OK\r", config.commandLatency);
+  } else if (strncmp(command, "ATS410=", 7) == 0) {
+    emulator = command[7] == '1';
+    send("OK\r", config.commandLatency);
+  } else {
+    stats.unknownCommands++;
+    send("ERROR\r", config.commandLatency);
+  }
+}
+
+bool WisolSim::uplink(const char *payload, bool downlinkRequested) {
+  //  Send the payload on air and return "OK", then the downlink if requested.
+  const size_t size = strlen(payload);
+  if (size > 24 || size % 2 != 0 || strspn(payload, "0123456789abcdefABCDEF") != size) {
+    send("ERROR\r", config.commandLatency);
+    return false;
+  }
+  //  Duty cycle: the oldest of the last maxUplinksPerHour uplinks must be an hour ago.
+  const unsigned long now = millis();
+  if (config.maxUplinksPerHour > 0 && hourlyCount >= config.maxUplinksPerHour) {
+    const unsigned long oldest = hourly[hourlyNext];
+    if (now - oldest < HOUR) {
+      stats.refused++;
+      send("ERROR\r", config.commandLatency);
+      return false;
+    }
+  }
+  if (config.maxUplinksPerHour > 0) {
+    hourly[hourlyNext] = now;
+    hourlyNext = (hourlyNext + 1) % config.maxUplinksPerHour;
+    if (hourlyCount < config.maxUplinksPerHour) hourlyCount++;
+  }
+  stats.uplinks++;
+  const unsigned long uplinkTime = latency(config.uplinkTime);
+  stats.airTime += uplinkTime;
+  send("OK\r", uplinkTime);
+  //  The network has the uplink once it is on air, and answers the downlink request.
+  uint8_t answer[DOWNLINK_SIZE];
+  memcpy(answer, downlink, sizeof(answer));
+  bool answered = true;
+  if (sink) {
+    uint8_t bytes[12];
+    char digits[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < size / 2; i++) {
+      digits[0] = payload[2 * i];
+      digits[1] = payload[2 * i + 1];
+      bytes[i] = strtoul(digits, 0, 16);
+    }
+    answered = sink->uplink(id, bytes, size / 2, downlinkRequested, answer, now + uplinkTime);
+  }
+  if (!downlinkRequested) return true;
+  //  Received after the OK as "OK\r\nRX=01 23 45 67 89 AB CD EF\r".
+  const unsigned long downlinkTime = latency(config.downlinkTime);
+  stats.airTime += downlinkTime;
+  if (!answered || chance(config.downlinkLossPercent)) {
+    stats.downlinksLost++;
+    send("\nERR_SFX_ERR_SEND_FRAME_WAIT_TIMEOUT\r", uplinkTime + downlinkTime);
+    return true;
+  }
+  char response[48];
+  int n = snprintf(response, sizeof(response), "\nRX=");
+  for (uint8_t i = 0; i < sizeof(answer); i++)
+    n += snprintf(response + n, sizeof(response) - n, i ? " %02X" : "%02X", answer[i]);
+  snprintf(response + n, sizeof(response) - n, "\r");
+  stats.downlinks++;
+  send(response, uplinkTime + downlinkTime);
+  return true;
+}
+
+void WisolSim::send(const char *response, unsigned long latency) {
+  //  Send the response latency ms from now, corrupting a byte if the dice say so.
+  wait(latency);
+  char buffer[48];
+  strncpy(buffer, response, sizeof(buffer) - 1);
+  buffer[sizeof(buffer) - 1] = 0;
+  if (chance(config.garblePercent)) {
+    stats.garbled++;
+    buffer[nextRandom() % strlen(buffer)] ^= 1 << (nextRandom() % 8);
+  }
+  respond(buffer);
+}
+
+unsigned long WisolSim::latency(unsigned long base) {
+  return config.jitter ? base + nextRandom() % (config.jitter + 1) : base;
+}
+
+bool WisolSim::chance(uint8_t percent) {
+  return percent > 0 && nextRandom() % 100 < percent;
+}
+
+unsigned long WisolSim::nextRandom() {
+  //  Own generator, so that each simulated module is repeatable on its own.
+  randomState = randomState * 1103515245 + 12345;
+  return (randomState >> 16) & 0x7fff;
+}
+
+void WisolSim::setSink(UplinkSink *sink0) { sink = sink0; }
+
+void WisolSim::getStats(WisolSimStats &stats0) { stats0 = stats; }
+
+void WisolSim::clearStats() { memset(&stats, 0, sizeof(stats)); }
+
+bool WisolSim::isSleeping() { return sleeping; }
@@ -0,0 +1,84 @@
+//  Simulator of the Wisol WSSFM10R module for the host build.  Answers the AT commands
+//  used by the Wisol driver through the host SoftwareSerial, with configurable latencies,
+//  injected errors and Sigfox duty cycle enforcement, all on the virtual clock.
+#ifndef UNABIZ_ARDUINO_WISOL_SIM_H
+#define UNABIZ_ARDUINO_WISOL_SIM_H
+
+#include "SoftwareSerial.h"
+#include "UplinkSink.h"
+
+struct WisolSimConfig {
+  unsigned long commandLatency;  //  ms from the end of a command to the response.
+  unsigned long uplinkTime;  //  ms to send an uplink, 3 repetitions, before "OK".
+  unsigned long downlinkTime;  //  ms after "OK" until the downlink arrives.
+  unsigned long jitter;  //  Max random ms added to each latency.
+  uint8_t noResponsePercent;  //  Commands that get no response, like a hung module.
+  uint8_t errorPercent;  //  Commands answered with "ERROR".
+  uint8_t garblePercent;  //  Responses with one byte corrupted, like a UART glitch.
+  uint8_t downlinkLossPercent;  //  Downlinks requested but not received.
+  uint8_t maxUplinksPerHour;  //  Uplinks refused with "ERROR" beyond this in any hour.  0 for no limit.
+  unsigned long seed;  //  Seed for the injected errors and jitter, so runs are repeatable.
+};
+
+//  Typical RCZ1 timings, no injected errors, 6 uplinks per hour for the 1% duty cycle.
+const WisolSimConfig DEFAULT_WISOL_SIM = { 10, 6000, 25000, 0, 0, 0, 0, 0, 6, 1 };
+
+const uint8_t WISOL_SIM_MAX_HOURLY = 32;  //  Most uplinks per hour that can be enforced.
+
+struct WisolSimStats {
+  unsigned long commands;  //  Commands received, including uplinks.
+  unsigned long uplinks;  //  Uplinks sent on air.
+  unsigned long downlinks;  //  Downlinks received.
+  unsigned long refused;  //  Uplinks refused for the duty cycle.
+  unsigned long noResponses;  //  Injected: commands not answered.
+  unsigned long errors;  //  Injected: commands answered with "ERROR".
+  unsigned long garbled;  //  Injected: responses corrupted.
+  unsigned long downlinksLost;  //  Downlinks not received: injected, or not answered by the sink.
+  unsigned long unknownCommands;  //  Commands not recognised.
+  unsigned long ignored;  //  Bytes received while asleep.
+  unsigned long airTime;  //  ms spent transmitting or listening for downlinks.
+};
+
+class WisolSim: public HostModule {
+public:
+  WisolSim(const WisolSimConfig &config = DEFAULT_WISOL_SIM, uint8_t txPin = 4);
+  void receive(uint8_t c);
+  void pinWrite(uint8_t pin, uint8_t value);
+  void getStats(WisolSimStats &stats);
+  void clearStats();
+  bool isSleeping();
+  //  Pass uplinks to the sink, which also supplies the downlinks instead of downlink[].
+  void setSink(UplinkSink *sink);
+
+  //  Values returned by the module.
+  char id[9];  //  AT$I=10
+  char pac[17];  //  AT$I=11
+  int temperature;  //  AT$T?, in 0.1 degrees C.
+  int voltage;  //  AT$V?, in mV.
+  uint8_t channelX, channelY;  //  AT$GI?, "X,Y".  The driver sends AT$RC if X is 0 or Y < 3.
+  uint8_t downlink[DOWNLINK_SIZE];  //  Downlink returned by AT$SF=...,1, if there is no sink.
+  uint8_t outputPower;  //  Set by ATS302.
+  bool emulator;  //  Set by ATS410.
+
+private:
+  void handle(char *command);
+  bool uplink(const char *payload, bool downlinkRequested);
+  void send(const char *response, unsigned long latency);
+  unsigned long latency(unsigned long base);
+  bool chance(uint8_t percent);
+  unsigned long nextRandom();
+
+  WisolSimConfig config;
+  WisolSimStats stats;
+  UplinkSink *sink;  //  Receiver of the uplinks, or 0.
+  uint8_t txPin;  //  Pin held low by the driver to wake the module.
+  bool sleeping;
+  char line[48];  //  Command being received.
+  uint8_t length;
+  unsigned long randomState;  //  State of nextRandom().
+  unsigned long hourly[WISOL_SIM_MAX_HOURLY];  //  millis() of recent uplinks, for the duty cycle.
+  uint8_t hourlyNext;  //  Where the next uplink time goes.
+  uint8_t hourlyCount;  //  Number of uplink times recorded.
+};
+
+#endif // UNABIZ_ARDUINO_WISOL_SIM_H
@@ -0,0 +1,138 @@
+//  Runs the Radiocrafts driver against the simulated module on the virtual clock, and
+//  reports the time taken by each operation, including its mode switches, how often the
+//  driver and the module disagree on the mode, and how often exitCommandMode() resyncs.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run with options as name=value, e.g. 100 rounds with 5% stray prompts:
+//    ./radiocrafts_sim rounds=100 stray=5
+//  Each round reads the temperature and voltage, then sends a message.
+//  Options: rounds, interval (ms between rounds), latency, uplink, jitter (ms),
+//  drop, stray (percent), desyncevery (force the module into Command Mode every n-th round),
+//  seed, capture (file for the traffic with the module, for extras/replay).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "CaptureFile.h"
+#include "RadiocraftsSim.h"
+
+struct Options {
+  unsigned long rounds = 100;
+  unsigned long interval = SEND_DELAY;
+  unsigned long desyncEvery = 0;
+  String capture;
+  RadiocraftsSimConfig sim = DEFAULT_RADIOCRAFTS_SIM;
+};
+
+//  Virtual time taken by one kind of operation.
+struct Operation {
+  const char *name;
+  unsigned long count, failures, total, max;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const String name = String(arg).substring(0, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "rounds") options.rounds = value;
+  else if (name == "interval") options.interval = value;
+  else if (name == "desyncevery") options.desyncEvery = value;
+  else if (name == "latency") options.sim.commandLatency = value;
+  else if (name == "uplink") options.sim.uplinkTime = value;
+  else if (name == "jitter") options.sim.jitter = value;
+  else if (name == "drop") options.sim.dropPercent = value;
+  else if (name == "stray") options.sim.strayPromptPercent = value;
+  else if (name == "seed") options.sim.seed = value;
+  else if (name == "capture") options.capture = equals + 1;
+  else return false;
+  return true;
+}
+
+static unsigned long desynced = 0;  //  Operations that left the module out of Send Mode.
+
+static void record(Operation &op, RadiocraftsSim &module, unsigned long start, bool ok) {
+  const unsigned long elapsed = millis() - start;
+  op.count++;
+  if (!ok) op.failures++;
+  op.total += elapsed;
+  if (elapsed > op.max) op.max = elapsed;
+  if (module.getMode() != SEND_MODE) desynced++;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  RadiocraftsSim module(options.sim);
+  SoftwareSerial::setModule(&module);
+  FILE *capture = 0;
+  if (options.capture.length() > 0) {
+    if (!(capture = fopen(options.capture.c_str(), "w"))) { perror(options.capture.c_str()); return 1; }
+    static FilePrint capturePort(capture);
+    captureStart(capturePort);
+  }
+  static Radiocrafts transceiver(COUNTRY_SG, false, "NOTUSED", false);
+  unsigned long start = millis();
+  const bool begun = transceiver.begin();
+  printf("begin: %s in %lu ms\n", begun ? "OK" : "failed", millis() - start);
+  if (!begun) return 1;
+  transceiver.clearStats();
+  module.clearStats();
+
+  Operation ops[] = {
+    { "getTemperature", 0, 0, 0, 0 },
+    { "getVoltage", 0, 0, 0, 0 },
+    { "sendMessage", 0, 0, 0, 0 },
+  };
+  start = millis();
+  for (unsigned long round = 0; round < options.rounds; round++) {
+    hostAdvanceTo((unsigned long long) (start + round * options.interval) * 1000);
+    if (options.desyncEvery > 0 && round % options.desyncEvery == options.desyncEvery - 1) {
+      module.setMode(COMMAND_MODE);
+    }
+    unsigned long opStart = millis();
+    int temperature = 0;
+    bool ok = transceiver.getTemperature(temperature) && temperature == module.temperature;
+    record(ops[0], module, opStart, ok);
+
+    opStart = millis();
+    float voltage = 0;
+    ok = transceiver.getVoltage(voltage) && (int) (voltage * 1000 + 0.5) == module.voltage / 30 * 30;
+    record(ops[1], module, opStart, ok);
+
+    opStart = millis();
+    char payload[MAX_BYTES_PER_MESSAGE * 2 + 1];
+    snprintf(payload, sizeof(payload), "%08lx", round);
+    RadiocraftsSimStats before;
+    module.getStats(before);
+    ok = transceiver.sendMessage(payload);
+    RadiocraftsSimStats after;
+    module.getStats(after);
+    record(ops[2], module, opStart, ok && after.uplinks > before.uplinks);
+  }
+
+  printf("%-16s %8s %8s %8s %8s\n", "Operation", "count", "failed", "avg ms", "max ms");
+  for (uint8_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+    const Operation &op = ops[i];
+    printf("%-16s %8lu %8lu %8lu %8lu\n", op.name, op.count, op.failures,
+           op.count ? op.total / op.count : 0, op.max);
+  }
+  printf("Module left out of Send Mode after %lu operations\n", desynced);
+  RadiocraftsSimStats sim;
+  module.getStats(sim);
+  printf("Module: bytes %lu, command mode %lu, config mode %lu, send mode %lu, commands %lu, "
+         "writes %lu, uplinks %lu, air time %lu ms\n",
+         sim.bytes, sim.commandModes, sim.configModes, sim.sendModes, sim.commands,
+         sim.writes, sim.uplinks, sim.airTime);
+  printf("Ignored: busy %lu, wrong baud %lu, not understood %lu\n", sim.busy, sim.wrongBaud, sim.ignored);
+  printf("Injected: dropped %lu, stray prompts %lu\n", sim.dropped, sim.strayPrompts);
+  TransceiverStats stats;
+  transceiver.getStats(stats);
+  printStats(Serial, stats);
+  if (capture) { captureStop(); fclose(capture); }
+  return 0;
+}
@@ -0,0 +1,125 @@
+//  Runs the Wisol driver and UplinkQueue against the simulated module on the virtual
+//  clock, and reports the end-to-end uplink latency, throughput and retries.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run with options as name=value, e.g. 1000 messages every 5 minutes with 5% timeouts:
+//    ./wisol_sim messages=1000 interval=300000 noresponse=5
+//  Options: messages, interval (ms), downlinkevery (every n-th message asks for a downlink),
+//  latency, uplink, downlink, jitter (ms), noresponse, error, garble, loss (percent),
+//  hourly (duty cycle limit), seed, capture (file for the traffic with the module, for
+//  extras/replay).
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SIGFOX.h"
+#include "CaptureFile.h"
+#include "WisolSim.h"
+
+struct Options {
+  unsigned long messages = 100;
+  unsigned long interval = SEND_DELAY;
+  unsigned long downlinkEvery = 0;
+  String capture;
+  WisolSimConfig sim = DEFAULT_WISOL_SIM;
+};
+
+static bool parse(Options &options, const char *arg) {
+  const char *equals = strchr(arg, '=');
+  if (!equals) return false;
+  const String name = String(arg).substring(0, equals - arg);
+  const unsigned long value = strtoul(equals + 1, 0, 10);
+  if (name == "messages") options.messages = value;
+  else if (name == "interval") options.interval = value;
+  else if (name == "downlinkevery") options.downlinkEvery = value;
+  else if (name == "latency") options.sim.commandLatency = value;
+  else if (name == "uplink") options.sim.uplinkTime = value;
+  else if (name == "downlink") options.sim.downlinkTime = value;
+  else if (name == "jitter") options.sim.jitter = value;
+  else if (name == "noresponse") options.sim.noResponsePercent = value;
+  else if (name == "error") options.sim.errorPercent = value;
+  else if (name == "garble") options.sim.garblePercent = value;
+  else if (name == "loss") options.sim.downlinkLossPercent = value;
+  else if (name == "hourly") options.sim.maxUplinksPerHour = value;
+  else if (name == "seed") options.sim.seed = value;
+  else if (name == "capture") options.capture = equals + 1;
+  else return false;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(options, argv[i])) { fprintf(stderr, "Unknown option %s\n", argv[i]); return 2; }
+  }
+  WisolSim module(options.sim, WISOL_TX);
+  SoftwareSerial::setModule(&module);
+  FILE *capture = 0;
+  if (options.capture.length() > 0) {
+    if (!(capture = fopen(options.capture.c_str(), "w"))) { perror(options.capture.c_str()); return 1; }
+    static FilePrint capturePort(capture);
+    captureStart(capturePort);
+  }
+  static Wisol transceiver(COUNTRY_FR, false, "NOTUSED", false);
+  if (!transceiver.begin()) { fprintf(stderr, "begin failed\n"); return 1; }
+  transceiver.clearStats();
+  module.clearStats();
+  UplinkQueue queue(transceiver);
+
+  //  Push time of each queued message, by the counter in its payload.
+  unsigned long *pushed = new unsigned long[options.messages];
+  unsigned long delivered = 0, downlinks = 0, latencyTotal = 0, latencyMin = 0, latencyMax = 0;
+  const std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+  const unsigned long start = millis();
+  for (unsigned long msg = 0; msg < options.messages; msg++) {
+    //  Like loop() in a sketch: wake up every interval and queue a reading.
+    hostAdvanceTo((unsigned long long) (start + msg * options.interval) * 1000);
+    const unsigned long cycleEnd = millis() + options.interval;
+    char payload[MAX_BYTES_PER_MESSAGE * 2 + 1];
+    snprintf(payload, sizeof(payload), "%08lx", msg);
+    if (options.downlinkEvery > 0 && msg % options.downlinkEvery == 0) {
+      //  Downlinks bypass the queue, as in the examples.
+      String response;
+      if (transceiver.sendMessageAndGetResponse(payload, response) && response.length() > 0) downlinks++;
+      continue;
+    }
+    pushed[msg] = millis();
+    queue.push(payload);
+    //  Send and retry until the queue is empty or the next reading is due.
+    while (!queue.isEmpty() && millis() < cycleEnd) {
+      if (!queue.isDue()) { hostAdvanceTo((unsigned long long) queue.nextAttemptTime() * 1000); continue; }
+      String head;
+      queue.peek(head);
+      if (!queue.sendNext()) continue;
+      const unsigned long latency = millis() - pushed[strtoul(head.c_str(), 0, 16)];
+      if (delivered == 0 || latency < latencyMin) latencyMin = latency;
+      if (latency > latencyMax) latencyMax = latency;
+      latencyTotal += latency;
+      delivered++;
+    }
+  }
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  const double hours = (millis() - start) / 3600000.0;
+
+  WisolSimStats sim;
+  module.getStats(sim);
+  printf("Simulated %.1f hours in %.3f s\n", hours, wall);
+  printf("Messages %lu, delivered %lu, failed %u, dropped %u, downlinks %lu\n",
+         options.messages, delivered, queue.failed(), queue.dropped(), downlinks);
+  if (delivered > 0) {
+    printf("Latency ms: min %lu, avg %lu, max %lu\n", latencyMin, latencyTotal / delivered, latencyMax);
+  }
+  printf("Throughput: %.2f uplinks per hour\n", hours > 0 ? sim.uplinks / hours : 0);
+  printf("Module: commands %lu, uplinks %lu, downlinks %lu, refused %lu, air time %lu ms\n",
+         sim.commands, sim.uplinks, sim.downlinks, sim.refused, sim.airTime);
+  printf("Injected: no response %lu, error %lu, garbled %lu, downlinks lost %lu\n",
+         sim.noResponses, sim.errors, sim.garbled, sim.downlinksLost);
+  TransceiverStats stats;
+  transceiver.getStats(stats);
+  printStats(Serial, stats);
+  if (capture) { captureStop(); fclose(capture); }
+  delete[] pushed;
+  return 0;
+}
@@ -0,0 +1,94 @@
+//  Heap fragmentation stress test.  Runs thousands of send cycles through Message and Wisol
+//  against a simulated module, on the emulated AVR heap in extras/host, and reports how
+//  the free memory, largest free block and free list grow or shrink, and the heap calls
+//  per cycle, a proxy for the cycles spent building Strings.
+//
+//  Build with extras/CMakeLists.txt:
+//    cmake -S extras -B build && cmake --build build
+//  Run:
+//    ./stress [cycles] [heap size] [report every]
+//  Exits with 1 if an allocation failed, i.e. the sketch would have locked up or lost data.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "SIGFOX.h"
+#include "HostHeap.h"
+#include "SoftwareSerial.h"
+
+//  Responds to AT commands like the Wisol module, without any delays.
+class FakeWisol: public HostModule {
+public:
+  void receive(uint8_t c) {
+    if (c != '\r') {
+      if (length < sizeof(line) - 1) line[length++] = c;
+      return;
+    }
+    line[length] = 0;
+    length = 0;
+    if (strncmp(line, "AT$SF=", 6) == 0 && strstr(line, ",1")) respond("OK\rRX=01 23 45 67 89 AB CD EF\r");
+    else if (strcmp(line, "AT$I=10") == 0) respond("002C30EB\r");
+    else if (strcmp(line, "AT$I=11") == 0) respond("A8664B5523B5405D\r");
+    else if (strcmp(line, "AT$T?") == 0) respond("263\r");
+    else if (strcmp(line, "AT$V?") == 0) respond("3300\r");
+    else if (strcmp(line, "AT$GI?") == 0) respond("1,5\r");
+    else respond("OK\r");
+  }
+
+private:
+  char line[64];
+  size_t length = 0;
+};
+
+static void report(unsigned long cycle) {
+  static unsigned long lastCycle = 0, lastCalls = 0;
+  HostHeapStats heap;
+  hostHeapStats(heap);
+  MemoryStats low;
+  getMemoryLowest(MEMORY_SEND_BUFFER, low);
+  const unsigned long calls = cycle > lastCycle ? (heap.calls - lastCalls) / (cycle - lastCycle) : 0;
+  printf("%8lu %6zu %6zu %8zu %7zu %6zu %8u %9zu %6lu\n", cycle, heap.used, heap.free, heap.largest,
+         heap.freeBlocks, heap.top, low.largestBlock, heap.failures, calls);
+  lastCycle = cycle;
+  lastCalls = heap.calls;
+}
+
+int main(int argc, char **argv) {
+  const unsigned long cycles = argc > 1 ? strtoul(argv[1], 0, 10) : 10000;
+  const size_t heapSize = argc > 2 ? strtoul(argv[2], 0, 10) : HOST_HEAP_SIZE;
+  const unsigned long every = argc > 3 ? strtoul(argv[3], 0, 10) : cycles / 20 + 1;
+  if (!hostHeapSetSize(heapSize)) { fprintf(stderr, "Heap size too small\n"); return 2; }
+
+  FakeWisol module;
+  SoftwareSerial::setModule(&module);
+  //  Echo off, but the library still builds its log Strings unless SIGFOX_LOG_LEVEL is lowered.
+  static Wisol transceiver(COUNTRY_SG, false, "NOTUSED", false);
+  if (!transceiver.begin()) { fprintf(stderr, "begin failed\n"); return 2; }
+
+  printf("Heap %zu bytes, %lu cycles\n", heapSize, cycles);
+  printf("%8s %6s %6s %8s %7s %6s %8s %9s %6s\n",
+         "cycle", "used", "free", "largest", "blocks", "top", "lowest", "failures", "calls");
+  report(0);
+  for (unsigned long cycle = 1; cycle <= cycles; cycle++) {
+    //  Same pattern as the examples: read the sensors, build a message, send it.
+    float temperature = 0, voltage = 0;
+    transceiver.getTemperature(temperature);
+    transceiver.getVoltage(voltage);
+    Message msg(transceiver);
+    msg.addField("ctr", (int) (cycle % 1000));
+    msg.addField("tmp", temperature);
+    msg.addField("vlt", voltage);
+    if (cycle % 4 == 0) {
+      String response;
+      msg.sendAndGetResponse(response);
+    } else {
+      msg.send();
+    }
+    String decoded = Message::decodeMessage(msg.getEncodedMessage());
+    //  Wait long enough that isReady() doesn't refuse or warn.
+    hostAdvance(SEND_DELAY + 1);
+    if (cycle % every == 0) report(cycle);
+  }
+  HostHeapStats heap;
+  hostHeapStats(heap);
+  return heap.failures ? 1 : 0;
+}
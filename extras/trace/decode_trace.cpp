@@ -0,0 +1,127 @@
+//  Decode a SIGFOX trace dump into a timeline.  Capture the output of traceDump() from
+//  the Serial Monitor into a file, then run:
+//    g++ -o decode_trace decode_trace.cpp
+//    ./decode_trace < capture.txt
+//  Other lines in the capture are ignored, so the whole Serial log can be passed in.
+//  Keep the tables below in sync with Trace.h.
+
+#include <cctype>
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static const unsigned TRACE_VERSION = 1;
+static const unsigned TRACE_RADIOCRAFTS = 0x80;
+
+static const char *eventName(unsigned event) {
+  switch (event & ~TRACE_RADIOCRAFTS) {
+    case 1: return "sendBuffer";
+    case 2: return "sendMessage";
+    case 3: return "sleep";
+    case 4: return "wake";
+    case 5: return "sendMode";
+    case 6: return "commandMode";
+    case 7: return "configMode";
+    case 8: return "begin";
+    default: return "unknown";
+  }
+}
+
+static const char *wisolCommandName(unsigned command) {
+  static const char *names[] = {
+    "other", "AT$SF=", "ATS302=", "AT$GI?", "AT$RC", "AT$I=10", "AT$I=11",
+    "AT$T?", "AT$V?", "AT$P=0", "AT$P=1", "ATS410=", "AT",
+  };
+  if (command < sizeof(names) / sizeof(names[0])) return names[command];
+  return "unknown";
+}
+
+static bool isSendResult(unsigned event) {
+  //  These events record a SendError, the rest record 1 for OK.
+  event &= ~TRACE_RADIOCRAFTS;
+  return event == 1 || event == 2;
+}
+
+static const char *resultName(unsigned event, unsigned result) {
+  if (!isSendResult(event)) return result ? "OK" : "FAILED";
+  switch (result) {
+    case 0: return "OK";
+    case 1: return "NOT_READY";
+    case 2: return "NO_RESPONSE";
+    case 3: return "UNKNOWN_RESPONSE";
+    case 4: return "MODULE_ERROR";
+    default: return "unknown";
+  }
+}
+
+static unsigned long readHex(const char *&s, int bytes) {
+  //  Read little-endian hex, 2 digits per byte.  Advances s.
+  unsigned long value = 0;
+  for (int i = 0; i < bytes; i++) {
+    char digits[3] = { s[0], s[1], 0 };
+    value |= strtoul(digits, 0, 16) << (i * 8);
+    s += 2;
+  }
+  return value;
+}
+
+static bool isHexLine(const char *s, size_t length) {
+  if (strlen(s) < length) return false;
+  for (size_t i = 0; i < length; i++)
+    if (!isxdigit((unsigned char) s[i])) return false;
+  return true;
+}
+
+int main() {
+  char line[256];
+  bool inDump = false;
+  uint32_t now = 0, previous = 0;
+  int dumps = 0, index = 0;
+  while (fgets(line, sizeof(line), stdin)) {
+    //  Serial Monitor may prefix a timestamp, so search for the marker anywhere in the line.
+    const char *header = strstr(line, "SIGFOX_TRACE ");
+    if (header) {
+      unsigned version = 0, count = 0;
+      if (sscanf(header, "SIGFOX_TRACE %2x %2x", &version, &count) != 2) continue;
+      const char *s = header + strlen("SIGFOX_TRACE ") + 6;
+      if (!isHexLine(s, 8)) continue;
+      now = readHex(s, 4);
+      if (version != TRACE_VERSION) {
+        fprintf(stderr, "Unsupported trace version %u\n", version);
+        continue;
+      }
+      if (dumps++) printf("\n");
+      printf("Trace %d: %u records, dumped at %lu ms\n", dumps, count, (unsigned long) now);
+      printf("%10s %8s %9s  %-12s %-20s %5s %7s  %s\n",
+             "time", "delta", "age", "module", "event", "bytes", "markers", "result");
+      inDump = true; index = 0; previous = 0;
+      continue;
+    }
+    if (!inDump) continue;
+    if (strstr(line, "SIGFOX_TRACE_END")) { inDump = false; continue; }
+    const char *s = line;
+    while (*s == ' ') s++;
+    if (!isHexLine(s, 18)) continue;
+    const uint32_t time = readHex(s, 4);
+    const unsigned event = readHex(s, 1), command = readHex(s, 1), bytes = readHex(s, 1),
+      markers = readHex(s, 1), result = readHex(s, 1);
+    const bool radiocrafts = (event & TRACE_RADIOCRAFTS) != 0;
+    std::string name = eventName(event);
+    char commandName[16];
+    if (radiocrafts) snprintf(commandName, sizeof(commandName), "0x%02X", command);
+    else snprintf(commandName, sizeof(commandName), "%s", wisolCommandName(command));
+    if (event != (TRACE_RADIOCRAFTS | 8) && event != 8) name = name + " " + commandName;
+    //  Times are 32-bit unsigned like millis(), so the differences are correct even if it wrapped around.
+    printf("%10lu %8lu %9lu  %-12s %-20s %5u %7u  %s\n",
+           (unsigned long) time, (unsigned long) (index ? (uint32_t) (time - previous) : 0),
+           (unsigned long) (uint32_t) (now - time),
+           radiocrafts ? "Radiocrafts" : "Wisol", name.c_str(), bytes, markers,
+           resultName(event, result));
+    previous = time;
+    index++;
+  }
+  if (dumps == 0) fprintf(stderr, "No SIGFOX_TRACE dump found\n");
+  return dumps ? 0 : 1;
+}